@@ -0,0 +1,345 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef BENCH_CORPUS_HPP_
+#define BENCH_CORPUS_HPP_
+
+/**
+ * @file corpus.hpp
+ * @brief Synthetic benchmark corpus.
+ *
+ * Every TYPE_* constant gets a buffer that starts the way a real file of that
+ * format does (container headers, box sizes, first ZIP entry, ...) followed
+ * by pseudo-random payload. Near-miss buffers share most of a signature with
+ * a real format but must not match, and random buffers model unknown content.
+ * Everything is generated from a fixed seed, so runs are comparable.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+
+namespace filetype {
+namespace bench {
+
+/// Size of every generated buffer, unless the header alone is longer.
+constexpr size_t kSampleSize = 512;
+
+/// One corpus entry: the format a buffer was built to look like.
+struct Sample {
+  const Type* type;  ///< Format the header imitates.
+  std::vector<uint8_t> bytes;
+};
+
+/// Little helper to lay out binary headers.
+class Writer {
+ public:
+  Writer& bytes(std::initializer_list<uint8_t> values) {
+    out_.insert(out_.end(), values.begin(), values.end());
+    return *this;
+  }
+
+  Writer& str(std::string_view text) {
+    out_.insert(out_.end(), text.begin(), text.end());
+    return *this;
+  }
+
+  Writer& zeros(size_t count) {
+    out_.insert(out_.end(), count, 0);
+    return *this;
+  }
+
+  Writer& le16(uint16_t v) { return bytes({uint8_t(v), uint8_t(v >> 8)}); }
+
+  Writer& le32(uint32_t v) {
+    return bytes({uint8_t(v), uint8_t(v >> 8), uint8_t(v >> 16),
+                  uint8_t(v >> 24)});
+  }
+
+  Writer& be32(uint32_t v) {
+    return bytes({uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8),
+                  uint8_t(v)});
+  }
+
+  /// ZIP local file header for a stored entry, followed by its data.
+  Writer& zip_entry(std::string_view name, std::string_view data) {
+    str("PK").bytes({0x03, 0x04}).le16(20).le16(0).le16(0);
+    le16(0).le16(0).le32(0);
+    le32(static_cast<uint32_t>(data.size()));
+    le32(static_cast<uint32_t>(data.size()));
+    le16(static_cast<uint16_t>(name.size())).le16(0);
+    return str(name).str(data);
+  }
+
+  /// ISO BMFF `ftyp` box with a major brand and compatible brands.
+  Writer& ftyp(std::string_view major, std::string_view compatible) {
+    be32(static_cast<uint32_t>(16 + compatible.size()));
+    return str("ftyp").str(major).be32(0x200).str(compatible);
+  }
+
+  /// Pad with pseudo-random payload up to kSampleSize bytes.
+  std::vector<uint8_t> finish(std::mt19937* rng) {
+    while (out_.size() < kSampleSize) {
+      out_.push_back(static_cast<uint8_t>((*rng)()));
+    }
+    return out_;
+  }
+
+ private:
+  std::vector<uint8_t> out_;
+};
+
+/// Buffer per built-in TYPE_* constant.
+inline std::vector<Sample> format_samples() {
+  std::mt19937 rng(0x5eed);
+  std::vector<Sample> samples;
+  auto add = [&](const Type& type, Writer w) {
+    samples.push_back(Sample{&type, w.finish(&rng)});
+  };
+  const uint8_t asf[] = {0x30, 0x26, 0xB2, 0x75, 0x8E, 0x66, 0xCF, 0x11,
+                         0xA6, 0xD9, 0x00, 0xAA, 0x00, 0x62, 0xCE, 0x6C};
+  const uint8_t cfb[] = {0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1};
+  auto asf_header = [&] {
+    Writer w;
+    for (uint8_t b : asf) {
+      w.bytes({b});
+    }
+    return w.le32(0x1000).le32(0).le32(6).bytes({0x01, 0x02});
+  };
+  // Compound file with the FAT in sector 0 and a one-sector directory
+  // holding the root and one stream.
+  auto compound_file = [&](std::string_view stream) {
+    Writer w;
+    for (uint8_t b : cfb) {
+      w.bytes({b});
+    }
+    w.zeros(16).le16(0x3E).le16(3).le16(0xFFFE).le16(9).le16(6).zeros(10);
+    w.le32(1).le32(1).le32(0).le32(4096).le32(0xFFFFFFFE).le32(0);
+    w.le32(0xFFFFFFFE).le32(0).le32(0);
+    for (int i = 1; i < 109; ++i) {
+      w.le32(0xFFFFFFFF);
+    }
+    w.le32(0xFFFFFFFD).le32(0xFFFFFFFE);
+    for (int i = 2; i < 128; ++i) {
+      w.le32(0xFFFFFFFF);
+    }
+    auto entry = [&](std::string_view name, uint8_t type, uint32_t child) {
+      for (char c : name) {
+        w.le16(static_cast<uint8_t>(c));
+      }
+      w.zeros(64 - 2 * name.size());
+      w.le16(static_cast<uint16_t>(2 * name.size() + 2)).bytes({type, 1});
+      w.le32(0xFFFFFFFF).le32(0xFFFFFFFF).le32(child).zeros(48);
+    };
+    entry("Root Entry", 5, 1);
+    entry(stream, 2, 0xFFFFFFFF);
+    return w.zeros(256);
+  };
+  auto ebml_header = [&](std::string_view doc_type) {
+    Writer w;
+    w.bytes({0x1A, 0x45, 0xDF, 0xA3, 0x9F, 0x42, 0x86, 0x81, 0x01});
+    w.bytes({0x42, 0xF7, 0x81, 0x01, 0x42, 0xF2, 0x81, 0x04});
+    w.bytes({0x42, 0x82, static_cast<uint8_t>(0x80 | doc_type.size())});
+    return w.str(doc_type).bytes({0x42, 0x87, 0x81, 0x04});
+  };
+
+  // Images
+  add(image::TYPE_PNG, Writer()
+                           .bytes({0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A})
+                           .be32(13)
+                           .str("IHDR")
+                           .be32(640)
+                           .be32(480)
+                           .bytes({8, 6, 0, 0, 0}));
+  add(image::TYPE_JPEG, Writer()
+                            .bytes({0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10})
+                            .str("JFIF")
+                            .bytes({0, 1, 1, 0, 0, 1, 0, 1, 0, 0}));
+  add(image::TYPE_GIF,
+      Writer().str("GIF89a").le16(640).le16(480).bytes({0xF7, 0, 0}));
+  add(image::TYPE_WEBP,
+      Writer().str("RIFF").le32(0x2A10).str("WEBPVP8 ").le32(0x2A04));
+  add(image::TYPE_CR2,
+      Writer().str("II").bytes({0x2A, 0}).le32(16).str("CR").bytes({2, 0}));
+  add(image::TYPE_TIFF, Writer().str("II").bytes({0x2A, 0}).le32(8).le16(14));
+  add(image::TYPE_BMP,
+      Writer().str("BM").le32(921654).le32(0).le32(54).le32(40));
+  add(image::TYPE_JXR, Writer().str("II").bytes({0xBC, 0x01}).le32(32));
+  add(image::TYPE_PSD,
+      Writer().str("8BPS").bytes({0, 1}).zeros(6).bytes({0, 3}));
+  add(image::TYPE_ICO,
+      Writer().bytes({0, 0, 1, 0}).le16(1).bytes({16, 16, 0, 0}));
+  add(image::TYPE_HEIC, Writer().ftyp("heic", "mif1heic"));
+  add(image::TYPE_AVIF, Writer().ftyp("avif", "avifmif1miafMA1B"));
+  add(image::TYPE_CR3, Writer().ftyp("crx ", "crx isom"));
+
+  // Documents
+  add(document::TYPE_PDF, Writer().str("%PDF-1.7\n%\xE2\xE3\xCF\xD3\n"));
+  add(document::TYPE_DOC, compound_file("WordDocument"));
+  add(document::TYPE_DOCX, Writer()
+                               .zip_entry("[Content_Types].xml", "<?xml?>")
+                               .zip_entry("word/document.xml", "<w/>"));
+  add(document::TYPE_XLS, compound_file("Workbook"));
+  add(document::TYPE_XLSX, Writer()
+                               .zip_entry("[Content_Types].xml", "<?xml?>")
+                               .zip_entry("xl/workbook.xml", "<x/>"));
+  add(document::TYPE_PPT, compound_file("PowerPoint Document"));
+  add(document::TYPE_PPTX, Writer()
+                               .zip_entry("[Content_Types].xml", "<?xml?>")
+                               .zip_entry("ppt/presentation.xml", "<p/>"));
+  add(document::TYPE_ODT,
+      Writer().zip_entry("mimetype",
+                         "application/vnd.oasis.opendocument.text"));
+  add(document::TYPE_ODS,
+      Writer().zip_entry("mimetype",
+                         "application/vnd.oasis.opendocument.spreadsheet"));
+  add(document::TYPE_ODP,
+      Writer().zip_entry("mimetype",
+                         "application/vnd.oasis.opendocument.presentation"));
+  add(document::TYPE_RTF, Writer().str("{\\rtf1\\ansi\\deff0"));
+  add(document::TYPE_EPUB,
+      Writer().zip_entry("mimetype", "application/epub+zip"));
+  add(document::TYPE_MSG, compound_file("__substg1.0_0037001F"));
+
+  // Archives
+  add(archive::TYPE_ZIP, Writer().zip_entry("readme.txt", "hello"));
+  add(archive::TYPE_JAR,
+      Writer()
+          .zip_entry("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n")
+          .zip_entry("Main.class", "\xCA\xFE\xBA\xBE"));
+  add(archive::TYPE_APK, Writer()
+                             .zip_entry("AndroidManifest.xml", "\x03\x00")
+                             .zip_entry("classes.dex", "dex\n035"));
+  add(archive::TYPE_RAR, Writer().str("Rar!").bytes({0x1A, 0x07, 0x00, 0xCF}));
+  add(archive::TYPE_TAR, Writer()
+                             .str("notes.txt")
+                             .zeros(91)
+                             .str("0000644")
+                             .zeros(150)
+                             .str("ustar")
+                             .bytes({0})
+                             .str("00"));
+  add(archive::TYPE_7Z,
+      Writer().bytes({'7', 'z', 0xBC, 0xAF, 0x27, 0x1C, 0x00, 0x04}));
+  add(archive::TYPE_GZ,
+      Writer().bytes({0x1F, 0x8B, 0x08, 0x00}).le32(0).bytes({0x00, 0x03}));
+  add(archive::TYPE_GZIP,
+      Writer().bytes({0x1F, 0x8B, 0x08, 0x08}).le32(0).bytes({0x00, 0x03}));
+  add(archive::TYPE_BZ2, Writer().str("BZh91AY&SY"));
+  add(archive::TYPE_BZIP2, Writer().str("BZh51AY&SY"));
+  add(archive::TYPE_XZ,
+      Writer().bytes({0xFD, '7', 'z', 'X', 'Z', 0x00, 0x00, 0x04}));
+  add(archive::TYPE_Z, Writer().bytes({0x1F, 0x9D, 0x90}));
+  add(archive::TYPE_LZ, Writer().str("LZIP").bytes({0x01, 0x0C}));
+
+  // Audio
+  add(audio::TYPE_MP3, Writer().str("ID3").bytes({4, 0, 0, 0, 0, 0x1F, 0x76}));
+  add(audio::TYPE_WAV,
+      Writer().str("RIFF").le32(0x58224).str("WAVEfmt ").le32(16));
+  add(audio::TYPE_MIDI, Writer().str("MThd").be32(6).bytes({0, 1, 0, 2}));
+  add(audio::TYPE_FLAC, Writer().str("fLaC").bytes({0x00, 0x00, 0x00, 0x22}));
+  add(audio::TYPE_AAC, Writer().bytes({0xFF, 0xF1, 0x50, 0x80, 0x2E, 0x7F}));
+  add(audio::TYPE_OGG, Writer().str("OggS").bytes({0, 2}).zeros(8));
+  add(audio::TYPE_WMA, asf_header());
+  add(audio::TYPE_AIFF, Writer().str("FORM").be32(0x1F2C).str("AIFFCOMM"));
+  add(audio::TYPE_M4A, Writer().ftyp("M4A ", "M4A mp42isom"));
+
+  // Video
+  add(video::TYPE_MP4, Writer().ftyp("isom", "isomiso2avc1mp41"));
+  add(video::TYPE_AVI, Writer().str("RIFF").le32(0x7E000).str("AVI LIST"));
+  add(video::TYPE_MKV, ebml_header("matroska"));
+  add(video::TYPE_WEBM, ebml_header("webm"));
+  add(video::TYPE_MOV, Writer().ftyp("qt  ", "qt  "));
+  add(video::TYPE_FLV,
+      Writer().str("FLV").bytes({0x01, 0x05}).be32(9).be32(0));
+  add(video::TYPE_WMV, asf_header());
+  add(video::TYPE_MPEG, Writer().bytes({0x00, 0x00, 0x01, 0xBA, 0x44, 0x00}));
+  add(video::TYPE_3GP, Writer().ftyp("3gp4", "isom3gp4"));
+
+  return samples;
+}
+
+/**
+ * @brief Buffers that share a first byte or most of a signature with a real
+ * format but match nothing.
+ *
+ * These walk deep into the candidate lists, which is the worst case for the
+ * lookup.
+ */
+inline std::vector<std::vector<uint8_t>> near_miss_samples() {
+  std::mt19937 rng(0xbad);
+  std::vector<std::vector<uint8_t>> out;
+  for (const Sample& sample : format_samples()) {
+    std::vector<uint8_t> bytes = sample.bytes;
+    // Break the last magic byte the fixed-offset signatures look at.
+    bytes[sample.type == &archive::TYPE_TAR ? 261 : 1] ^= 0x20;
+    out.push_back(bytes);
+  }
+  out.push_back(Writer().str("RIFF").le32(64).str("XXXX").finish(&rng));
+  out.push_back(Writer().be32(24).str("ftyqisom").finish(&rng));
+  out.push_back(Writer().bytes({0xFF, 0xD8, 0x00}).finish(&rng));
+  out.push_back(Writer().bytes({0x00, 0x00, 0x01, 0x01}).finish(&rng));
+  return out;
+}
+
+/// Uniformly random buffers, standing in for unrecognised content.
+inline std::vector<std::vector<uint8_t>> random_samples(size_t count) {
+  std::mt19937 rng(0xf00d);
+  std::vector<std::vector<uint8_t>> out;
+  out.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    out.push_back(Writer().finish(&rng));
+  }
+  return out;
+}
+
+/**
+ * @brief Blob of @p size bytes of random data with every format sample
+ * embedded at spread-out offsets, as found in disk images.
+ */
+inline std::vector<uint8_t> embedded_blob(size_t size) {
+  std::mt19937 rng(0xb10b);
+  std::vector<uint8_t> out(size);
+  for (uint8_t& b : out) {
+    b = static_cast<uint8_t>(rng());
+  }
+  const std::vector<Sample> samples = format_samples();
+  const size_t stride = size / (samples.size() + 1);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const std::vector<uint8_t>& bytes = samples[i].bytes;
+    if (stride * (i + 1) + bytes.size() <= size) {
+      std::copy(bytes.begin(), bytes.end(), out.begin() + stride * (i + 1));
+    }
+  }
+  return out;
+}
+
+/// @p size bytes of prose, mostly ASCII with two- to four-byte UTF-8
+/// characters mixed in when @p ascii_only is false.
+inline std::vector<uint8_t> text_blob(size_t size, bool ascii_only) {
+  static constexpr const char* kWords[] = {
+      "lorem ", "ipsum ", "dolor ", "sit ", "amet,\n", "na\xC3\xAFve ",
+      "\xE2\x82\xAC" "5 ", "caf\xC3\xA9 ", "\xF0\x9F\x98\x80 ", "\t- "};
+  std::mt19937 rng(0x7e47);
+  std::vector<uint8_t> out;
+  out.reserve(size + 16);
+  while (out.size() < size) {
+    const std::string_view word = kWords[rng() % (ascii_only ? 5 : 10)];
+    out.insert(out.end(), word.begin(), word.end());
+  }
+  // Cut on a character boundary.
+  out.resize(size);
+  while (!out.empty() && (out.back() & 0x80) != 0) {
+    out.pop_back();
+  }
+  return out;
+}
+
+}  // namespace bench
+}  // namespace filetype
+
+#endif  // BENCH_CORPUS_HPP_
@@ -0,0 +1,569 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+/**
+ * @file filetype_bench.cpp
+ * @brief Detection throughput benchmarks.
+ *
+ * Run `filetype_bench --benchmark_filter=<regex>` to select a group:
+ *   - BM_Match/<ext>: ns per detection of a header of each format
+ *   - BM_MatchNearMiss, BM_MatchRandom: cost of content that matches nothing
+ *   - BM_Is/<category>, BM_Detect: cost of the category helpers
+ *   - BM_MatchFile/warm, BM_MatchFile/cold: match_file() with the file in the
+ *     page cache and (Linux only) evicted from it before every call
+ *   - BM_MatchFileCached: the same files through a DetectionCache
+ *   - BM_IndexFind: the same files looked up in a DetectionIndex
+ *   - BM_LargeArchive/<path>: a 64 MiB XLSX evicted from the page cache
+ *     (Linux only), detected through pread() or a MappedFile
+ *   - BM_DetectFiles/<engine>: the file corpus evicted from the page cache
+ *     (Linux only), detected one match_file() at a time or by detect_files()
+ *     through io_uring or its thread pool
+ *   - BM_ScanDirectory/<threads>: scan_directory() over a tree of 4096 corpus
+ *     files in the page cache
+ *   - BM_Scan, BM_ScanText: scan() over a MiB with and without embedded files
+ *   - BM_Carve/<threads>: carve() over 64 MiB, against BM_Memchr/<bytes> as
+ *     the memory bandwidth bound
+ *   - BM_DetectText/<charset>/<bytes>: detect_text() over whole buffers
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "corpus.hpp"
+#include "filetype/filetype.hpp"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using filetype::bench::Sample;
+
+const std::vector<Sample>& formats() {
+  static const std::vector<Sample> samples = filetype::bench::format_samples();
+  return samples;
+}
+
+/// Run @p fn over @p buffers round-robin, counting one item per call.
+template <typename Fn>
+void run_over(benchmark::State& state,
+              const std::vector<std::vector<uint8_t>>& buffers, Fn fn) {
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fn(filetype::ByteView(buffers[i])));
+    i = i + 1 == buffers.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+std::vector<std::vector<uint8_t>> format_buffers() {
+  std::vector<std::vector<uint8_t>> buffers;
+  for (const Sample& sample : formats()) {
+    buffers.push_back(sample.bytes);
+  }
+  return buffers;
+}
+
+void BM_Match(benchmark::State& state, const Sample* sample) {
+  const filetype::ByteView bytes(sample->bytes);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filetype::match(bytes));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_MatchNearMiss(benchmark::State& state) {
+  static const auto buffers = filetype::bench::near_miss_samples();
+  run_over(state, buffers,
+           [](filetype::ByteView b) { return filetype::match(b); });
+}
+BENCHMARK(BM_MatchNearMiss);
+
+void BM_MatchRandom(benchmark::State& state) {
+  static const auto buffers = filetype::bench::random_samples(1024);
+  run_over(state, buffers,
+           [](filetype::ByteView b) { return filetype::match(b); });
+}
+BENCHMARK(BM_MatchRandom);
+
+void BM_MatchMixed(benchmark::State& state) {
+  static const auto buffers = format_buffers();
+  run_over(state, buffers,
+           [](filetype::ByteView b) { return filetype::match(b); });
+}
+BENCHMARK(BM_MatchMixed);
+
+void BM_Detect(benchmark::State& state) {
+  static const auto buffers = format_buffers();
+  run_over(state, buffers, [](filetype::ByteView b) {
+    const filetype::DetectionResult result = filetype::detect(b);
+    return result.is_image() || result.is_video();
+  });
+}
+BENCHMARK(BM_Detect);
+
+void BM_Is(benchmark::State& state, bool (*is)(filetype::ByteView)) {
+  static const auto buffers = format_buffers();
+  run_over(state, buffers, is);
+}
+BENCHMARK_CAPTURE(BM_Is, image, &filetype::is_image);
+BENCHMARK_CAPTURE(BM_Is, document, &filetype::is_document);
+BENCHMARK_CAPTURE(BM_Is, archive, &filetype::is_archive);
+BENCHMARK_CAPTURE(BM_Is, audio, &filetype::is_audio);
+BENCHMARK_CAPTURE(BM_Is, video, &filetype::is_video);
+
+std::string temp_dir() {
+  const char* dir = std::getenv("TMPDIR");
+  std::string path = dir != nullptr && *dir != '\0' ? dir : "/tmp";
+  return path.back() == '/' ? path : path + "/";
+}
+
+/// Corpus written to temporary files, removed at exit.
+class FileCorpus {
+ public:
+  FileCorpus() {
+    for (const Sample& sample : formats()) {
+      std::string path = temp_dir() + "filetype_bench_" +
+                         std::to_string(paths_.size()) + "." +
+                         std::string(sample.type->extension);
+      std::FILE* file = std::fopen(path.c_str(), "wb");
+      if (file == nullptr) {
+        continue;
+      }
+      std::fwrite(sample.bytes.data(), 1, sample.bytes.size(), file);
+      std::fclose(file);
+      paths_.push_back(path);
+    }
+  }
+
+  ~FileCorpus() {
+    for (const std::string& path : paths_) {
+      std::remove(path.c_str());
+    }
+  }
+
+  const std::vector<std::string>& paths() const { return paths_; }
+
+ private:
+  std::vector<std::string> paths_;
+};
+
+const FileCorpus& file_corpus() {
+  static const FileCorpus corpus;
+  return corpus;
+}
+
+/// Drop a file's pages from the page cache.
+bool evict(const std::string& path) {
+#if defined(__linux__)
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  ::fdatasync(fd);
+  const bool ok = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+  ::close(fd);
+  return ok;
+#else
+  (void)path;
+  return false;
+#endif
+}
+
+void BM_MatchFile(benchmark::State& state, bool cold) {
+  const std::vector<std::string>& paths = file_corpus().paths();
+  if (paths.empty()) {
+    state.SkipWithError("could not write the file corpus");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    if (cold) {
+      state.PauseTiming();
+      if (!evict(paths[i])) {
+        state.SkipWithError("page cache eviction is not supported");
+        break;
+      }
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(filetype::match_file(paths[i]));
+    i = i + 1 == paths.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_MatchFile, warm, false);
+BENCHMARK_CAPTURE(BM_MatchFile, cold, true)->UseRealTime();
+
+void BM_MatchFileCached(benchmark::State& state) {
+  // Every file is cached after the first pass, so this is the hit cost.
+  const std::vector<std::string>& paths = file_corpus().paths();
+  if (paths.empty()) {
+    state.SkipWithError("could not write the file corpus");
+    return;
+  }
+  static filetype::DetectionCache cache;
+  std::error_code ec;
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.match_file(paths[i], ec));
+    i = i + 1 == paths.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchFileCached)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_IndexFind(benchmark::State& state) {
+  const std::vector<std::string>& paths = file_corpus().paths();
+  const std::string path = temp_dir() + "filetype_bench.idx";
+  std::error_code ec;
+  filetype::IndexWriter writer;
+  for (const std::string& file : paths) {
+    writer.match_file(file, ec);
+  }
+  const auto index = writer.commit(path, ec)
+                         ? filetype::DetectionIndex::open(path, ec)
+                         : nullptr;
+  if (paths.empty() || index == nullptr) {
+    state.SkipWithError("could not write the index");
+    return;
+  }
+  const filetype::Type* type = nullptr;
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index->find(paths[i], &type, ec));
+    i = i + 1 == paths.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_IndexFind);
+
+/// 64 MiB XLSX whose telling entry follows a large first one, removed at
+/// exit.
+class LargeArchive {
+ public:
+  LargeArchive() : path_(temp_dir() + "filetype_bench_large.xlsx") {
+    std::mt19937 rng;
+    const std::vector<uint8_t> zip =
+        filetype::bench::Writer()
+            .zip_entry("[Content_Types].xml", std::string(64 << 20, ' '))
+            .zip_entry("xl/workbook.xml", "<x/>")
+            .finish(&rng);
+    std::FILE* file = std::fopen(path_.c_str(), "wb");
+    if (file == nullptr ||
+        std::fwrite(zip.data(), 1, zip.size(), file) != zip.size()) {
+      path_.clear();
+    }
+    if (file != nullptr) {
+      std::fclose(file);
+    }
+  }
+
+  ~LargeArchive() {
+    if (!path_.empty()) {
+      std::remove(path_.c_str());
+    }
+  }
+
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+};
+
+void BM_LargeArchive(benchmark::State& state, bool mapped) {
+  static const LargeArchive archive;
+  const std::string& path = archive.path();
+  if (path.empty()) {
+    state.SkipWithError("could not write the archive");
+    return;
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    if (!evict(path)) {
+      state.SkipWithError("page cache eviction is not supported");
+      break;
+    }
+    state.ResumeTiming();
+    std::error_code ec;
+    if (mapped) {
+      filetype::MappedFile file;
+      file.open(path, ec);
+      benchmark::DoNotOptimize(filetype::match(file));
+    } else {
+      benchmark::DoNotOptimize(filetype::match_file(path, ec));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_LargeArchive, pread, false)->UseRealTime();
+BENCHMARK_CAPTURE(BM_LargeArchive, mapped, true)->UseRealTime();
+
+/// How BM_DetectFiles reads the corpus.
+enum class FileEngine { SEQUENTIAL, IO_URING, THREADS };
+
+void BM_DetectFiles(benchmark::State& state, FileEngine engine) {
+  const std::vector<std::string>& paths = file_corpus().paths();
+  if (paths.empty()) {
+    state.SkipWithError("could not write the file corpus");
+    return;
+  }
+  filetype::FileBatchOptions options;
+  options.use_io_uring = engine == FileEngine::IO_URING;
+  std::atomic<size_t> found{0};
+  const filetype::FileCallback count_found =
+      [&](size_t, const filetype::DetectionResult& result,
+          const std::error_code&) { found += result ? 1 : 0; };
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (const std::string& path : paths) {
+      if (!evict(path)) {
+        state.SkipWithError("page cache eviction is not supported");
+        return;
+      }
+    }
+    state.ResumeTiming();
+    if (engine == FileEngine::SEQUENTIAL) {
+      for (const std::string& path : paths) {
+        benchmark::DoNotOptimize(filetype::match_file(path));
+      }
+    } else {
+      filetype::detect_files(paths, count_found, options);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * paths.size());
+}
+BENCHMARK_CAPTURE(BM_DetectFiles, sequential, FileEngine::SEQUENTIAL)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_DetectFiles, io_uring, FileEngine::IO_URING)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_DetectFiles, threads, FileEngine::THREADS)
+    ->UseRealTime();
+
+/// 64 directories of 64 corpus files each, removed at exit.
+class DirectoryTree {
+ public:
+  DirectoryTree() : root_(temp_dir() + "filetype_bench_tree") {
+    const std::vector<Sample>& samples = formats();
+    size_t next = 0;
+    for (size_t d = 0; d < 64; ++d) {
+      const std::string dir = root_ + "/" + std::to_string(d);
+      std::filesystem::create_directories(dir);
+      for (size_t f = 0; f < 64; ++f) {
+        const Sample& sample = samples[next++ % samples.size()];
+        const std::string path = dir + "/" + std::to_string(f) + "." +
+                                 std::string(sample.type->extension);
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+          continue;
+        }
+        std::fwrite(sample.bytes.data(), 1, sample.bytes.size(), file);
+        std::fclose(file);
+        ++files_;
+      }
+    }
+  }
+
+  ~DirectoryTree() {
+    std::error_code ec;
+    std::filesystem::remove_all(root_, ec);
+  }
+
+  const std::string& root() const { return root_; }
+  size_t files() const { return files_; }
+
+ private:
+  std::string root_;
+  size_t files_ = 0;
+};
+
+void BM_ScanDirectory(benchmark::State& state) {
+  static const DirectoryTree tree;
+  filetype::DirectoryScanOptions options;
+  options.threads = static_cast<size_t>(state.range(0));
+  std::error_code ec;
+  size_t found = 0;
+  for (auto _ : state) {
+    found += filetype::scan_directory(
+        tree.root(), [](const filetype::DirectoryEntry&) {}, ec, options);
+  }
+  if (ec || found != state.iterations() * tree.files()) {
+    state.SkipWithError("could not scan the tree");
+  }
+  state.SetItemsProcessed(state.iterations() * tree.files());
+}
+BENCHMARK(BM_ScanDirectory)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+void BM_Scan(benchmark::State& state) {
+  // One MiB of random bytes holding one sample of every format.
+  static const auto blob = filetype::bench::embedded_blob(size_t{1} << 20);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filetype::scan(blob));
+  }
+  state.SetBytesProcessed(state.iterations() * blob.size());
+}
+BENCHMARK(BM_Scan);
+
+void BM_ScanText(benchmark::State& state) {
+  // No-hit case: text never starts a key, so only the prefilter runs.
+  static const std::vector<uint8_t> text = [] {
+    std::vector<uint8_t> out(size_t{1} << 20);
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = static_cast<uint8_t>("lorem ipsum dolor sit amet "[i % 27]);
+    }
+    return out;
+  }();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filetype::scan(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ScanText);
+
+void BM_Carve(benchmark::State& state) {
+  // A 64 MiB image: too big for the caches, like a disk image.
+  static const auto image = filetype::bench::embedded_blob(size_t{64} << 20);
+  filetype::CarveOptions options;
+  options.threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    size_t hits = 0;
+    filetype::carve(
+        image, [&](const filetype::ScanHit&) { ++hits; }, options);
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetBytesProcessed(state.iterations() * image.size());
+}
+BENCHMARK(BM_Carve)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+void BM_Memchr(benchmark::State& state) {
+  // Baseline for BM_ScanText (cache-resident) and BM_Carve (memory bound):
+  // memchr() over the same amount of data.
+  const std::vector<uint8_t> zeros(static_cast<size_t>(state.range(0)), 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::memchr(zeros.data(), 1, zeros.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * zeros.size());
+}
+BENCHMARK(BM_Memchr)->Arg(size_t{1} << 20)->Arg(size_t{64} << 20);
+
+void BM_DetectText(benchmark::State& state, bool ascii_only) {
+  const std::vector<uint8_t> text = filetype::bench::text_blob(
+      static_cast<size_t>(state.range(0)), ascii_only);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filetype::detect_text(text, SIZE_MAX));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK_CAPTURE(BM_DetectText, ascii, true)
+    ->Arg(4096)
+    ->Arg(size_t{1} << 20)
+    ->Arg(size_t{64} << 20);
+BENCHMARK_CAPTURE(BM_DetectText, utf8, false)
+    ->Arg(4096)
+    ->Arg(size_t{1} << 20)
+    ->Arg(size_t{64} << 20);
+
+/// Compiled image of @p count custom signatures spread over every first byte.
+std::vector<uint8_t> custom_image(size_t count) {
+  static constexpr const char* kCategories[] = {"image", "document", "archive",
+                                                "audio", "video"};
+  std::string description;
+  char line[128];
+  for (size_t i = 0; i < count; ++i) {
+    std::snprintf(line, sizeof(line),
+                  "application/x-custom-%zu c%zu %s %zu %02zX%02zX%02zX%02zX\n",
+                  i, i, kCategories[i % 5], i % 10 == 9 ? i % 64 : size_t{0},
+                  (i * 37) % 256, i % 256, (i / 256) % 256, 0x5Au + i % 7);
+    description += line;
+  }
+  std::vector<uint8_t> image;
+  filetype::compile_signatures(description, &image);
+  return image;
+}
+
+void BM_OpenDatabase(benchmark::State& state) {
+  const std::vector<uint8_t> image =
+      custom_image(static_cast<size_t>(state.range(0)));
+  const std::string path = temp_dir() + "filetype_bench_signatures.db";
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    state.SkipWithError("could not write the image");
+    return;
+  }
+  std::fwrite(image.data(), 1, image.size(), file);
+  std::fclose(file);
+  std::error_code ec;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filetype::SignatureDatabase::open(path, ec));
+  }
+  std::remove(path.c_str());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OpenDatabase)->Arg(500);
+
+void BM_MatchRegistered(benchmark::State& state) {
+  // Built-in formats with a 500-signature database searched first.
+  if (state.thread_index() == 0) {
+    std::error_code ec;
+    filetype::register_signatures(
+        filetype::SignatureDatabase::load(custom_image(500), ec));
+  }
+  static const auto buffers = format_buffers();
+  run_over(state, buffers,
+           [](filetype::ByteView b) { return filetype::match(b); });
+  if (state.thread_index() == 0) {
+    filetype::clear_signatures();
+  }
+}
+BENCHMARK(BM_MatchRegistered)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_MatchWhileSwapping(benchmark::State& state) {
+  // Readers against a background thread republishing the signature set.
+  static std::atomic<bool> stop{false};
+  static std::thread updater;
+  if (state.thread_index() == 0) {
+    std::error_code ec;
+    const auto a = filetype::SignatureDatabase::load(custom_image(500), ec);
+    const auto b = filetype::SignatureDatabase::load(custom_image(400), ec);
+    stop.store(false);
+    updater = std::thread([a, b] {
+      for (size_t i = 0; !stop.load(); ++i) {
+        filetype::replace_signatures({i % 2 == 0 ? a : b});
+      }
+    });
+  }
+  static const auto buffers = format_buffers();
+  run_over(state, buffers,
+           [](filetype::ByteView b) { return filetype::match(b); });
+  if (state.thread_index() == 0) {
+    stop.store(true);
+    updater.join();
+    filetype::clear_signatures();
+  }
+}
+BENCHMARK(BM_MatchWhileSwapping)->ThreadRange(1, 8)->UseRealTime();
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  for (const Sample& sample : formats()) {
+    const std::string name = "BM_Match/" + std::string(sample.type->extension);
+    benchmark::RegisterBenchmark(name.c_str(), BM_Match, &sample);
+  }
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,83 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_BATCH_HPP_
+#define INCLUDE_FILETYPE_BATCH_HPP_
+
+#include <algorithm>
+#include <cstddef>
+
+#include "filetype/byte_view.hpp"
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+/// Tuning knobs for match_batch() and detect_batch().
+struct BatchOptions {
+  /// Threads taking part in detection, including the caller. 0 selects
+  /// std::thread::hardware_concurrency(); more than that are not used.
+  size_t threads = 0;
+
+  /// Batches with fewer items than this run on the calling thread only.
+  size_t sequential_threshold = 256;
+
+  /// Number of consecutive items handed to a thread at a time.
+  size_t grain = 64;
+
+  /// Categories to probe; see match(ByteView, CategoryMask).
+  CategoryMask categories = ALL_CATEGORIES;
+};
+
+/**
+ * @brief Detect the type of many buffers in parallel.
+ *
+ * Work is spread over an internal work-stealing thread pool shared by all
+ * calls. `results[i]` always receives the type of `inputs[i]`, whatever
+ * thread handled it, and nothing is allocated per item. Batches smaller
+ * than BatchOptions::sequential_threshold, or a thread count of 1, run on
+ * the calling thread.
+ *
+ * @param inputs Buffers to classify.
+ * @param count Number of buffers.
+ * @param results Caller-provided array of @p count entries; receives the
+ * detected type of each buffer, or nullptr.
+ * @param options Thread count, batching and category options.
+ */
+void match_batch(const ByteView* inputs, size_t count, const Type** results,
+                 const BatchOptions& options = BatchOptions());
+
+/**
+ * @brief Detect many buffers in parallel, keeping full detection results.
+ *
+ * Same scheduling as match_batch().
+ *
+ * @param inputs Buffers to classify.
+ * @param count Number of buffers.
+ * @param results Caller-provided array of @p count entries.
+ * @param options Thread count, batching and category options.
+ */
+void detect_batch(const ByteView* inputs, size_t count,
+                  DetectionResult* results,
+                  const BatchOptions& options = BatchOptions());
+
+#if defined(FILETYPE_HAS_SPAN)
+/// @overload
+inline void match_batch(std::span<const ByteView> inputs,
+                        std::span<const Type*> results,
+                        const BatchOptions& options = BatchOptions()) {
+  match_batch(inputs.data(), std::min(inputs.size(), results.size()),
+              results.data(), options);
+}
+
+/// @overload
+inline void detect_batch(std::span<const ByteView> inputs,
+                         std::span<DetectionResult> results,
+                         const BatchOptions& options = BatchOptions()) {
+  detect_batch(inputs.data(), std::min(inputs.size(), results.size()),
+               results.data(), options);
+}
+#endif
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_BATCH_HPP_
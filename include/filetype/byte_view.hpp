@@ -0,0 +1,76 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_BYTE_VIEW_HPP_
+#define INCLUDE_FILETYPE_BYTE_VIEW_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#define FILETYPE_HAS_SPAN 1
+#endif
+
+namespace filetype {
+
+/**
+ * @brief Non-owning view over a contiguous run of bytes.
+ *
+ * Every detection function takes its input as a ByteView, so buffers held in
+ * mmap'd regions, network receive buffers or slices of larger blobs can be
+ * classified in place. A ByteView converts implicitly from
+ * `std::vector<uint8_t>`, `std::string_view` and (under C++20)
+ * `std::span<const uint8_t>`; raw pointer + length is explicit.
+ */
+class ByteView {
+ public:
+  constexpr ByteView() noexcept = default;
+
+  constexpr ByteView(const uint8_t* data, size_t size) noexcept
+      : data_(data), size_(size) {}
+
+  ByteView(const std::vector<uint8_t>& bytes) noexcept  // NOLINT
+      : data_(bytes.data()), size_(bytes.size()) {}
+
+  ByteView(std::string_view bytes) noexcept  // NOLINT
+      : data_(reinterpret_cast<const uint8_t*>(bytes.data())),
+        size_(bytes.size()) {}
+
+#if defined(FILETYPE_HAS_SPAN)
+  template <size_t Extent>
+  constexpr ByteView(std::span<const uint8_t, Extent> bytes) noexcept  // NOLINT
+      : data_(bytes.data()), size_(bytes.size()) {}
+
+  template <size_t Extent>
+  constexpr ByteView(std::span<uint8_t, Extent> bytes) noexcept  // NOLINT
+      : data_(bytes.data()), size_(bytes.size()) {}
+#endif
+
+  constexpr const uint8_t* data() const noexcept { return data_; }
+  constexpr size_t size() const noexcept { return size_; }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+  constexpr uint8_t operator[](size_t i) const noexcept { return data_[i]; }
+
+  /**
+   * @brief View of at most @p count bytes starting at @p offset.
+   *
+   * Out-of-range requests are clamped and yield an empty view.
+   */
+  constexpr ByteView subview(size_t offset, size_t count = SIZE_MAX) const {
+    if (offset >= size_) {
+      return ByteView();
+    }
+    const size_t left = size_ - offset;
+    return ByteView(data_ + offset, count < left ? count : left);
+  }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_BYTE_VIEW_HPP_
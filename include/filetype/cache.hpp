@@ -0,0 +1,86 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_CACHE_HPP_
+#define INCLUDE_FILETYPE_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <system_error>
+
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+/// Counters of a DetectionCache, for sizing it.
+struct CacheStats {
+  uint64_t hits = 0;       ///< Lookups answered from the cache.
+  uint64_t misses = 0;     ///< Lookups that read the file.
+  uint64_t evictions = 0;  ///< Entries dropped to make room.
+  size_t entries = 0;      ///< Entries held now.
+};
+
+/**
+ * @brief Bounded cache of detect_file() results.
+ *
+ * Entries are keyed by what stat() reports for a file: device, inode, size
+ * and modification time. A hit costs one stat() and a hash probe and does
+ * not open the file; a file that was written to, replaced or renamed over
+ * gets a new key and is read again. A result is only stored if fstat() on
+ * the descriptor it was read through gives the same key, so a file replaced
+ * during detection is not cached under its predecessor's key. Writes that
+ * keep the size and land within the file system's timestamp granularity go
+ * unnoticed, as they do for make. Results are also dropped when signatures
+ * are registered or replaced.
+ *
+ * The cache is split into shards, each a least-recently-used list behind
+ * its own mutex, so lookups from many threads seldom contend. Only regular
+ * files are cached. On Windows, which has no inode numbers, every lookup
+ * reads the file.
+ */
+class DetectionCache {
+ public:
+  /**
+   * @param capacity Entries kept at most, spread evenly over the shards;
+   * 0 disables caching.
+   * @param shards Number of independently locked shards, at most
+   * @p capacity.
+   */
+  explicit DetectionCache(size_t capacity = 4096, size_t shards = 16);
+  ~DetectionCache();
+
+  DetectionCache(const DetectionCache&) = delete;
+  DetectionCache& operator=(const DetectionCache&) = delete;
+
+  /**
+   * @brief detect_file() through the cache.
+   *
+   * @param path Path to the file.
+   * @param ec Receives the errno-derived error if the file cannot be
+   * stat()ed, opened or read; cleared otherwise. Failures are not cached.
+   */
+  DetectionResult detect_file(std::string_view path, std::error_code& ec);
+
+  /// match_file() through the cache; see detect_file().
+  const Type* match_file(std::string_view path, std::error_code& ec) {
+    return detect_file(path, ec).type;
+  }
+
+  /// Counters since construction or the last clear().
+  CacheStats stats() const;
+
+  /// Drop every entry and reset the counters.
+  void clear();
+
+ private:
+  struct Shard;
+
+  const size_t shard_count_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_CACHE_HPP_
@@ -0,0 +1,110 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_DIRECTORY_HPP_
+#define INCLUDE_FILETYPE_DIRECTORY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+/// Tuning knobs and filters for scan_directory().
+struct DirectoryScanOptions {
+  /// Threads detecting files while the caller walks the tree. 0 selects
+  /// std::thread::hardware_concurrency().
+  size_t threads = 0;
+
+  /// Files found but not yet detected. The walk waits while this many are
+  /// queued, so memory stays bounded however large the tree is.
+  size_t queue_capacity = 4096;
+
+  /// Only files with one of these extensions, compared without the dot and
+  /// ignoring ASCII case; empty for all files.
+  std::vector<std::string> include_extensions;
+
+  /// Files with one of these extensions are skipped.
+  std::vector<std::string> exclude_extensions;
+
+  /// Only files of at least this many bytes.
+  uint64_t min_size = 0;
+
+  /// Only files of at most this many bytes.
+  uint64_t max_size = std::numeric_limits<uint64_t>::max();
+
+  /// Only files of types in these categories are reported; see
+  /// match(ByteView, CategoryMask). Pass the complement of a mask to exclude
+  /// categories.
+  CategoryMask categories = ALL_CATEGORIES;
+
+  /// Also report files no signature of @ref categories matches, with an
+  /// empty result.
+  bool include_unknown = true;
+
+  /// Descend into symbolic links to directories and detect symbolic links
+  /// to files; otherwise links are skipped. Links back to a directory being
+  /// walked are not followed.
+  bool follow_symlinks = false;
+};
+
+/// A file reported by scan_directory().
+struct DirectoryEntry {
+  /// The root joined with the path below it; valid during the call only.
+  std::string_view path;
+
+  /// Size in bytes; 0 on error.
+  uint64_t size = 0;
+
+  /// Detection result; empty if nothing matched or on error.
+  DetectionResult result;
+
+  /// Errno-derived error if the file could not be read, or if @ref path is
+  /// a directory that could not be listed.
+  std::error_code ec;
+};
+
+/// Receives the files of scan_directory(), one at a time.
+using DirectorySink = std::function<void(const DirectoryEntry& entry)>;
+
+/**
+ * @brief Detect the type of every file below a directory, in parallel.
+ *
+ * The calling thread walks the tree depth first, opening each directory
+ * relative to its parent's descriptor and listing it with getdents64()
+ * (readdir() elsewhere) a buffer at a time, so wide directories cost no
+ * more memory than narrow ones. At most 32 directories are open at once:
+ * the outermost ancestors of a deeper one are closed, keeping only their
+ * place in the listing, and reopened when the walk returns to them, so
+ * each further level costs about a hundred bytes and no descriptor.
+ * Regular files that pass the extension filters are queued for the
+ * detection threads, which open them, apply the size filters and detect
+ * them as detect_file() does. When DirectoryScanOptions::queue_capacity
+ * files are waiting, the walk pauses until the detection threads catch up.
+ *
+ * @p sink is called from the detection threads, and from the walking thread
+ * for directories that cannot be listed, but never concurrently; entries
+ * arrive in no particular order. It must not throw.
+ *
+ * @param root Directory to scan.
+ * @param sink Called for every reported file.
+ * @param ec Receives the errno-derived error if @p root cannot be opened as
+ * a directory; cleared otherwise.
+ * @param options Thread count, queue capacity and filters.
+ * @return Number of entries reported.
+ */
+size_t scan_directory(std::string_view root, const DirectorySink& sink,
+                      std::error_code& ec,
+                      const DirectoryScanOptions& options =
+                          DirectoryScanOptions());
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_DIRECTORY_HPP_
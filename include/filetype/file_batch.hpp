@@ -0,0 +1,80 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_FILE_BATCH_HPP_
+#define INCLUDE_FILETYPE_FILE_BATCH_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+/// Tuning knobs for detect_files().
+struct FileBatchOptions {
+  /// Opens and reads kept in flight across all threads. Without io_uring,
+  /// the number of threads blocked in reads, at most 64.
+  size_t queue_depth = 256;
+
+  /// Threads submitting requests and running detection on their
+  /// completions, including the caller.
+  size_t threads = 1;
+
+  /// Categories to probe; see match(ByteView, CategoryMask).
+  CategoryMask categories = ALL_CATEGORIES;
+
+  /// Use io_uring where the kernel offers it; false forces the thread pool.
+  bool use_io_uring = true;
+};
+
+/**
+ * @brief Receives the outcome for one path of detect_files().
+ *
+ * @param index Position of the path in the input.
+ * @param result Detection result; empty if nothing matched or on error.
+ * @param ec Errno-derived error if the file could not be opened or read.
+ */
+using FileCallback = std::function<void(
+    size_t index, const DetectionResult& result, const std::error_code& ec)>;
+
+/**
+ * @brief Detect the type of many files, keeping many reads in flight.
+ *
+ * On Linux, each thread drives an io_uring: it queues openat and read
+ * requests for its share of the queue depth, runs detection as the first
+ * bytes of a file arrive and refills the ring from the remaining paths, so
+ * a handful of threads keep a deep device queue busy. Containers and
+ * trailers needing further reads get them as positioned reads on the open
+ * file. Where io_uring is unavailable (other systems, older kernels,
+ * seccomp filters), a thread pool runs detect_file() on up to
+ * FileBatchOptions::queue_depth paths at a time.
+ *
+ * Results equal those of detect_file(). @p on_result is called exactly once
+ * per path, in completion order and possibly concurrently from several
+ * threads; it must not throw. The call returns after the last one.
+ *
+ * @param paths Files to classify.
+ * @param count Number of paths.
+ * @param on_result Receives each result.
+ * @param options Queue depth, thread count and category options.
+ */
+void detect_files(const std::string_view* paths, size_t count,
+                  const FileCallback& on_result,
+                  const FileBatchOptions& options = FileBatchOptions());
+
+/// @overload
+inline void detect_files(const std::vector<std::string>& paths,
+                         const FileCallback& on_result,
+                         const FileBatchOptions& options = FileBatchOptions()) {
+  const std::vector<std::string_view> views(paths.begin(), paths.end());
+  detect_files(views.data(), views.size(), on_result, options);
+}
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_FILE_BATCH_HPP_
@@ -42,8 +42,21 @@
 #include <cstdint>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <vector>
 
+#include "filetype/batch.hpp"
+#include "filetype/byte_view.hpp"
+#include "filetype/cache.hpp"
+#include "filetype/directory.hpp"
+#include "filetype/file_batch.hpp"
+#include "filetype/index.hpp"
+#include "filetype/mapped_file.hpp"
+#include "filetype/result.hpp"
+#include "filetype/scan.hpp"
+#include "filetype/signature_db.hpp"
+#include "filetype/stream.hpp"
+#include "filetype/text.hpp"
 #include "filetype/types.hpp"
 
 namespace filetype {
@@ -53,9 +66,15 @@ namespace filetype {
  *
  * @param bytes Input buffer to validate.
  * @param min_size Minimum required size for the buffer (default: 8 bytes).
- * @return true if buffer is valid and has sufficient size.
+ * @return true if the buffer holds at least @p min_size bytes.
  */
-bool is_valid_buffer(const std::vector<uint8_t>& bytes, size_t min_size = 8);
+bool is_valid_buffer(ByteView bytes, size_t min_size = 8);
+
+/// @overload
+inline bool is_valid_buffer(const std::vector<uint8_t>& bytes,
+                            size_t min_size = 8) {
+  return is_valid_buffer(ByteView(bytes), min_size);
+}
 
 /**
  * @brief Compare bytes with a magic number pattern.
@@ -66,8 +85,15 @@ bool is_valid_buffer(const std::vector<uint8_t>& bytes, size_t min_size = 8);
  * @param offset Offset in bytes where to start matching (default: 0).
  * @return true if bytes match the magic number pattern.
  */
-bool match_magic(const std::vector<uint8_t>& bytes, const uint8_t* magic,
-                 size_t magic_size, size_t offset = 0);
+bool match_magic(ByteView bytes, const uint8_t* magic, size_t magic_size,
+                 size_t offset = 0);
+
+/// @overload
+inline bool match_magic(const std::vector<uint8_t>& bytes,
+                        const uint8_t* magic, size_t magic_size,
+                        size_t offset = 0) {
+  return match_magic(ByteView(bytes), magic, magic_size, offset);
+}
 
 /**
  * @brief Template version of match_magic for std::array magic numbers.
@@ -79,9 +105,16 @@ bool match_magic(const std::vector<uint8_t>& bytes, const uint8_t* magic,
  * @return true if bytes match the magic number pattern.
  */
 template <size_t N>
+bool match_magic(ByteView bytes, const std::array<uint8_t, N>& magic,
+                 size_t offset = 0) {
+  return match_magic(bytes, magic.data(), N, offset);
+}
+
+/// @overload
+template <size_t N>
 bool match_magic(const std::vector<uint8_t>& bytes,
                  const std::array<uint8_t, N>& magic, size_t offset = 0) {
-  return match_magic(bytes, magic.data(), N, offset);
+  return match_magic(ByteView(bytes), magic.data(), N, offset);
 }
 
 /**
@@ -93,8 +126,14 @@ bool match_magic(const std::vector<uint8_t>& bytes,
  * @param offset Offset where the magic number should appear (default: 0).
  * @return true if the file matches the specified format.
  */
-bool is_type(const std::vector<uint8_t>& bytes, const uint8_t* magic,
-             size_t magic_size, size_t offset = 0);
+bool is_type(ByteView bytes, const uint8_t* magic, size_t magic_size,
+             size_t offset = 0);
+
+/// @overload
+inline bool is_type(const std::vector<uint8_t>& bytes, const uint8_t* magic,
+                    size_t magic_size, size_t offset = 0) {
+  return is_type(ByteView(bytes), magic, magic_size, offset);
+}
 
 /**
  * @brief Template version of is_type for std::array magic numbers.
@@ -106,34 +145,206 @@ bool is_type(const std::vector<uint8_t>& bytes, const uint8_t* magic,
  * @return true if the file matches the specified format.
  */
 template <size_t N>
+bool is_type(ByteView bytes, const std::array<uint8_t, N>& magic,
+             size_t offset = 0) {
+  return is_type(bytes, magic.data(), N, offset);
+}
+
+/// @overload
+template <size_t N>
 bool is_type(const std::vector<uint8_t>& bytes,
              const std::array<uint8_t, N>& magic, size_t offset = 0) {
-  return is_type(bytes, magic.data(), N, offset);
+  return is_type(ByteView(bytes), magic.data(), N, offset);
+}
+
+/**
+ * @brief Run detection once and return everything known about the buffer.
+ *
+ * Use this instead of calling match() and several is_*() helpers on the same
+ * buffer: each of those runs detection again, while the returned result
+ * answers category questions with a bit test.
+ *
+ * @code
+ * filetype::DetectionResult result = filetype::detect(buffer);
+ * if (result.is_image() || result.is_video()) {
+ *     std::cout << result.type->mime << "\n";
+ * }
+ * @endcode
+ *
+ * @param bytes Buffer containing the file data to analyze.
+ * @return Detection result; its type is nullptr if nothing matched.
+ */
+DetectionResult detect(ByteView bytes);
+
+/// @overload
+inline DetectionResult detect(const std::vector<uint8_t>& bytes) {
+  return detect(ByteView(bytes));
+}
+
+/// @overload
+inline DetectionResult detect(const uint8_t* data, size_t size) {
+  return detect(ByteView(data, size));
 }
 
 /**
  * @brief Detect file type from a byte buffer.
  *
  * This function attempts to detect the file type by comparing the buffer's
- * contents with known magic numbers of various file formats.
+ * contents with known magic numbers of various file formats. The buffer is
+ * only borrowed: no copy or allocation is made.
  *
  * @param bytes Buffer containing the file data to analyze.
  * @return Pointer to the detected file type, or nullptr if type could not be
  * determined.
  */
-const Type* match(const std::vector<uint8_t>& bytes);
+const Type* match(ByteView bytes);
+
+/// @overload
+inline const Type* match(const std::vector<uint8_t>& bytes) {
+  return match(ByteView(bytes));
+}
+
+/// @overload
+inline const Type* match(const uint8_t* data, size_t size) {
+  return match(ByteView(data, size));
+}
+
+/**
+ * @brief Run detection restricted to a set of categories.
+ *
+ * Only signatures of types in @p categories are probed; every other signature
+ * is skipped rather than matched and filtered afterwards. Useful for callers
+ * that accept a single family, such as an image-only upload endpoint.
+ *
+ * @param bytes Buffer containing the file data to analyze.
+ * @param categories Categories to probe, e.g.
+ * `to_mask(Category::AUDIO) | to_mask(Category::VIDEO)`.
+ * @return Detection result; its type is nullptr if no probed signature
+ * matched.
+ */
+DetectionResult detect(ByteView bytes, CategoryMask categories);
+
+/// @overload
+inline DetectionResult detect(const std::vector<uint8_t>& bytes,
+                              CategoryMask categories) {
+  return detect(ByteView(bytes), categories);
+}
+
+/**
+ * @brief Detect file type among a set of categories.
+ *
+ * @param bytes Buffer containing the file data to analyze.
+ * @param categories Categories to probe.
+ * @return Pointer to the detected file type, or nullptr if no signature of
+ * the requested categories matched.
+ */
+const Type* match(ByteView bytes, CategoryMask categories);
+
+/// @overload
+inline const Type* match(const std::vector<uint8_t>& bytes,
+                         CategoryMask categories) {
+  return match(ByteView(bytes), categories);
+}
+
+/**
+ * @brief Last bytes of a file that tail detection looks at.
+ *
+ * A tail of this many bytes (or the whole file, if shorter) is enough for
+ * every built-in trailer.
+ */
+inline constexpr size_t TAIL_PROBE_SIZE = 4096;
+
+/**
+ * @brief Detect file type from the first and last bytes of a file.
+ *
+ * Some formats are only reliable from the end of the file: ZIP archives
+ * behind an executable stub (self-extracting archives) are found by their
+ * end-of-central-directory record, MP3 files without a frame sync at offset
+ * 0 by an ID3v1 tag, PDF files by their final `%%EOF`, and Apple disk images
+ * (TYPE_DMG) by their `koly` trailer. These trailers are looked for only
+ * when no signature matches @p head.
+ *
+ * @code
+ * // head: the first bytes of the file; tail: its last TAIL_PROBE_SIZE bytes
+ * filetype::DetectionResult result = filetype::detect(head, tail, file_size);
+ * @endcode
+ *
+ * @param head The first bytes of the file, as detect() takes them.
+ * @param tail The last bytes of the file, up to TAIL_PROBE_SIZE; may overlap
+ * @p head.
+ * @param size Size of the whole file.
+ * @param categories Categories to probe.
+ * @return Detection result; for a trailer, its offset is the trailer's
+ * offset in the file.
+ */
+DetectionResult detect(ByteView head, ByteView tail, uint64_t size,
+                       CategoryMask categories = ALL_CATEGORIES);
+
+/**
+ * @brief Detect file type from the first and last bytes of a file.
+ *
+ * @param head The first bytes of the file.
+ * @param tail The last bytes of the file, up to TAIL_PROBE_SIZE.
+ * @param size Size of the whole file.
+ * @param categories Categories to probe.
+ * @return Pointer to the detected file type, or nullptr.
+ */
+const Type* match(ByteView head, ByteView tail, uint64_t size,
+                  CategoryMask categories = ALL_CATEGORIES);
+
+/**
+ * @brief Look up a built-in type by identifier.
+ *
+ * @param id Identifier, e.g. one stored instead of the Type.
+ * @return The TYPE_* constant with identifier @p id, or nullptr for
+ * TypeId::UNKNOWN, TypeId::CUSTOM and values out of range.
+ */
+const Type* type_from_id(TypeId id);
+
+/**
+ * @brief Detect file type from a file path.
+ *
+ * Reads only as many leading bytes as the deepest built-in signature needs
+ * (a few hundred) with a single open() + pread() into a stack buffer. ZIP
+ * archives cost a few more bounded reads of entry headers to tell Office,
+ * OpenDocument, EPUB, JAR and APK files apart; no entry is decompressed.
+ * Compound File Binary (OLE2) files cost a capped number of FAT and
+ * directory reads to tell DOC, XLS, PPT and MSG apart.
+ * Files no signature matches cost one more read, of at most TAIL_PROBE_SIZE
+ * bytes from the end, for the trailers detect(head, tail, size) looks at.
+ * Nothing is printed on failure; the cause is reported through @p ec.
+ *
+ * @param filepath Path to the file to analyze.
+ * @param ec Receives the errno-derived error if the file cannot be opened or
+ * read; cleared otherwise.
+ * @return Detection result; empty on error or when no signature matches.
+ */
+DetectionResult detect_file(std::string_view filepath, std::error_code& ec);
+
+/**
+ * @brief Detect file type from a file path, reporting I/O errors.
+ *
+ * @param filepath Path to the file to analyze.
+ * @param ec Receives the errno-derived error if the file cannot be opened or
+ * read; cleared otherwise.
+ * @return Pointer to the detected file type, or nullptr on error or if type
+ * could not be determined.
+ */
+const Type* match_file(std::string_view filepath, std::error_code& ec);
 
 /**
  * @brief Detect file type from a file path.
  *
  * This function reads the beginning of the file and attempts to detect its type
- * by comparing with known magic numbers.
+ * by comparing with known magic numbers. Reads the same bytes as
+ * detect_file(); a @p max_read_size below that confines detection to the
+ * first @p max_read_size bytes.
  *
  * @param filepath Path to the file to analyze.
  * @param max_read_size Maximum number of bytes to read from the file (default:
  * 8192).
- * @return Pointer to the detected file type, or nullptr if type could not be
- * determined.
+ * @return Pointer to the detected file type, or nullptr if the file could not
+ * be read or its type could not be determined.
  */
 const Type* match_file(std::string_view filepath, size_t max_read_size = 8192);
 
@@ -144,7 +355,17 @@ const Type* match_file(std::string_view filepath, size_t max_read_size = 8192);
  * @param type Type to check against.
  * @return true if file matches the given type.
  */
-bool is(const std::vector<uint8_t>& bytes, const Type& type);
+bool is(ByteView bytes, const Type& type);
+
+/// @overload
+inline bool is(const std::vector<uint8_t>& bytes, const Type& type) {
+  return is(ByteView(bytes), type);
+}
+
+/// @overload
+inline bool is(const uint8_t* data, size_t size, const Type& type) {
+  return is(ByteView(data, size), type);
+}
 
 /**
  * @brief Check if file is an image.
@@ -152,7 +373,17 @@ bool is(const std::vector<uint8_t>& bytes, const Type& type);
  * @param bytes Buffer containing file data.
  * @return true if file is an image.
  */
-bool is_image(const std::vector<uint8_t>& bytes);
+bool is_image(ByteView bytes);
+
+/// @overload
+inline bool is_image(const std::vector<uint8_t>& bytes) {
+  return is_image(ByteView(bytes));
+}
+
+/// @overload
+inline bool is_image(const uint8_t* data, size_t size) {
+  return is_image(ByteView(data, size));
+}
 
 /**
  * @brief Check if file is a document.
@@ -160,7 +391,17 @@ bool is_image(const std::vector<uint8_t>& bytes);
  * @param bytes Buffer containing file data.
  * @return true if file is a document.
  */
-bool is_document(const std::vector<uint8_t>& bytes);
+bool is_document(ByteView bytes);
+
+/// @overload
+inline bool is_document(const std::vector<uint8_t>& bytes) {
+  return is_document(ByteView(bytes));
+}
+
+/// @overload
+inline bool is_document(const uint8_t* data, size_t size) {
+  return is_document(ByteView(data, size));
+}
 
 /**
  * @brief Check if file is an archive.
@@ -168,7 +409,17 @@ bool is_document(const std::vector<uint8_t>& bytes);
  * @param bytes Buffer containing file data.
  * @return true if file is an archive.
  */
-bool is_archive(const std::vector<uint8_t>& bytes);
+bool is_archive(ByteView bytes);
+
+/// @overload
+inline bool is_archive(const std::vector<uint8_t>& bytes) {
+  return is_archive(ByteView(bytes));
+}
+
+/// @overload
+inline bool is_archive(const uint8_t* data, size_t size) {
+  return is_archive(ByteView(data, size));
+}
 
 /**
  * @brief Check if file is an audio file.
@@ -176,7 +427,17 @@ bool is_archive(const std::vector<uint8_t>& bytes);
  * @param bytes Buffer containing file data.
  * @return true if file is an audio file.
  */
-bool is_audio(const std::vector<uint8_t>& bytes);
+bool is_audio(ByteView bytes);
+
+/// @overload
+inline bool is_audio(const std::vector<uint8_t>& bytes) {
+  return is_audio(ByteView(bytes));
+}
+
+/// @overload
+inline bool is_audio(const uint8_t* data, size_t size) {
+  return is_audio(ByteView(data, size));
+}
 
 /**
  * @brief Check if file is a video file.
@@ -184,7 +445,17 @@ bool is_audio(const std::vector<uint8_t>& bytes);
  * @param bytes Buffer containing file data.
  * @return true if file is a video file.
  */
-bool is_video(const std::vector<uint8_t>& bytes);
+bool is_video(ByteView bytes);
+
+/// @overload
+inline bool is_video(const std::vector<uint8_t>& bytes) {
+  return is_video(ByteView(bytes));
+}
+
+/// @overload
+inline bool is_video(const uint8_t* data, size_t size) {
+  return is_video(ByteView(data, size));
+}
 
 namespace matcher {
 
@@ -193,35 +464,85 @@ namespace matcher {
  * @param bytes Buffer containing file data.
  * @return Pointer to the detected image type, or nullptr if not an image.
  */
-const Type* match_image(const std::vector<uint8_t>& bytes);
+const Type* match_image(ByteView bytes);
+
+/// @overload
+inline const Type* match_image(const std::vector<uint8_t>& bytes) {
+  return match_image(ByteView(bytes));
+}
+
+/// @overload
+inline const Type* match_image(const uint8_t* data, size_t size) {
+  return match_image(ByteView(data, size));
+}
 
 /**
  * @brief Match document file types.
  * @param bytes Buffer containing file data.
  * @return Pointer to the detected document type, or nullptr if not a document.
  */
-const Type* match_document(const std::vector<uint8_t>& bytes);
+const Type* match_document(ByteView bytes);
+
+/// @overload
+inline const Type* match_document(const std::vector<uint8_t>& bytes) {
+  return match_document(ByteView(bytes));
+}
+
+/// @overload
+inline const Type* match_document(const uint8_t* data, size_t size) {
+  return match_document(ByteView(data, size));
+}
 
 /**
  * @brief Match archive file types.
  * @param bytes Buffer containing file data.
  * @return Pointer to the detected archive type, or nullptr if not an archive.
  */
-const Type* match_archive(const std::vector<uint8_t>& bytes);
+const Type* match_archive(ByteView bytes);
+
+/// @overload
+inline const Type* match_archive(const std::vector<uint8_t>& bytes) {
+  return match_archive(ByteView(bytes));
+}
+
+/// @overload
+inline const Type* match_archive(const uint8_t* data, size_t size) {
+  return match_archive(ByteView(data, size));
+}
 
 /**
  * @brief Match audio file types.
  * @param bytes Buffer containing file data.
  * @return Pointer to the detected audio type, or nullptr if not an audio file.
  */
-const Type* match_audio(const std::vector<uint8_t>& bytes);
+const Type* match_audio(ByteView bytes);
+
+/// @overload
+inline const Type* match_audio(const std::vector<uint8_t>& bytes) {
+  return match_audio(ByteView(bytes));
+}
+
+/// @overload
+inline const Type* match_audio(const uint8_t* data, size_t size) {
+  return match_audio(ByteView(data, size));
+}
 
 /**
  * @brief Match video file types.
  * @param bytes Buffer containing file data.
  * @return Pointer to the detected video type, or nullptr if not a video file.
  */
-const Type* match_video(const std::vector<uint8_t>& bytes);
+const Type* match_video(ByteView bytes);
+
+/// @overload
+inline const Type* match_video(const std::vector<uint8_t>& bytes) {
+  return match_video(ByteView(bytes));
+}
+
+/// @overload
+inline const Type* match_video(const uint8_t* data, size_t size) {
+  return match_video(ByteView(data, size));
+}
 
 }  // namespace matcher
 
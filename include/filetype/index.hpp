@@ -0,0 +1,178 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_INDEX_HPP_
+#define INCLUDE_FILETYPE_INDEX_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "filetype/byte_view.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+namespace internal {
+class FileMapping;
+struct FileIdentity;
+struct IndexRecord;
+}  // namespace internal
+
+/**
+ * @brief Detection results saved on disk, keyed by path and file identity.
+ *
+ * An index file is a flat table of fixed-size records sorted by a 64-bit
+ * hash of the path, each also holding the device, inode, size and
+ * modification time the file had when it was detected and the TypeId it was
+ * detected as. A fan-out table on the top bits of the hash narrows a lookup
+ * to a few records before a binary search.
+ *
+ * open() maps the file and checks its header and table bounds; nothing is
+ * deserialized, so a restarted scanner can answer lookups at once. An entry
+ * counts only while the file's current stat() identity matches it. Results
+ * of custom signatures are not stored, since a TypeId cannot name them.
+ *
+ * The header also records a fingerprint of the built-in signature tables.
+ * An index written by a library whose tables differ (new types, refined
+ * containers) answers no lookups, and neither does any index while
+ * register_signatures() databases are in effect, since those are searched
+ * before the built-in signatures.
+ */
+class DetectionIndex {
+ public:
+  ~DetectionIndex();
+
+  DetectionIndex(const DetectionIndex&) = delete;
+  DetectionIndex& operator=(const DetectionIndex&) = delete;
+
+  /**
+   * @brief Map an index file written by IndexWriter::commit().
+   *
+   * @param ec Set to the errno-derived error if the file cannot be mapped,
+   * or to std::errc::invalid_argument if it is not a valid index; cleared
+   * on success.
+   * @return The index, or nullptr on error.
+   */
+  static std::shared_ptr<const DetectionIndex> open(std::string_view path,
+                                                    std::error_code& ec);
+
+  /**
+   * @brief Look up the recorded type of a file.
+   *
+   * Costs one stat() of @p path and a search of the mapped table.
+   *
+   * @param path Path the file was recorded under.
+   * @param type Receives the recorded type on a hit; nullptr if the file
+   * was recorded as unrecognised.
+   * @param ec Receives the errno-derived error if @p path cannot be
+   * stat()ed; cleared otherwise.
+   * @return true if the index has an entry for @p path that still matches
+   * the file.
+   */
+  bool find(std::string_view path, const Type** type,
+            std::error_code& ec) const;
+
+  /// Number of entries.
+  size_t size() const { return count_; }
+
+  /// Number of commits the index has been through.
+  uint32_t generation() const { return generation_; }
+
+ private:
+  friend class IndexWriter;
+
+  DetectionIndex();
+
+  bool attach(ByteView image);
+
+  /// Entry for @p hash whose identity is @p identity, or nullptr.
+  const internal::IndexRecord* find(
+      uint64_t hash, const internal::FileIdentity& identity) const;
+
+  std::unique_ptr<internal::FileMapping> mapping_;
+  const uint32_t* fanout_ = nullptr;
+  const internal::IndexRecord* records_ = nullptr;
+  size_t count_ = 0;
+  uint32_t fanout_bits_ = 0;
+  uint32_t generation_ = 0;
+  bool current_ = false;  ///< Written with this library's signatures.
+};
+
+/// Options of IndexWriter::commit().
+struct IndexCommitOptions {
+  /// Entries not looked up through the writer survive this many commits,
+  /// so a partial scan keeps the rest of the index; older ones are dropped
+  /// as their files are likely gone.
+  uint32_t keep_unseen = 4;
+};
+
+/**
+ * @brief Builds the next version of a DetectionIndex during a scan.
+ *
+ * Workers call match_file() from any number of threads. Files whose entry
+ * in the base index still matches are answered from it; the rest are
+ * detected. Either way the file is recorded, and commit() merges the
+ * records with the base index into a new index file: entries of files that
+ * changed are replaced, and entries not seen for
+ * IndexCommitOptions::keep_unseen commits are dropped. A base written with
+ * other built-in signatures is treated as empty.
+ */
+class IndexWriter {
+ public:
+  /// @param base Index of the previous scan, or nullptr to start afresh.
+  explicit IndexWriter(std::shared_ptr<const DetectionIndex> base = nullptr);
+  ~IndexWriter();
+
+  IndexWriter(const IndexWriter&) = delete;
+  IndexWriter& operator=(const IndexWriter&) = delete;
+
+  /**
+   * @brief match_file() through the base index, recording the result.
+   *
+   * Safe to call from several threads at once.
+   *
+   * @param path Path to the file.
+   * @param ec Receives the errno-derived error if the file cannot be
+   * stat()ed, opened or read; cleared otherwise. Failures are not recorded.
+   * @return Detected type, or nullptr.
+   */
+  const Type* match_file(std::string_view path, std::error_code& ec);
+
+  /// Lookups answered by the base index.
+  uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+
+  /// Lookups that had to read the file.
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Write the merged index to @p path.
+   *
+   * The index is written to a temporary file next to @p path, synced and
+   * renamed over it, and the directory is synced after the rename, so
+   * readers of the old file keep a consistent view and a crash leaves
+   * either the old index or the new one. Call once every worker is done.
+   *
+   * @param ec Receives the errno-derived error on failure; cleared
+   * otherwise.
+   * @return true on success.
+   */
+  bool commit(std::string_view path, std::error_code& ec,
+              const IndexCommitOptions& options = IndexCommitOptions());
+
+ private:
+  struct Shard;
+
+  std::shared_ptr<const DetectionIndex> base_;
+  uint32_t generation_;
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_INDEX_HPP_
@@ -0,0 +1,105 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_MAPPED_FILE_HPP_
+#define INCLUDE_FILETYPE_MAPPED_FILE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <system_error>
+
+#include "filetype/byte_view.hpp"
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+namespace internal {
+class FileMapping;
+}  // namespace internal
+
+/// How a MappedFile is going to be read; passed on to the kernel.
+enum class Access {
+  NORMAL,      ///< The kernel's default readahead.
+  SEQUENTIAL,  ///< Front to back, as carve() does: read well ahead.
+  RANDOM,      ///< A few scattered ranges, as detection does: no readahead.
+};
+
+/**
+ * @brief A whole file mapped read-only.
+ *
+ * Pages are read when first touched, so detecting a multi-gigabyte archive
+ * through the mapping reads only the pages its classifiers look at: the
+ * head, a ZIP central directory, Compound File sectors, the tail. Opened
+ * with Access::RANDOM, each touched page costs one small read instead of a
+ * readahead window, and the classifiers announce the multi-page ranges they
+ * are about to read with will_need(), so each range is fetched in one
+ * request.
+ *
+ * Uses mmap() and posix_madvise() where available; elsewhere the file is
+ * read into memory and the hints do nothing.
+ */
+class MappedFile {
+ public:
+  MappedFile();
+  ~MappedFile();
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  /**
+   * @brief Map @p path, replacing any file mapped before.
+   *
+   * @param ec Set to the errno-derived error if the file cannot be opened or
+   * mapped, or to std::errc::invalid_argument if it is not a regular file;
+   * cleared on success.
+   * @param access How the mapping is going to be read.
+   * @return true on success; an empty file maps to an empty view.
+   */
+  bool open(std::string_view path, std::error_code& ec,
+            Access access = Access::RANDOM);
+
+  /// Mapped bytes; empty before a successful open().
+  ByteView bytes() const;
+
+  /// Change how the mapping is going to be read.
+  void advise(Access access) const;
+
+  /**
+   * @brief Ask for [offset, offset + count) to be read in ahead of use.
+   *
+   * The range is widened to whole pages and clipped to the file.
+   */
+  void will_need(uint64_t offset, uint64_t count) const;
+
+ private:
+  std::unique_ptr<internal::FileMapping> mapping_;
+};
+
+/**
+ * @brief Detect the type of a mapped file.
+ *
+ * Equivalent to detect(head, tail, size) over the whole mapping, but
+ * classifiers read through the mapping with will_need() hints, and the tail
+ * is only touched when no head signature matches.
+ *
+ * @param file Mapped file, ideally opened with Access::RANDOM.
+ * @param categories Categories to probe.
+ * @return Detection result; empty for an empty or unopened file.
+ */
+DetectionResult detect(const MappedFile& file,
+                       CategoryMask categories = ALL_CATEGORIES);
+
+/**
+ * @brief Detect the type of a mapped file.
+ *
+ * @param file Mapped file.
+ * @param categories Categories to probe.
+ * @return Pointer to the detected file type, or nullptr.
+ */
+const Type* match(const MappedFile& file,
+                  CategoryMask categories = ALL_CATEGORIES);
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_MAPPED_FILE_HPP_
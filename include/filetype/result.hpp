@@ -0,0 +1,42 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_RESULT_HPP_
+#define INCLUDE_FILETYPE_RESULT_HPP_
+
+#include <cstddef>
+
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+/**
+ * @brief Outcome of a single detection pass.
+ *
+ * Holds everything a caller may ask about a buffer, so several
+ * classification questions cost one detection instead of one each.
+ */
+struct DetectionResult {
+  const Type* type = nullptr;    ///< Detected type, or nullptr if unknown.
+  CategoryMask categories = 0;   ///< Categories the detected type belongs to.
+  size_t offset = 0;             ///< Offset of the matched signature.
+  size_t length = 0;             ///< Length of the matched signature.
+
+  /// true if a type was detected.
+  explicit operator bool() const { return type != nullptr; }
+
+  /// Identifier of the detected type, or TypeId::UNKNOWN.
+  TypeId id() const { return type ? type->id : TypeId::UNKNOWN; }
+
+  /// true if the detected type belongs to any category in @p mask.
+  bool in(CategoryMask mask) const { return (categories & mask) != 0; }
+
+  bool is_image() const { return in(to_mask(Category::IMAGE)); }
+  bool is_document() const { return in(to_mask(Category::DOCUMENT)); }
+  bool is_archive() const { return in(to_mask(Category::ARCHIVE)); }
+  bool is_audio() const { return in(to_mask(Category::AUDIO)); }
+  bool is_video() const { return in(to_mask(Category::VIDEO)); }
+};
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_RESULT_HPP_
@@ -0,0 +1,115 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_SCAN_HPP_
+#define INCLUDE_FILETYPE_SCAN_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "filetype/byte_view.hpp"
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+/// A file found by scan() inside a larger buffer.
+struct ScanHit {
+  size_t offset;           ///< Where the embedded file starts in the buffer.
+  DetectionResult result;  ///< What detect() reports for the bytes from there.
+};
+
+/**
+ * @brief Find every position in a buffer where a known file starts.
+ *
+ * Unlike match(), which only looks at the start of the buffer, scan() finds
+ * signatures anywhere in it: a PDF after leading junk, an MP3 after
+ * padding, the ZIP archive behind a self-extracting executable stub. The
+ * built-in and registered signatures are compiled into one multi-pattern
+ * automaton, so the buffer is read once whatever the number of signatures,
+ * and stretches that cannot start any signature are skipped with vector
+ * instructions.
+ *
+ * Each candidate position is confirmed with detect() on the bytes from that
+ * position, container refiners included. Signatures with fewer than three
+ * constant bytes in a row (BMP, MP3 frame sync, AAC, compress) are only
+ * matched at offset 0, since they occur by chance in arbitrary data. Pass
+ * the window to search, e.g. the first few KiB of a file.
+ *
+ * @param bytes Buffer to scan.
+ * @param categories Only types of these categories are reported.
+ * @return Hits ordered by offset; offset 0 is reported whenever match()
+ * would report a type. Formats that embed their own signatures (the local
+ * headers of a ZIP archive, say) are reported at each of them.
+ */
+std::vector<ScanHit> scan(ByteView bytes,
+                          CategoryMask categories = ALL_CATEGORIES);
+
+/**
+ * @brief Detect the first file that starts anywhere in a buffer.
+ *
+ * @param bytes Buffer to scan.
+ * @param offset Receives the offset of the hit if not nullptr.
+ * @return The type of the earliest hit of scan(), or nullptr.
+ */
+const Type* match_anywhere(ByteView bytes, size_t* offset = nullptr);
+
+/// Tuning knobs for carve() and carve_file().
+struct CarveOptions {
+  /// Threads taking part, including the caller. 0 selects
+  /// std::thread::hardware_concurrency(); more than that are not used.
+  size_t threads = 0;
+
+  /// Bytes of the input handed to a thread at a time.
+  size_t chunk_size = size_t{1} << 20;
+
+  /// Only types of these categories are reported.
+  CategoryMask categories = ALL_CATEGORIES;
+};
+
+/// Receives the hits of carve(), one at a time and in offset order.
+using CarveCallback = std::function<void(const ScanHit& hit)>;
+
+/**
+ * @brief Find every embedded file in a large region, in parallel.
+ *
+ * Reports what scan() would for the whole region, without collecting the
+ * hits: the region is cut into chunks of CarveOptions::chunk_size bytes
+ * that are scanned on the shared thread pool, each reading on into the next
+ * chunk as far as the longest signature reaches so that no file straddling
+ * a boundary is missed or reported twice. Hits are confirmed against the
+ * whole region, so container refiners see past chunk boundaries.
+ *
+ * @p on_hit is called from whichever thread finishes a chunk, but never
+ * concurrently and always in increasing offset order; it must not throw.
+ * No snapshot is held while it runs, so it may call register_signatures(),
+ * replace_signatures() or clear_signatures(); chunks scanned afterwards see
+ * the new set, and chunks already scanned are not revisited.
+ *
+ * @param bytes Region to carve, e.g. a memory-mapped disk image.
+ * @param on_hit Called for every hit.
+ * @param options Thread count, chunk size and category filter.
+ * @return Number of hits reported.
+ */
+size_t carve(ByteView bytes, const CarveCallback& on_hit,
+             const CarveOptions& options = CarveOptions());
+
+/**
+ * @brief Memory-map a file and carve() it.
+ *
+ * @param path Path to the file, e.g. a raw disk image.
+ * @param on_hit Called for every hit; see carve().
+ * @param ec Receives the errno-derived error if the file cannot be opened or
+ * mapped; cleared otherwise.
+ * @param options Thread count, chunk size and category filter.
+ * @return Number of hits reported.
+ */
+size_t carve_file(std::string_view path, const CarveCallback& on_hit,
+                  std::error_code& ec,
+                  const CarveOptions& options = CarveOptions());
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_SCAN_HPP_
@@ -0,0 +1,190 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_SIGNATURE_DB_HPP_
+#define INCLUDE_FILETYPE_SIGNATURE_DB_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "filetype/byte_view.hpp"
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+namespace internal {
+class FileMapping;
+struct Signature;
+struct SignatureSnapshot;
+}  // namespace internal
+
+/// Deepest byte (offset + length) a signature database may look at.
+inline constexpr size_t SIGNATURE_DB_MAX_END = 4096;
+
+/**
+ * @brief Compile a signature description into a database image.
+ *
+ * The description has one signature per line; `#` starts a comment:
+ *
+ * @code
+ * # mime                  ext   category  offset  magic     [options]
+ * application/x-acme      acme  archive   0       41434D45  priority=10
+ * application/x-acme      acme  archive   0       41434D??  mask=FFFFFF00
+ * image/x-foo             foo   image     8       464F4F21
+ * @endcode
+ *
+ * `category` is one of image, document, archive, audio or video. `offset`
+ * is decimal or `0x` hexadecimal. `magic` is hexadecimal; `??` stands for
+ * a byte that is not compared. `mask=` gives a per-byte mask of the same
+ * length, and `priority=` (default 0, range -32768..32767) orders
+ * signatures before specificity does, within the database and against hits
+ * from other registered databases. Lines with the same MIME type describe
+ * the same type.
+ *
+ * The image holds the first-byte candidate index and the pre-masked
+ * patterns the match engine searches, so loading it needs no parsing.
+ *
+ * @param source Signature description.
+ * @param image Receives the compiled image.
+ * @param error Receives "line N: reason" on failure; may be nullptr.
+ * @return true on success.
+ */
+bool compile_signatures(std::string_view source, std::vector<uint8_t>* image,
+                        std::string* error = nullptr);
+
+/**
+ * @brief Custom signatures loaded from a compiled image.
+ *
+ * open() maps the image file read-only and searches it in place: loading
+ * checks the header and bounds of every section and builds one Type per
+ * custom type, but parses nothing, so a worker can start detecting right
+ * after start-up. Types returned by a database use TypeId::CUSTOM and stay
+ * valid while the database is alive.
+ */
+class SignatureDatabase {
+ public:
+  ~SignatureDatabase();
+
+  SignatureDatabase(const SignatureDatabase&) = delete;
+  SignatureDatabase& operator=(const SignatureDatabase&) = delete;
+
+  /**
+   * @brief Map and load a compiled image file.
+   *
+   * @param path Path to an image written from compile_signatures().
+   * @param ec Set to the errno-derived error if the file cannot be mapped,
+   * or to std::errc::invalid_argument if it is not a valid image; cleared
+   * on success.
+   * @return The database, or nullptr on error.
+   */
+  static std::shared_ptr<const SignatureDatabase> open(std::string_view path,
+                                                       std::error_code& ec);
+
+  /**
+   * @brief Load a compiled image held in memory.
+   *
+   * @param image Image bytes; copied.
+   * @param ec Set to std::errc::invalid_argument if @p image is not a valid
+   * image; cleared on success.
+   * @return The database, or nullptr on error.
+   */
+  static std::shared_ptr<const SignatureDatabase> load(ByteView image,
+                                                       std::error_code& ec);
+
+  /**
+   * @brief Detect a custom type.
+   *
+   * @param bytes Buffer containing the file data to analyze.
+   * @param categories Only signatures of these categories are considered.
+   * @return Detection result; empty if no signature matched.
+   */
+  DetectionResult detect(ByteView bytes,
+                         CategoryMask categories = ALL_CATEGORIES) const;
+
+  /// Detected custom type, or nullptr.
+  const Type* match(ByteView bytes) const { return detect(bytes).type; }
+
+  /// Number of custom types.
+  size_t type_count() const { return types_.size(); }
+
+  /// Custom type @p index, in order of first appearance in the description.
+  const Type& type(size_t index) const { return types_[index]; }
+
+  /// Number of signatures.
+  size_t signature_count() const { return signature_count_; }
+
+  /// Largest offset + length over the signatures.
+  size_t max_end() const { return max_end_; }
+
+ private:
+  friend struct internal::SignatureSnapshot;
+
+  SignatureDatabase();
+
+  bool attach(ByteView image);
+
+  /// The signature detect() reports, or nullptr.
+  const internal::Signature* find(ByteView bytes,
+                                  CategoryMask categories) const;
+
+  std::unique_ptr<internal::FileMapping> mapping_;  ///< Image from open().
+  std::vector<uint8_t> copy_;                        ///< Image from load().
+  std::vector<Type> types_;
+  std::unique_ptr<internal::Signature[]> signatures_;
+  size_t signature_count_ = 0;
+  size_t max_end_ = 0;
+  const uint32_t* buckets_ = nullptr;
+  const uint32_t* candidates_ = nullptr;
+  const uint8_t* patterns_ = nullptr;
+  const uint8_t* masks_ = nullptr;
+};
+
+/**
+ * @brief Make match(), detect(), the file functions and the batch functions
+ * consult @p database.
+ *
+ * Registered databases are searched before the built-in signatures. When
+ * several have a hit, the one whose signature has the highest `priority=`
+ * decides, and among equal priorities the most recently registered.
+ * StreamDetector uses the built-in signatures only.
+ *
+ * The active signatures form an immutable snapshot. This call, like
+ * replace_signatures() and clear_signatures(), publishes a new snapshot
+ * with one atomic store: detection running on other threads never waits
+ * and sees either the old or the new set, never a mix. Updates are
+ * serialized and return once no detection still uses the previous
+ * snapshot, which is then released.
+ *
+ * @param database Database to register; nullptr is ignored.
+ */
+void register_signatures(std::shared_ptr<const SignatureDatabase> database);
+
+/**
+ * @brief Swap the registered databases for @p databases in one update.
+ *
+ * Reloading a daemon's signatures this way leaves no window in which
+ * neither the old nor the new set is active.
+ *
+ * @param databases New databases; among hits of equal priority the earlier
+ * one decides. nullptrs are ignored.
+ */
+void replace_signatures(
+    std::vector<std::shared_ptr<const SignatureDatabase>> databases);
+
+/**
+ * @brief Forget every registered database, going back to the built-in
+ * signatures.
+ *
+ * Types detected earlier stay valid as long as the caller holds its own
+ * reference to their database.
+ */
+void clear_signatures();
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_SIGNATURE_DB_HPP_
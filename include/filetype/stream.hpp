@@ -0,0 +1,136 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_STREAM_HPP_
+#define INCLUDE_FILETYPE_STREAM_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "filetype/byte_view.hpp"
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+
+namespace internal {
+class Engine;
+struct Signature;
+}  // namespace internal
+
+/// Stream bytes a StreamDetector keeps to look inside a container format.
+inline constexpr size_t STREAM_REFINE_WINDOW = 4096;
+
+/// Where a StreamDetector stands after the bytes seen so far.
+enum class StreamState : uint8_t {
+  NEED_MORE = 0,  ///< Undecided; more bytes are needed.
+  DETECTED,       ///< The type is known; later bytes cannot change it.
+  REJECTED,       ///< No signature can match any more.
+};
+
+/// Answer returned by StreamDetector::feed() and StreamDetector::finish().
+struct StreamStatus {
+  StreamState state = StreamState::NEED_MORE;
+
+  /// Detected type when DETECTED. While NEED_MORE, the best signature that
+  /// has already matched in full (nullptr if none); it is only overridden if a
+  /// more specific signature still waiting for bytes completes.
+  const Type* type = nullptr;
+
+  /// While NEED_MORE, bytes the most specific undecided signature still
+  /// needs before it is settled. Feeding fewer is fine; 0 otherwise.
+  size_t need = 0;
+
+  bool need_more() const { return state == StreamState::NEED_MORE; }
+  bool detected() const { return state == StreamState::DETECTED; }
+  bool rejected() const { return state == StreamState::REJECTED; }
+};
+
+/**
+ * @brief Incremental detector fed one chunk at a time.
+ *
+ * Every byte is checked against the surviving candidate signatures the
+ * moment it arrives and is not kept afterwards, so a proxy can forward each
+ * chunk right after feeding it. The detector decides as soon as the outcome
+ * of match() on the whole stream is certain, and agrees with it. Bytes no
+ * surviving signature covers (for instance everything between the first few
+ * bytes and TAR's magic at offset 257) are skipped without being looked at.
+ *
+ * Containers identified by their entries (ZIP-based formats such as DOCX,
+ * EPUB or JAR, and OLE2 compound files such as XLS or MSG) are the
+ * exception: while such a signature is in play the first
+ * STREAM_REFINE_WINDOW bytes are kept, and the specific type is decided from
+ * the entries they hold once that many bytes, or the end of the stream, have
+ * arrived. ISO base media files (MP4, MOV, HEIC, ...) are decided from the
+ * brands of their `ftyp` box, within the first few hundred bytes.
+ *
+ * @code
+ * filetype::StreamDetector detector;
+ * while (auto chunk = next_chunk()) {
+ *   if (!detector.feed(chunk).need_more()) {
+ *     break;
+ *   }
+ * }
+ * const filetype::StreamStatus status = detector.finish();
+ * @endcode
+ */
+class StreamDetector {
+ public:
+  /**
+   * @brief Start detection of a new stream.
+   *
+   * @param categories Only signatures of these categories are considered;
+   * see match(ByteView, CategoryMask).
+   */
+  explicit StreamDetector(CategoryMask categories = ALL_CATEGORIES);
+
+  /**
+   * @brief Feed the next chunk of the stream.
+   *
+   * Chunks fed after the detector has decided are ignored.
+   *
+   * @param chunk Next bytes of the stream; may be empty.
+   * @return Status after this chunk.
+   */
+  StreamStatus feed(ByteView chunk);
+
+  /**
+   * @brief Signal the end of the stream and settle the outcome.
+   *
+   * Signatures still waiting for bytes can no longer match, so the result
+   * is DETECTED or REJECTED, exactly as match() on the whole stream.
+   */
+  StreamStatus finish();
+
+  /// Status after the bytes fed so far.
+  const StreamStatus& status() const { return status_; }
+
+  /// Full detection result once DETECTED, an empty result otherwise.
+  const DetectionResult& result() const { return result_; }
+
+  /// Number of bytes fed so far.
+  size_t consumed() const { return consumed_; }
+
+  /// Forget everything fed so far and start over.
+  void reset();
+
+ private:
+  void select_bucket(uint8_t first_byte);
+  void check(ByteView chunk);
+  void settle(bool at_end);
+  void decide(const internal::Signature* winner, bool at_end);
+
+  const internal::Engine* engine_;
+  const internal::Signature* const* candidates_ = nullptr;
+  size_t candidate_count_ = 0;
+  std::vector<uint64_t> alive_;  ///< One bit per candidate still possible.
+  std::vector<uint8_t> prefix_;  ///< Stream start, kept for refiners only.
+  bool keep_prefix_ = false;
+  size_t consumed_ = 0;
+  StreamStatus status_;
+  DetectionResult result_;
+};
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_STREAM_HPP_
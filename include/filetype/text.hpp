@@ -0,0 +1,111 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef INCLUDE_FILETYPE_TEXT_HPP_
+#define INCLUDE_FILETYPE_TEXT_HPP_
+
+#include <cstddef>
+#include <string_view>
+
+#include "filetype/byte_view.hpp"
+#include "filetype/type.hpp"
+#include "filetype/types/document.hpp"
+
+namespace filetype {
+
+/// Default number of leading bytes detect_text() looks at.
+constexpr size_t TEXT_PROBE_SIZE = 8192;
+
+/// Character encoding reported by detect_text().
+enum class Charset : uint8_t {
+  BINARY = 0,  ///< Not text.
+  ASCII,
+  UTF8,
+  UTF16LE,
+  UTF16BE,
+  UTF32LE,
+  UTF32BE,
+};
+
+/// IANA name of @p charset ("utf-8", ...), or "binary".
+constexpr std::string_view charset_name(Charset charset) {
+  switch (charset) {
+    case Charset::ASCII:
+      return "us-ascii";
+    case Charset::UTF8:
+      return "utf-8";
+    case Charset::UTF16LE:
+      return "utf-16le";
+    case Charset::UTF16BE:
+      return "utf-16be";
+    case Charset::UTF32LE:
+      return "utf-32le";
+    case Charset::UTF32BE:
+      return "utf-32be";
+    case Charset::BINARY:
+      break;
+  }
+  return "binary";
+}
+
+/// Outcome of detect_text().
+struct TextResult {
+  Charset charset = Charset::BINARY;
+  size_t bom_length = 0;  ///< Bytes of byte-order mark at the start.
+
+  /// Whether the buffer holds text.
+  constexpr bool is_text() const { return charset != Charset::BINARY; }
+
+  /// &TYPE_TXT for text, nullptr for binary data.
+  constexpr const Type* type() const {
+    return is_text() ? &document::TYPE_TXT : nullptr;
+  }
+
+  /// MIME content type: "text/plain; charset=utf-8" and the like for text,
+  /// "application/octet-stream" otherwise.
+  constexpr std::string_view content_type() const {
+    switch (charset) {
+      case Charset::ASCII:
+        return "text/plain; charset=us-ascii";
+      case Charset::UTF8:
+        return "text/plain; charset=utf-8";
+      case Charset::UTF16LE:
+        return "text/plain; charset=utf-16le";
+      case Charset::UTF16BE:
+        return "text/plain; charset=utf-16be";
+      case Charset::UTF32LE:
+        return "text/plain; charset=utf-32le";
+      case Charset::UTF32BE:
+        return "text/plain; charset=utf-32be";
+      case Charset::BINARY:
+        break;
+    }
+    return "application/octet-stream";
+  }
+
+  explicit constexpr operator bool() const { return is_text(); }
+};
+
+/**
+ * @brief Tell plain text from binary data.
+ *
+ * Meant for buffers match() has no signature for. A UTF-8, UTF-16 or UTF-32
+ * byte-order mark decides the charset once the bytes after it within
+ * @p budget prove valid: UTF-8 as below, UTF-16 and UTF-32 as whole code
+ * units with paired surrogates and code points up to U+10FFFF; a unit or
+ * pair cut off by the end of the window is accepted. Without one, the first
+ * @p budget
+ * bytes are text when they hold no NUL, at most one control byte in 32
+ * (tab, newlines, form feed, backspace and escape do not count) and are
+ * valid UTF-8; a sequence cut off by the end of the window is accepted.
+ * Buffers of ASCII only report Charset::ASCII. The bytes are checked with
+ * vector instructions in a single pass, at several GB/s.
+ *
+ * @param bytes Buffer to classify.
+ * @param budget Number of leading bytes to examine.
+ * @return The charset; Charset::BINARY for binary and empty buffers.
+ */
+TextResult detect_text(ByteView bytes, size_t budget = TEXT_PROBE_SIZE);
+
+}  // namespace filetype
+
+#endif  // INCLUDE_FILETYPE_TEXT_HPP_
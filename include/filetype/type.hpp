@@ -3,20 +3,138 @@
 #ifndef INCLUDE_FILETYPE_TYPE_HPP_
 #define INCLUDE_FILETYPE_TYPE_HPP_
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 
 namespace filetype {
 
+/// Dense numeric identifier of every built-in type.
+enum class TypeId : uint16_t {
+  UNKNOWN = 0,
+
+  // Image types
+  PNG,
+  JPEG,
+  GIF,
+  WEBP,
+  CR2,
+  TIFF,
+  BMP,
+  JXR,
+  PSD,
+  ICO,
+  HEIC,
+
+  // Document types
+  PDF,
+  DOC,
+  DOCX,
+  XLS,
+  XLSX,
+  PPT,
+  PPTX,
+  ODT,
+  ODS,
+  ODP,
+  RTF,
+  EPUB,
+
+  // Archive types
+  ZIP,
+  RAR,
+  TAR,
+  SEVEN_Z,
+  GZ,
+  GZIP,
+  BZ2,
+  BZIP2,
+  XZ,
+  Z,
+  LZ,
+
+  // Audio types
+  MP3,
+  WAV,
+  MIDI,
+  FLAC,
+  AAC,
+  OGG,
+  WMA,
+  AIFF,
+  M4A,
+
+  // Video types
+  MP4,
+  AVI,
+  MKV,
+  WEBM,
+  MOV,
+  FLV,
+  WMV,
+  MPEG,
+  THREEGP,
+
+  // Identifiers below were added after the first release; new types are
+  // appended here so existing values stay stable.
+  JAR,
+  APK,
+  MSG,
+  AVIF,
+  CR3,
+
+  /// Shared by every type loaded from a SignatureDatabase.
+  CUSTOM,
+
+  TXT,
+  DMG,
+
+  COUNT  ///< Number of built-in type identifiers.
+};
+
+/// Broad family a type belongs to.
+enum class Category : uint8_t {
+  UNKNOWN = 0,
+  IMAGE,
+  DOCUMENT,
+  ARCHIVE,
+  AUDIO,
+  VIDEO,
+
+  COUNT  ///< Number of categories.
+};
+
+/// Bit set of categories; bit @c n stands for the Category with value @c n.
+using CategoryMask = uint32_t;
+
+/// Mask with only the bit of @p category set.
+constexpr CategoryMask to_mask(Category category) {
+  return CategoryMask{1} << static_cast<unsigned>(category);
+}
+
+/// Mask accepting every category.
+constexpr CategoryMask ALL_CATEGORIES = ~CategoryMask{0};
+
 /// Common Type struct used across all file formats.
+///
+/// Type is a literal type: the built-in TYPE_* constants are constexpr and
+/// need no dynamic initialization. Two types compare equal when their
+/// identifiers do; types loaded from a signature database all use
+/// TypeId::CUSTOM and compare equal when their MIME types do.
 struct Type {
-  std::string mime;       ///< MIME type of the file.
-  std::string extension;  ///< File extension without the dot.
+  std::string_view mime;       ///< MIME type of the file.
+  std::string_view extension;  ///< File extension without the dot.
+  TypeId id;                   ///< Numeric identifier of the type.
+  Category category;           ///< Family the type belongs to.
 
-  Type(const std::string& m, const std::string& ext)
-      : mime(m), extension(ext) {}
+  constexpr Type(std::string_view m, std::string_view ext, TypeId type_id,
+                 Category cat)
+      : mime(m), extension(ext), id(type_id), category(cat) {}
 
-  bool operator==(const Type& other) const {
-    return mime == other.mime && extension == other.extension;
+  constexpr bool operator==(const Type& other) const {
+    return id == other.id && (id != TypeId::CUSTOM || mime == other.mime);
+  }
+  constexpr bool operator!=(const Type& other) const {
+    return !(*this == other);
   }
 };
 
@@ -17,6 +17,7 @@
 #include <string_view>
 #include <vector>
 
+#include "filetype/byte_view.hpp"
 #include "filetype/type.hpp"
 #include "filetype/types/archive.hpp"
 #include "filetype/types/audio.hpp"
@@ -26,6 +27,11 @@
 
 namespace filetype {
 
+// Defined in filetype.cpp and declared with their defaults in filetype.hpp.
+bool is_valid_buffer(ByteView bytes, size_t min_size);
+bool match_magic(ByteView bytes, const uint8_t* magic, size_t magic_size,
+                 size_t offset);
+
 namespace types {
 
 /**
@@ -38,7 +44,9 @@ namespace types {
  * @return true if bytes match the magic number pattern.
  */
 inline bool match_magic(const std::vector<uint8_t>& bytes, const uint8_t* magic,
-                        size_t magic_size, size_t offset = 0);
+                        size_t magic_size, size_t offset = 0) {
+  return filetype::match_magic(ByteView(bytes), magic, magic_size, offset);
+}
 
 /**
  * @brief Template version of match_magic for std::array magic numbers.
@@ -61,16 +69,20 @@ inline bool match_magic(const std::vector<uint8_t>& bytes,
  *
  * @param bytes Buffer to check.
  * @param min_size Minimum required size (default: 8 bytes).
- * @return true if buffer is valid and has sufficient size.
+ * @return true if the buffer holds at least @p min_size bytes.
  */
 inline bool is_valid_buffer(const std::vector<uint8_t>& bytes,
-                            size_t min_size = 8);
+                            size_t min_size = 8) {
+  return filetype::is_valid_buffer(ByteView(bytes), min_size);
+}
 
 // Import commonly used types from category namespaces
 
 // Image types
+using image::TYPE_AVIF;
 using image::TYPE_BMP;
 using image::TYPE_CR2;
+using image::TYPE_CR3;
 using image::TYPE_GIF;
 using image::TYPE_HEIC;
 using image::TYPE_ICO;
@@ -85,17 +97,22 @@ using image::TYPE_WEBP;
 using document::TYPE_DOC;
 using document::TYPE_DOCX;
 using document::TYPE_EPUB;
+using document::TYPE_MSG;
 using document::TYPE_PDF;
 using document::TYPE_PPT;
 using document::TYPE_PPTX;
 using document::TYPE_RTF;
+using document::TYPE_TXT;
 using document::TYPE_XLS;
 using document::TYPE_XLSX;
 
 // Archive types
 using archive::TYPE_7Z;
+using archive::TYPE_APK;
 using archive::TYPE_BZ2;
+using archive::TYPE_DMG;
 using archive::TYPE_GZ;
+using archive::TYPE_JAR;
 using archive::TYPE_RAR;
 using archive::TYPE_TAR;
 using archive::TYPE_XZ;
@@ -127,10 +144,15 @@ using video::TYPE_WMV;
 // Import magic number definitions
 
 // Image magic numbers
+using image::AVIF_MAGIC;
+using image::AVIF_MASK;
 using image::BMP_MAGIC;
 using image::CR2_MAGIC;
+using image::CR3_MAGIC;
+using image::CR3_MASK;
 using image::GIF_MAGIC;
 using image::HEIC_MAGIC;
+using image::HEIC_MASK;
 using image::ICO_MAGIC;
 using image::JPEG_MAGIC;
 using image::JXR_MAGIC;
@@ -139,6 +161,7 @@ using image::PSD_MAGIC;
 using image::TIFF_MAGIC_BE;
 using image::TIFF_MAGIC_LE;
 using image::WEBP_MAGIC;
+using image::WEBP_MASK;
 
 // Document magic numbers
 using document::DOC_MAGIC;
@@ -159,24 +182,31 @@ using archive::ZIP_MAGIC;
 // Audio magic numbers
 using audio::AAC_MAGIC;
 using audio::AIFF_MAGIC;
+using audio::AIFF_MASK;
 using audio::FLAC_MAGIC;
 using audio::M4A_MAGIC;
+using audio::M4A_MASK;
 using audio::MIDI_MAGIC;
 using audio::MP3_ID3_MAGIC;
 using audio::MP3_MAGIC;
 using audio::OGG_MAGIC;
 using audio::WAV_MAGIC;
+using audio::WAV_MASK;
 using audio::WMA_MAGIC;
 
 // Video magic numbers
 using video::AVI_MAGIC;
+using video::AVI_MASK;
 using video::FLV_MAGIC;
 using video::MKV_MAGIC;
 using video::MOV_MAGIC;
+using video::MOV_MASK;
 using video::MP4_MAGIC;
+using video::MP4_MASK;
 using video::MPEG_MAGIC;
 using video::MPEG_MAGIC_ALT;
 using video::THREEGP_MAGIC;
+using video::THREEGP_MASK;
 using video::WEBM_MAGIC;
 using video::WMV_MAGIC;
 
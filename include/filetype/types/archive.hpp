@@ -19,53 +19,90 @@ using Type = ::filetype::Type;
 
 // ZIP archive format
 // Magic: 50 4B 03 04 (PK..)
-inline const std::array<uint8_t, 4> ZIP_MAGIC = {0x50, 0x4B, 0x03, 0x04};
-inline const Type TYPE_ZIP{"application/zip", "zip"};
+inline constexpr std::array<uint8_t, 4> ZIP_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_ZIP{"application/zip", "zip",
+                               TypeId::ZIP, Category::ARCHIVE};
 
 // RAR archive format
 // Magic: 52 61 72 21 1A 07 00 (Rar!..)
-inline const std::array<uint8_t, 7> RAR_MAGIC = {0x52, 0x61, 0x72, 0x21,
-                                                 0x1A, 0x07, 0x00};
-inline const Type TYPE_RAR{"application/x-rar-compressed", "rar"};
+inline constexpr std::array<uint8_t, 7> RAR_MAGIC = {0x52, 0x61, 0x72, 0x21,
+                                                     0x1A, 0x07, 0x00};
+inline constexpr Type TYPE_RAR{"application/x-rar-compressed", "rar",
+                               TypeId::RAR, Category::ARCHIVE};
 
 // TAR archive format
 // Magic: 75 73 74 61 72 (ustar) at offset 257
-inline const std::array<uint8_t, 5> TAR_MAGIC = {0x75, 0x73, 0x74, 0x61, 0x72};
-inline const Type TYPE_TAR{"application/x-tar", "tar"};
+inline constexpr std::array<uint8_t, 5> TAR_MAGIC = {0x75, 0x73, 0x74,
+                                                     0x61, 0x72};
+inline constexpr Type TYPE_TAR{"application/x-tar", "tar",
+                               TypeId::TAR, Category::ARCHIVE};
 
 // 7Z archive format
 // Magic: 37 7A BC AF 27 1C (7z..')
-inline const std::array<uint8_t, 6> SEVEN_Z_MAGIC = {0x37, 0x7A, 0xBC,
-                                                     0xAF, 0x27, 0x1C};
-inline const Type TYPE_7Z{"application/x-7z-compressed", "7z"};
+inline constexpr std::array<uint8_t, 6> SEVEN_Z_MAGIC = {0x37, 0x7A, 0xBC,
+                                                         0xAF, 0x27, 0x1C};
+inline constexpr Type TYPE_7Z{"application/x-7z-compressed", "7z",
+                              TypeId::SEVEN_Z, Category::ARCHIVE};
 
 // GZ archive format
 // Magic: 1F 8B 08 (GZip)
-inline const std::array<uint8_t, 3> GZ_MAGIC = {0x1F, 0x8B, 0x08};
-inline const Type TYPE_GZ{"application/gzip", "gz"};
-inline const Type TYPE_GZIP{"application/gzip", "gzip"};
+inline constexpr std::array<uint8_t, 3> GZ_MAGIC = {0x1F, 0x8B, 0x08};
+inline constexpr Type TYPE_GZ{"application/gzip", "gz",
+                              TypeId::GZ, Category::ARCHIVE};
+inline constexpr Type TYPE_GZIP{"application/gzip", "gzip",
+                                TypeId::GZIP, Category::ARCHIVE};
 
 // BZ2 archive format
 // Magic: 42 5A 68 (BZh)
-inline const std::array<uint8_t, 3> BZ2_MAGIC = {0x42, 0x5A, 0x68};
-inline const Type TYPE_BZ2{"application/x-bzip2", "bz2"};
-inline const Type TYPE_BZIP2{"application/x-bzip2", "bzip2"};
+inline constexpr std::array<uint8_t, 3> BZ2_MAGIC = {0x42, 0x5A, 0x68};
+inline constexpr Type TYPE_BZ2{"application/x-bzip2", "bz2",
+                               TypeId::BZ2, Category::ARCHIVE};
+inline constexpr Type TYPE_BZIP2{"application/x-bzip2", "bzip2",
+                                 TypeId::BZIP2, Category::ARCHIVE};
 
 // XZ archive format
 // Magic: FD 37 7A 58 5A 00
-inline const std::array<uint8_t, 6> XZ_MAGIC = {0xFD, 0x37, 0x7A,
-                                                0x58, 0x5A, 0x00};
-inline const Type TYPE_XZ{"application/x-xz", "xz"};
+inline constexpr std::array<uint8_t, 6> XZ_MAGIC = {0xFD, 0x37, 0x7A,
+                                                    0x58, 0x5A, 0x00};
+inline constexpr Type TYPE_XZ{"application/x-xz", "xz",
+                              TypeId::XZ, Category::ARCHIVE};
 
 // Z archive format (compress)
 // Magic: 1F 9D
-inline const std::array<uint8_t, 2> Z_MAGIC = {0x1F, 0x9D};
-inline const Type TYPE_Z{"application/x-compress", "Z"};
+inline constexpr std::array<uint8_t, 2> Z_MAGIC = {0x1F, 0x9D};
+inline constexpr Type TYPE_Z{"application/x-compress", "Z",
+                             TypeId::Z, Category::ARCHIVE};
 
 // LZ (LZIP) archive format
 // Magic: 4C 5A 49 50 (LZIP)
-inline const std::array<uint8_t, 4> LZ_MAGIC = {0x4C, 0x5A, 0x49, 0x50};
-inline const Type TYPE_LZ{"application/x-lzip", "lz"};
+inline constexpr std::array<uint8_t, 4> LZ_MAGIC = {0x4C, 0x5A, 0x49, 0x50};
+inline constexpr Type TYPE_LZ{"application/x-lzip", "lz",
+                              TypeId::LZ, Category::ARCHIVE};
+
+// Java archive format
+// Magic: 50 4B 03 04 (PK..)
+// Note: This is a ZIP file signature; told apart by its META-INF/MANIFEST.MF
+// entry.
+inline constexpr std::array<uint8_t, 4> JAR_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_JAR{"application/java-archive", "jar",
+                               TypeId::JAR, Category::ARCHIVE};
+
+// Android package format
+// Magic: 50 4B 03 04 (PK..)
+// Note: This is a ZIP file signature; told apart by its AndroidManifest.xml
+// or classes.dex entry.
+inline constexpr std::array<uint8_t, 4> APK_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_APK{"application/vnd.android.package-archive",
+                               "apk", TypeId::APK, Category::ARCHIVE};
+
+// Apple disk image format
+// Magic: 6B 6F 6C 79 (koly), 00 00 00 04, 00 00 02 00 at the start of the
+// last 512 bytes
+// Note: The head of the image is the raw or compressed volume data, so the
+// type is only recognised from the file's tail.
+inline constexpr std::array<uint8_t, 4> DMG_MAGIC = {0x6B, 0x6F, 0x6C, 0x79};
+inline constexpr Type TYPE_DMG{"application/x-apple-diskimage", "dmg",
+                               TypeId::DMG, Category::ARCHIVE};
 
 }  // namespace archive
 }  // namespace filetype
@@ -19,81 +19,106 @@ using Type = ::filetype::Type;
 
 // PDF document format
 // Magic: 25 50 44 46 ("%PDF")
-inline const std::array<uint8_t, 4> PDF_MAGIC = {0x25, 0x50, 0x44, 0x46};
-inline const Type TYPE_PDF{"application/pdf", "pdf"};
+inline constexpr std::array<uint8_t, 4> PDF_MAGIC = {0x25, 0x50, 0x44, 0x46};
+inline constexpr Type TYPE_PDF{"application/pdf", "pdf",
+                               TypeId::PDF, Category::DOCUMENT};
 
 // Microsoft DOC document format
 // Magic: D0 CF 11 E0 A1 B1 1A E1 (Office Binary Document)
-inline const std::array<uint8_t, 8> DOC_MAGIC = {0xD0, 0xCF, 0x11, 0xE0,
-                                                 0xA1, 0xB1, 0x1A, 0xE1};
-inline const Type TYPE_DOC{"application/msword", "doc"};
+inline constexpr std::array<uint8_t, 8> DOC_MAGIC = {0xD0, 0xCF, 0x11, 0xE0,
+                                                     0xA1, 0xB1, 0x1A, 0xE1};
+inline constexpr Type TYPE_DOC{"application/msword", "doc",
+                               TypeId::DOC, Category::DOCUMENT};
 
 // Microsoft DOCX document format
 // Magic: 50 4B 03 04 (PK..)
 // Note: This is a ZIP file signature; additional verification is needed.
-inline const std::array<uint8_t, 4> DOCX_MAGIC = {0x50, 0x4B, 0x03, 0x04};
-inline const Type TYPE_DOCX{
+inline constexpr std::array<uint8_t, 4> DOCX_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_DOCX{
     "application/vnd.openxmlformats-officedocument.wordprocessingml.document",
-    "docx"};
+    "docx", TypeId::DOCX, Category::DOCUMENT};
 
 // Microsoft XLS spreadsheet format
 // Magic: D0 CF 11 E0 A1 B1 1A E1 (same as DOC)
-inline const std::array<uint8_t, 8> XLS_MAGIC = {0xD0, 0xCF, 0x11, 0xE0,
-                                                 0xA1, 0xB1, 0x1A, 0xE1};
-inline const Type TYPE_XLS{"application/vnd.ms-excel", "xls"};
+inline constexpr std::array<uint8_t, 8> XLS_MAGIC = {0xD0, 0xCF, 0x11, 0xE0,
+                                                     0xA1, 0xB1, 0x1A, 0xE1};
+inline constexpr Type TYPE_XLS{"application/vnd.ms-excel", "xls",
+                               TypeId::XLS, Category::DOCUMENT};
 
 // Microsoft XLSX spreadsheet format
 // Magic: 50 4B 03 04 (PK..)
 // Note: This is a ZIP file signature; additional verification is needed.
-inline const std::array<uint8_t, 4> XLSX_MAGIC = {0x50, 0x4B, 0x03, 0x04};
-inline const Type TYPE_XLSX{
+inline constexpr std::array<uint8_t, 4> XLSX_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_XLSX{
     "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
-    "xlsx"};
+    "xlsx", TypeId::XLSX, Category::DOCUMENT};
 
 // Microsoft PowerPoint presentation format
 // Magic: D0 CF 11 E0 A1 B1 1A E1 (same as DOC)
-inline const std::array<uint8_t, 8> PPT_MAGIC = {0xD0, 0xCF, 0x11, 0xE0,
-                                                 0xA1, 0xB1, 0x1A, 0xE1};
-inline const Type TYPE_PPT{"application/vnd.ms-powerpoint", "ppt"};
+inline constexpr std::array<uint8_t, 8> PPT_MAGIC = {0xD0, 0xCF, 0x11, 0xE0,
+                                                     0xA1, 0xB1, 0x1A, 0xE1};
+inline constexpr Type TYPE_PPT{"application/vnd.ms-powerpoint", "ppt",
+                               TypeId::PPT, Category::DOCUMENT};
 
 // Microsoft PowerPoint PPTX presentation format
 // Magic: 50 4B 03 04 (PK..)
 // Note: This is a ZIP file signature; additional verification is needed.
-inline const std::array<uint8_t, 4> PPTX_MAGIC = {0x50, 0x4B, 0x03, 0x04};
-inline const Type TYPE_PPTX{
+inline constexpr std::array<uint8_t, 4> PPTX_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_PPTX{
     "application/vnd.openxmlformats-officedocument.presentationml.presentation",
-    "pptx"};
+    "pptx", TypeId::PPTX, Category::DOCUMENT};
 
 // OpenDocument Text format
 // Magic: 50 4B 03 04 (PK..)
 // Note: This is a ZIP file signature; additional verification is needed.
-inline const std::array<uint8_t, 4> ODT_MAGIC = {0x50, 0x4B, 0x03, 0x04};
-inline const Type TYPE_ODT{"application/vnd.oasis.opendocument.text", "odt"};
+inline constexpr std::array<uint8_t, 4> ODT_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_ODT{"application/vnd.oasis.opendocument.text", "odt",
+                               TypeId::ODT, Category::DOCUMENT};
 
 // OpenDocument Spreadsheet format
 // Magic: 50 4B 03 04 (PK..)
 // Note: This is a ZIP file signature; additional verification is needed.
-inline const std::array<uint8_t, 4> ODS_MAGIC = {0x50, 0x4B, 0x03, 0x04};
-inline const Type TYPE_ODS{"application/vnd.oasis.opendocument.spreadsheet",
-                           "ods"};
+inline constexpr std::array<uint8_t, 4> ODS_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_ODS{
+    "application/vnd.oasis.opendocument.spreadsheet", "ods", TypeId::ODS,
+    Category::DOCUMENT};
 
 // OpenDocument Presentation format
 // Magic: 50 4B 03 04 (PK..)
 // Note: This is a ZIP file signature; additional verification is needed.
-inline const std::array<uint8_t, 4> ODP_MAGIC = {0x50, 0x4B, 0x03, 0x04};
-inline const Type TYPE_ODP{"application/vnd.oasis.opendocument.presentation",
-                           "odp"};
+inline constexpr std::array<uint8_t, 4> ODP_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_ODP{
+    "application/vnd.oasis.opendocument.presentation", "odp", TypeId::ODP,
+    Category::DOCUMENT};
 
 // Rich Text Format
 // Magic: 7B 5C 72 74 66 ("{\\rtf")
-inline const std::array<uint8_t, 5> RTF_MAGIC = {0x7B, 0x5C, 0x72, 0x74, 0x66};
-inline const Type TYPE_RTF{"application/rtf", "rtf"};
+inline constexpr std::array<uint8_t, 5> RTF_MAGIC = {0x7B, 0x5C, 0x72,
+                                                     0x74, 0x66};
+inline constexpr Type TYPE_RTF{"application/rtf", "rtf",
+                               TypeId::RTF, Category::DOCUMENT};
 
 // EPUB document format
 // Magic: 50 4B 03 04 (PK..)
 // Note: This is a ZIP file signature; additional verification is needed.
-inline const std::array<uint8_t, 4> EPUB_MAGIC = {0x50, 0x4B, 0x03, 0x04};
-inline const Type TYPE_EPUB{"application/epub+zip", "epub"};
+inline constexpr std::array<uint8_t, 4> EPUB_MAGIC = {0x50, 0x4B, 0x03, 0x04};
+inline constexpr Type TYPE_EPUB{"application/epub+zip", "epub",
+                                TypeId::EPUB, Category::DOCUMENT};
+
+// Microsoft Outlook message format
+// Magic: D0 CF 11 E0 A1 B1 1A E1 (same as DOC)
+// Note: This is a Compound File Binary signature; told apart by its
+// __substg1.0_ property streams.
+inline constexpr std::array<uint8_t, 8> MSG_MAGIC = {0xD0, 0xCF, 0x11, 0xE0,
+                                                     0xA1, 0xB1, 0x1A, 0xE1};
+inline constexpr Type TYPE_MSG{"application/vnd.ms-outlook", "msg",
+                               TypeId::MSG, Category::DOCUMENT};
+
+// Plain text
+// Magic: none; recognised by detect_text() from a byte-order mark or from
+// the content itself.
+inline constexpr Type TYPE_TXT{"text/plain", "txt", TypeId::TXT,
+                               Category::DOCUMENT};
 
 }  // namespace document
 }  // namespace filetype
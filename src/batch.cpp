@@ -0,0 +1,70 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/batch.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "engine.hpp"
+#include "snapshot.hpp"
+#include "thread_pool.hpp"
+
+namespace filetype {
+namespace {
+
+template <typename Fn>
+void run_batch(size_t count, const BatchOptions& options, const Fn& fn) {
+  size_t threads = options.threads;
+  if (threads == 0) {
+    threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  if (threads <= 1 || count < options.sequential_threshold) {
+    fn(0, count);
+    return;
+  }
+  internal::parallel_for(threads, count, options.grain, fn);
+}
+
+}  // namespace
+
+void match_batch(const ByteView* inputs, size_t count, const Type** results,
+                 const BatchOptions& options) {
+  // One snapshot per batch, held by the calling thread for the workers.
+  const internal::SnapshotGuard snapshot;
+  const internal::Engine& engine = snapshot->engine(options.categories);
+  const bool custom = !snapshot->databases.empty();
+  run_batch(count, options, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      if (custom) {
+        if (const Type* type =
+                snapshot->detect_custom(inputs[i], options.categories).type) {
+          results[i] = type;
+          continue;
+        }
+      }
+      const internal::Signature* sig =
+          engine.find(inputs[i].data(), inputs[i].size());
+      results[i] = sig ? sig->type : nullptr;
+    }
+  });
+}
+
+void detect_batch(const ByteView* inputs, size_t count,
+                  DetectionResult* results, const BatchOptions& options) {
+  const internal::SnapshotGuard snapshot;
+  const internal::Engine& engine = snapshot->engine(options.categories);
+  const bool custom = !snapshot->databases.empty();
+  run_batch(count, options, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      if (custom) {
+        results[i] = snapshot->detect_custom(inputs[i], options.categories);
+        if (results[i]) {
+          continue;
+        }
+      }
+      results[i] = internal::detect_with(engine, inputs[i]);
+    }
+  });
+}
+
+}  // namespace filetype
@@ -0,0 +1,135 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_BYTE_SOURCE_HPP_
+#define SRC_BYTE_SOURCE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "filetype/byte_view.hpp"
+
+namespace filetype {
+namespace internal {
+
+/// size() of a source whose total length is not known (a stream prefix).
+constexpr uint64_t kUnknownSize = std::numeric_limits<uint64_t>::max();
+
+/**
+ * @brief Random-access input handed to container parsers.
+ *
+ * Parsers that look past the signature (ZIP directories, ...) read through
+ * this interface, so the same code works on in-memory buffers and on files
+ * read with pread(). Every read is explicit and bounded by the caller.
+ */
+class ByteSource {
+ public:
+  virtual ~ByteSource() = default;
+
+  /// Total size in bytes, or kUnknownSize.
+  virtual uint64_t size() = 0;
+
+  /**
+   * @brief Copy up to @p count bytes starting at @p offset.
+   *
+   * @return Bytes copied; fewer than @p count at the end of the data or on
+   * an I/O error.
+   */
+  virtual size_t read(uint64_t offset, uint8_t* out, size_t count) = 0;
+
+  /**
+   * @brief Hint that [offset, offset + count) is about to be read.
+   *
+   * Parsers announce reads spanning several pages, so that a memory-mapped
+   * source can fetch them in one request; other sources ignore the hint.
+   */
+  virtual void will_need(uint64_t offset, uint64_t count) {
+    (void)offset;
+    (void)count;
+  }
+};
+
+/// ByteSource over an in-memory buffer.
+class BufferSource : public ByteSource {
+ public:
+  /**
+   * @param bytes Buffer to read from.
+   * @param complete Whether @p bytes holds the whole input; a prefix of a
+   * longer stream reports kUnknownSize.
+   */
+  explicit BufferSource(ByteView bytes, bool complete = true)
+      : bytes_(bytes), complete_(complete) {}
+
+  uint64_t size() override { return complete_ ? bytes_.size() : kUnknownSize; }
+
+  size_t read(uint64_t offset, uint8_t* out, size_t count) override {
+    if (offset >= bytes_.size()) {
+      return 0;
+    }
+    const ByteView part = bytes_.subview(static_cast<size_t>(offset), count);
+    std::memcpy(out, part.data(), part.size());
+    return part.size();
+  }
+
+ private:
+  ByteView bytes_;
+  bool complete_;
+};
+
+/**
+ * @brief ByteSource over the first and last bytes of an input.
+ *
+ * Reads inside the head or the tail are served from memory; anything else
+ * is forwarded to another source, or comes back short without one.
+ */
+class SampleSource : public ByteSource {
+ public:
+  /**
+   * @param head The first bytes of the input.
+   * @param tail The last bytes of the input; may overlap @p head.
+   * @param size Size of the whole input.
+   * @param rest Source of the bytes in between, or nullptr.
+   */
+  SampleSource(ByteView head, ByteView tail, uint64_t size,
+               ByteSource* rest = nullptr)
+      : head_(head), tail_(tail), size_(size), rest_(rest) {}
+
+  uint64_t size() override { return size_; }
+
+  size_t read(uint64_t offset, uint8_t* out, size_t count) override {
+    if (offset >= size_) {
+      return 0;
+    }
+    count = static_cast<size_t>(std::min<uint64_t>(count, size_ - offset));
+    const uint64_t tail_start = size_ - tail_.size();
+    if (offset + count <= head_.size()) {
+      std::memcpy(out, head_.data() + offset, count);
+      return count;
+    }
+    if (offset >= tail_start) {
+      std::memcpy(out, tail_.data() + (offset - tail_start), count);
+      return count;
+    }
+    if (rest_ != nullptr) {
+      return rest_->read(offset, out, count);
+    }
+    // The gap is unknown: the read stops where the head does.
+    const ByteView part = head_.subview(
+        static_cast<size_t>(std::min<uint64_t>(offset, head_.size())));
+    std::memcpy(out, part.data(), part.size());
+    return part.size();
+  }
+
+ private:
+  ByteView head_;
+  ByteView tail_;
+  uint64_t size_;
+  ByteSource* rest_;
+};
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_BYTE_SOURCE_HPP_
@@ -0,0 +1,170 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/cache.hpp"
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "file.hpp"
+#include "filetype/filetype.hpp"
+#include "filetype/signature_db.hpp"
+#include "snapshot.hpp"
+
+namespace filetype {
+namespace {
+
+#if !defined(_WIN32)
+struct IdentityHash {
+  size_t operator()(const internal::FileIdentity& id) const {
+    // Inode numbers are dense and mtimes share their high bits, so mix.
+    uint64_t h = id.inode * 0x9E3779B97F4A7C15u;
+    h ^= (id.device + (h << 6) + (h >> 2)) * 0xBF58476D1CE4E5B9u;
+    h ^= (id.size + (h << 6) + (h >> 2)) * 0x94D049BB133111EBu;
+    h ^= static_cast<uint64_t>(id.mtime_ns) + (h << 6) + (h >> 2);
+    return static_cast<size_t>(h ^ (h >> 31));
+  }
+};
+#endif
+
+}  // namespace
+
+struct alignas(64) DetectionCache::Shard {
+#if !defined(_WIN32)
+  struct Entry {
+    internal::FileIdentity identity;
+    uint64_t generation;  ///< Snapshot the result was detected with.
+    DetectionResult result;
+  };
+
+  std::mutex mutex;
+  std::list<Entry> entries;  ///< Most recently used first.
+  std::unordered_map<internal::FileIdentity, std::list<Entry>::iterator,
+                     IdentityHash>
+      index;
+#else
+  std::mutex mutex;
+#endif
+  size_t capacity = 0;
+  CacheStats stats;
+};
+
+DetectionCache::DetectionCache(size_t capacity, size_t shards)
+    : shard_count_(
+          std::clamp<size_t>(shards, 1, std::max<size_t>(capacity, 1))),
+      shards_(new Shard[shard_count_]) {
+  // The first shards take the remainder, so together they hold capacity.
+  for (size_t i = 0; i < shard_count_; ++i) {
+    shards_[i].capacity =
+        capacity / shard_count_ + (i < capacity % shard_count_ ? 1 : 0);
+  }
+}
+
+DetectionCache::~DetectionCache() = default;
+
+#if defined(_WIN32)
+
+DetectionResult DetectionCache::detect_file(std::string_view path,
+                                            std::error_code& ec) {
+  DetectionResult result = filetype::detect_file(path, ec);
+  if (!ec) {
+    const std::lock_guard<std::mutex> lock(shards_[0].mutex);
+    ++shards_[0].stats.misses;
+  }
+  return result;
+}
+
+#else
+
+DetectionResult DetectionCache::detect_file(std::string_view path,
+                                            std::error_code& ec) {
+  internal::FileIdentity identity;
+  if (!internal::stat_identity(path, &identity, ec)) {
+    return ec ? DetectionResult() : filetype::detect_file(path, ec);
+  }
+  // Held until the result is stored, so a cached custom type belongs to the
+  // snapshot whose generation is stored with it.
+  const internal::SnapshotGuard snapshot;
+  Shard& shard = shards_[IdentityHash()(identity) % shard_count_];
+  {
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.index.find(identity);
+    if (it != shard.index.end() &&
+        it->second->generation == snapshot->generation) {
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      ++shard.stats.hits;
+      return it->second->result;
+    }
+    ++shard.stats.misses;
+  }
+
+  // Detect without holding the lock; racing misses on one file both read it.
+  internal::File file;
+  if (!file.open(path, ec)) {
+    return DetectionResult();
+  }
+  uint8_t head[SIGNATURE_DB_MAX_END];
+  const size_t size = file.read_at(0, head, snapshot->max_end, ec);
+  if (ec) {
+    return DetectionResult();
+  }
+  const DetectionResult result =
+      snapshot->detect_open(file, ByteView(head, size),
+                            size < snapshot->max_end, ALL_CATEGORIES, ec);
+  // A file replaced or written since the stat() above is not cached under
+  // the identity it had then.
+  internal::FileIdentity read;
+  if (ec || shard.capacity == 0 || !file.identity(&read) ||
+      !(read == identity)) {
+    return result;
+  }
+  const std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto it = shard.index.find(identity);
+  if (it != shard.index.end()) {
+    it->second->generation = snapshot->generation;
+    it->second->result = result;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return result;
+  }
+  if (shard.entries.size() >= shard.capacity) {
+    shard.index.erase(shard.entries.back().identity);
+    shard.entries.pop_back();
+    ++shard.stats.evictions;
+  }
+  shard.entries.push_front(Shard::Entry{identity, snapshot->generation,
+                                        result});
+  shard.index.emplace(identity, shard.entries.begin());
+  return result;
+}
+
+#endif
+
+CacheStats DetectionCache::stats() const {
+  CacheStats total;
+  for (size_t i = 0; i < shard_count_; ++i) {
+    Shard& shard = shards_[i];
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    total.hits += shard.stats.hits;
+    total.misses += shard.stats.misses;
+    total.evictions += shard.stats.evictions;
+#if !defined(_WIN32)
+    total.entries += shard.entries.size();
+#endif
+  }
+  return total;
+}
+
+void DetectionCache::clear() {
+  for (size_t i = 0; i < shard_count_; ++i) {
+    Shard& shard = shards_[i];
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+#if !defined(_WIN32)
+    shard.entries.clear();
+    shard.index.clear();
+#endif
+    shard.stats = CacheStats();
+  }
+}
+
+}  // namespace filetype
@@ -0,0 +1,233 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "cfb.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+#include "filetype/types/document.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+constexpr size_t kHeaderSize = 76;  // fields before the header DIFAT
+constexpr size_t kHeaderDifatEntries = 109;
+constexpr uint16_t kByteOrderMark = 0xFFFE;
+constexpr size_t kEntrySize = 128;
+
+/// Unit of directory reads: a version 3 sector, an eighth of a version 4 one.
+constexpr size_t kBlockSize = 512;
+
+/// Sector and entry numbers above this are markers (end of chain, free, ...).
+constexpr uint32_t kMaxRegularSector = 0xFFFFFFFA;
+constexpr uint32_t kNoStream = 0xFFFFFFFF;
+
+constexpr uint8_t kStreamObject = 2;
+constexpr uint8_t kRootObject = 5;
+
+uint16_t le16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | p[1] << 8);
+}
+
+uint32_t le32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+         static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+/// Directory access through the FAT, with a budget of reads.
+class Reader {
+ public:
+  explicit Reader(ByteSource& source) : source_(source) {}
+
+  /// Check the header and locate the directory.
+  bool open() {
+    uint8_t header[kHeaderSize];
+    if (source_.read(0, header, sizeof(header)) != sizeof(header) ||
+        le16(header + 28) != kByteOrderMark) {
+      return false;
+    }
+    shift_ = le16(header + 30);
+    if (shift_ != 9 && shift_ != 12) {
+      return false;
+    }
+    chain_[0] = le32(header + 48);
+    chain_length_ = 1;
+    difat_start_ = le32(header + 68);
+    return chain_[0] <= kMaxRegularSector;
+  }
+
+  /**
+   * @brief Directory entry @p id.
+   *
+   * @return Pointer to its 128 bytes, valid until the next call, or nullptr
+   * if the entry is out of reach.
+   */
+  const uint8_t* entry(uint32_t id) {
+    const size_t per_sector = sector_size() / kEntrySize;
+    uint32_t sector;
+    if (!directory_sector(id / per_sector, &sector)) {
+      return nullptr;
+    }
+    const uint64_t offset =
+        sector_offset(sector) + id % per_sector * kEntrySize;
+    const uint64_t block = offset - offset % kBlockSize;
+    if (block != block_offset_) {
+      if (!read(block, block_, kBlockSize)) {
+        return nullptr;
+      }
+      block_offset_ = block;
+    }
+    return block_ + (offset - block);
+  }
+
+ private:
+  size_t sector_size() const { return size_t{1} << shift_; }
+
+  uint64_t sector_offset(uint32_t sector) const {
+    return (uint64_t{sector} + 1) << shift_;
+  }
+
+  /// Positioned read charged against kCfbMaxSectorReads.
+  bool read(uint64_t offset, uint8_t* out, size_t count) {
+    if (reads_ == kCfbMaxSectorReads) {
+      return false;
+    }
+    ++reads_;
+    return source_.read(offset, out, count) == count;
+  }
+
+  bool read32(uint64_t offset, uint32_t* value) {
+    uint8_t bytes[4];
+    if (!read(offset, bytes, sizeof(bytes))) {
+      return false;
+    }
+    *value = le32(bytes);
+    return *value <= kMaxRegularSector;
+  }
+
+  /// Location of the @p index-th FAT sector, from the header or DIFAT chain.
+  bool fat_sector(uint32_t index, uint32_t* sector) {
+    if (index < kHeaderDifatEntries) {
+      return read32(kHeaderSize + index * 4, sector);
+    }
+    // Each DIFAT sector lists FAT sectors and ends with the next DIFAT one.
+    const uint32_t per_sector = static_cast<uint32_t>(sector_size() / 4) - 1;
+    index -= kHeaderDifatEntries;
+    uint32_t difat = difat_start_;
+    for (uint32_t hop = index / per_sector; hop > 0; --hop) {
+      if (difat > kMaxRegularSector ||
+          !read32(sector_offset(difat) + per_sector * 4, &difat)) {
+        return false;
+      }
+    }
+    return difat <= kMaxRegularSector &&
+           read32(sector_offset(difat) + index % per_sector * 4, sector);
+  }
+
+  /// Sector following @p sector in its chain.
+  bool next_sector(uint32_t sector, uint32_t* next) {
+    const uint32_t per_sector = static_cast<uint32_t>(sector_size() / 4);
+    uint32_t fat;
+    return fat_sector(sector / per_sector, &fat) &&
+           read32(sector_offset(fat) + sector % per_sector * 4, next);
+  }
+
+  /// The @p index-th sector of the directory chain, followed on demand.
+  bool directory_sector(size_t index, uint32_t* sector) {
+    if (index >= kCfbMaxDirectorySectors || chain_length_ == 0) {
+      return false;
+    }
+    while (chain_length_ <= index) {
+      if (!next_sector(chain_[chain_length_ - 1], &chain_[chain_length_])) {
+        return false;
+      }
+      ++chain_length_;
+    }
+    *sector = chain_[index];
+    return true;
+  }
+
+  ByteSource& source_;
+  size_t reads_ = 0;
+  unsigned shift_ = 0;
+  uint32_t difat_start_ = 0;
+  uint32_t chain_[kCfbMaxDirectorySectors];
+  size_t chain_length_ = 0;
+  uint64_t block_offset_ = kUnknownSize;
+  uint8_t block_[kBlockSize];
+};
+
+/// ASCII form of an entry's UTF-16 name, or empty if it is not plain ASCII.
+std::string_view entry_name(const uint8_t* entry, char* out) {
+  const size_t bytes = le16(entry + 64);  // including the terminator
+  if (bytes < 2 || bytes > 64 || bytes % 2 != 0) {
+    return {};
+  }
+  const size_t length = bytes / 2 - 1;
+  for (size_t i = 0; i < length; ++i) {
+    const uint16_t c = le16(entry + 2 * i);
+    if (c == 0 || c > 0x7F) {
+      return {};
+    }
+    out[i] = static_cast<char>(c);
+  }
+  return std::string_view(out, length);
+}
+
+/// Type a stream directly under the root stands for, if any.
+const Type* classify(std::string_view name) {
+  if (name == "WordDocument") {
+    return &document::TYPE_DOC;
+  }
+  if (name == "Workbook" || name == "Book") {
+    return &document::TYPE_XLS;
+  }
+  if (name == "PowerPoint Document") {
+    return &document::TYPE_PPT;
+  }
+  if (name.substr(0, 12) == "__substg1.0_") {
+    return &document::TYPE_MSG;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+const Type* refine_cfb(ByteSource& source) {
+  Reader reader(source);
+  if (!reader.open()) {
+    return nullptr;
+  }
+  const uint8_t* entry = reader.entry(0);
+  if (entry == nullptr || entry[66] != kRootObject) {
+    return nullptr;
+  }
+
+  // The root's children form a binary tree linked through sibling ids.
+  uint32_t pending[kCfbMaxEntries];
+  size_t top = 0;
+  pending[top++] = le32(entry + 76);
+  for (size_t visited = 0; top > 0 && visited < kCfbMaxEntries; ++visited) {
+    const uint32_t id = pending[--top];
+    if (id > kMaxRegularSector || (entry = reader.entry(id)) == nullptr) {
+      continue;
+    }
+    char name[32];
+    if (entry[66] == kStreamObject) {
+      if (const Type* type = classify(entry_name(entry, name))) {
+        return type;
+      }
+    }
+    for (const uint32_t sibling : {le32(entry + 68), le32(entry + 72)}) {
+      if (sibling != kNoStream && top < kCfbMaxEntries) {
+        pending[top++] = sibling;
+      }
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace internal
+}  // namespace filetype
@@ -0,0 +1,48 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_CFB_HPP_
+#define SRC_CFB_HPP_
+
+#include <cstddef>
+
+#include "byte_source.hpp"
+#include "engine.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+namespace internal {
+
+/// Positioned reads (FAT, DIFAT and directory lookups) one inspection may
+/// issue.
+constexpr size_t kCfbMaxSectorReads = 64;
+
+/// Directory sectors followed along the directory chain at most.
+constexpr size_t kCfbMaxDirectorySectors = 16;
+
+/// Directory entries visited at most.
+constexpr size_t kCfbMaxEntries = 64;
+
+/**
+ * @brief Tell Compound File Binary (OLE2) formats apart by their streams.
+ *
+ * Follows the header's directory sector chain through the FAT and visits the
+ * entries directly under the root storage: `WordDocument` for DOC,
+ * `Workbook` or `Book` for XLS, `PowerPoint Document` for PPT, and
+ * `__substg1.0_` property streams for Outlook MSG. Streams embedded deeper
+ * (OLE objects inside another document) are not looked at. Every read is a
+ * positioned read of at most one directory block, and the number of reads
+ * is capped by kCfbMaxSectorReads, so malformed chains cannot loop.
+ *
+ * @return The specific type, or nullptr if the root holds none of these
+ * streams or the directory is out of reach.
+ */
+const Type* refine_cfb(ByteSource& source);
+
+/// Refiner attached to the CFB signature.
+inline constexpr Refiner kCfbRefiner{&refine_cfb,
+                                     to_mask(Category::DOCUMENT)};
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_CFB_HPP_
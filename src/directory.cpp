@@ -0,0 +1,710 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/directory.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <filesystem>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include "byte_source.hpp"
+#include "file.hpp"
+#include "snapshot.hpp"
+
+namespace filetype {
+namespace {
+
+/// What a directory listing says an entry is.
+enum class Kind { FILE, DIRECTORY, LINK, OTHER, UNKNOWN };
+
+/// Directories the walk keeps open at most. Outer ancestors of deeper ones
+/// are closed and reopened when the walk returns to them.
+constexpr size_t kMaxOpenDirectories = 32;
+
+#if defined(__linux__)
+/// Bytes of entries fetched by one getdents64() call.
+constexpr size_t kListingBuffer = 16 * 1024;
+#endif
+
+#if !defined(_WIN32)
+std::error_code last_error() {
+  return std::error_code(errno, std::generic_category());
+}
+
+Kind kind_of_mode(mode_t mode) {
+  if (S_ISREG(mode)) {
+    return Kind::FILE;
+  }
+  if (S_ISDIR(mode)) {
+    return Kind::DIRECTORY;
+  }
+  return S_ISLNK(mode) ? Kind::LINK : Kind::OTHER;
+}
+
+Kind kind_of_type(unsigned char type) {
+  switch (type) {
+    case DT_REG:
+      return Kind::FILE;
+    case DT_DIR:
+      return Kind::DIRECTORY;
+    case DT_LNK:
+      return Kind::LINK;
+    case DT_UNKNOWN:
+      return Kind::UNKNOWN;
+    default:
+      return Kind::OTHER;
+  }
+}
+
+bool is_dot_or_dot_dot(const char* name) {
+  return name[0] == '.' &&
+         (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+#endif
+
+/**
+ * @brief One directory, listed an entry at a time.
+ *
+ * Subdirectories are opened relative to their parent's descriptor, so no
+ * path is resolved twice. Nothing of the listing is kept beyond one
+ * getdents64() buffer, and a suspended directory holds neither that nor a
+ * descriptor, only its place in the listing.
+ */
+class Directory {
+ public:
+  Directory() = default;
+  ~Directory();
+
+  Directory(const Directory&) = delete;
+  Directory& operator=(const Directory&) = delete;
+
+  /**
+   * @brief Open entry @p name of @p parent, or @p path without a parent.
+   *
+   * @param follow Whether a symbolic link may be opened; the root always is.
+   * @param ec Set to the errno-derived error on failure, cleared on success.
+   */
+  bool open(const Directory* parent, const char* name,
+            const std::string& path, bool follow, std::error_code& ec);
+
+  /**
+   * @brief Next entry other than `.` and `..`.
+   *
+   * @param ec Set to the errno-derived error if listing fails.
+   * @return false at the end of the listing or on error.
+   */
+  bool next(const char** name, Kind* kind, std::error_code& ec);
+
+  /// What entry @p name is according to stat(), following links if
+  /// @p follow; OTHER if it has gone.
+  Kind resolve(const char* name, bool follow) const;
+
+  /// Whether both are the same directory; only known when opened to
+  /// follow links.
+  bool same(const Directory& other) const {
+    return identified_ && other.identified_ && device_ == other.device_ &&
+           inode_ == other.inode_;
+  }
+
+  /// Whether suspend() closed the directory.
+  bool suspended() const { return suspended_; }
+
+  /// Close the directory, remembering where the listing stands.
+  void suspend();
+
+  /**
+   * @brief Reopen a suspended directory where its listing stopped.
+   *
+   * Tries the `..` of @p child first, which works however long the path
+   * has grown, then @p path. Either must lead to the directory suspended.
+   *
+   * @param child A subdirectory left open, or nullptr.
+   * @param ec Set to the errno-derived error on failure, cleared on success.
+   */
+  bool resume(const Directory* child, const std::string& path,
+              std::error_code& ec);
+
+ private:
+#if defined(_WIN32)
+  std::filesystem::path path_;
+  std::filesystem::directory_iterator it_;
+  std::string name_;
+#else
+  /// Whether the open descriptor is the directory suspended.
+  bool reopened() const;
+
+  int fd_ = -1;
+#if defined(__linux__)
+  size_t position_ = 0;
+  size_t end_ = 0;
+  int64_t offset_ = 0;  ///< Position after the last entry returned.
+  std::unique_ptr<char[]> buffer_;
+#else
+  DIR* dir_ = nullptr;
+#endif
+#endif
+#if !defined(__linux__)
+  size_t consumed_ = 0;  ///< Entries returned so far.
+#endif
+  bool identified_ = false;
+  bool suspended_ = false;
+  uint64_t device_ = 0;
+  uint64_t inode_ = 0;
+};
+
+#if defined(_WIN32)
+
+Directory::~Directory() = default;
+
+bool Directory::open(const Directory* parent, const char* name,
+                     const std::string& path, bool follow,
+                     std::error_code& ec) {
+  (void)parent;
+  (void)name;
+  (void)follow;
+  path_ = std::filesystem::u8path(path);
+  it_ = std::filesystem::directory_iterator(path_, ec);
+  return !ec;
+}
+
+bool Directory::next(const char** name, Kind* kind, std::error_code& ec) {
+  ec.clear();
+  if (it_ == std::filesystem::directory_iterator()) {
+    return false;
+  }
+  const std::filesystem::directory_entry& entry = *it_;
+  name_ = entry.path().filename().u8string();
+  std::error_code status_ec;
+  const std::filesystem::file_status status = entry.symlink_status(status_ec);
+  *kind = std::filesystem::is_symlink(status)        ? Kind::LINK
+          : std::filesystem::is_regular_file(status) ? Kind::FILE
+          : std::filesystem::is_directory(status)    ? Kind::DIRECTORY
+                                                     : Kind::OTHER;
+  *name = name_.c_str();
+  ++consumed_;
+  it_.increment(ec);
+  if (ec) {
+    it_ = std::filesystem::directory_iterator();
+  }
+  return true;
+}
+
+void Directory::suspend() {
+  it_ = std::filesystem::directory_iterator();
+  suspended_ = true;
+}
+
+bool Directory::resume(const Directory* child, const std::string& path,
+                       std::error_code& ec) {
+  (void)child;
+  (void)path;
+  it_ = std::filesystem::directory_iterator(path_, ec);
+  for (size_t i = 0; i < consumed_ && !ec &&
+                     it_ != std::filesystem::directory_iterator();
+       ++i) {
+    it_.increment(ec);
+  }
+  suspended_ = false;
+  return !ec;
+}
+
+Kind Directory::resolve(const char* name, bool follow) const {
+  std::error_code ec;
+  const std::filesystem::path entry = path_ / std::filesystem::u8path(name);
+  const std::filesystem::file_status status =
+      follow ? std::filesystem::status(entry, ec)
+             : std::filesystem::symlink_status(entry, ec);
+  return std::filesystem::is_regular_file(status) ? Kind::FILE
+         : std::filesystem::is_directory(status)  ? Kind::DIRECTORY
+                                                  : Kind::OTHER;
+}
+
+#else
+
+Directory::~Directory() {
+#if defined(__linux__)
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+#else
+  if (dir_ != nullptr) {
+    ::closedir(dir_);  // closes fd_ too
+  } else if (fd_ >= 0) {
+    ::close(fd_);
+  }
+#endif
+}
+
+bool Directory::open(const Directory* parent, const char* name,
+                     const std::string& path, bool follow,
+                     std::error_code& ec) {
+  ec.clear();
+  const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC |
+                    (parent != nullptr && !follow ? O_NOFOLLOW : 0);
+  do {
+    fd_ = parent != nullptr ? ::openat(parent->fd_, name, flags)
+                            : ::open(path.c_str(), flags);
+  } while (fd_ < 0 && errno == EINTR);
+  if (fd_ < 0) {
+    ec = last_error();
+    return false;
+  }
+  if (follow) {
+    struct stat st;
+    if (::fstat(fd_, &st) == 0) {
+      identified_ = true;
+      device_ = static_cast<uint64_t>(st.st_dev);
+      inode_ = static_cast<uint64_t>(st.st_ino);
+    }
+  }
+#if defined(__linux__)
+  buffer_.reset(new char[kListingBuffer]);
+#else
+  dir_ = ::fdopendir(fd_);
+  if (dir_ == nullptr) {
+    ec = last_error();
+    return false;
+  }
+#endif
+  return true;
+}
+
+void Directory::suspend() {
+  struct stat st;
+  if (::fstat(fd_, &st) == 0) {
+    identified_ = true;
+    device_ = static_cast<uint64_t>(st.st_dev);
+    inode_ = static_cast<uint64_t>(st.st_ino);
+  }
+#if defined(__linux__)
+  ::close(fd_);
+  buffer_.reset();
+  position_ = end_ = 0;
+#else
+  ::closedir(dir_);  // closes fd_ too
+  dir_ = nullptr;
+#endif
+  fd_ = -1;
+  suspended_ = true;
+}
+
+bool Directory::reopened() const {
+  struct stat st;
+  return ::fstat(fd_, &st) == 0 && identified_ &&
+         static_cast<uint64_t>(st.st_dev) == device_ &&
+         static_cast<uint64_t>(st.st_ino) == inode_;
+}
+
+bool Directory::resume(const Directory* child, const std::string& path,
+                       std::error_code& ec) {
+  ec.clear();
+  const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+  if (child != nullptr && child->fd_ >= 0) {
+    // A link followed into the child leads elsewhere; reopened() says so.
+    fd_ = ::openat(child->fd_, "..", flags);
+    if (fd_ >= 0 && !reopened()) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+  if (fd_ < 0) {
+    do {
+      fd_ = ::open(path.c_str(), flags);
+    } while (fd_ < 0 && errno == EINTR);
+    if (fd_ < 0) {
+      ec = last_error();
+      return false;
+    }
+    if (!reopened()) {
+      ::close(fd_);
+      fd_ = -1;
+      ec = std::make_error_code(std::errc::no_such_file_or_directory);
+      return false;
+    }
+  }
+  suspended_ = false;
+#if defined(__linux__)
+  buffer_.reset(new char[kListingBuffer]);
+  if (::lseek(fd_, static_cast<off_t>(offset_), SEEK_SET) < 0) {
+    ec = last_error();
+    return false;
+  }
+#else
+  dir_ = ::fdopendir(fd_);
+  if (dir_ == nullptr) {
+    ec = last_error();
+    return false;
+  }
+  // Positions from telldir() do not survive closedir(), so skip ahead.
+  for (size_t i = 0; i < consumed_ && ::readdir(dir_) != nullptr; ++i) {
+  }
+#endif
+  return true;
+}
+
+#if defined(__linux__)
+
+bool Directory::next(const char** name, Kind* kind, std::error_code& ec) {
+  ec.clear();
+  for (;;) {
+    if (position_ == end_) {
+      const long size =
+          ::syscall(SYS_getdents64, fd_, buffer_.get(), kListingBuffer);
+      if (size < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        ec = last_error();
+        return false;
+      }
+      if (size == 0) {
+        return false;
+      }
+      position_ = 0;
+      end_ = static_cast<size_t>(size);
+    }
+    // glibc's dirent64 has the kernel's linux_dirent64 layout.
+    const auto* entry =
+        reinterpret_cast<const struct dirent64*>(buffer_.get() + position_);
+    position_ += entry->d_reclen;
+    offset_ = entry->d_off;
+    if (!is_dot_or_dot_dot(entry->d_name)) {
+      *name = entry->d_name;
+      *kind = kind_of_type(entry->d_type);
+      return true;
+    }
+  }
+}
+
+#else
+
+bool Directory::next(const char** name, Kind* kind, std::error_code& ec) {
+  ec.clear();
+  for (;;) {
+    errno = 0;
+    const struct dirent* entry = ::readdir(dir_);
+    if (entry == nullptr) {
+      if (errno != 0) {
+        ec = last_error();
+      }
+      return false;
+    }
+    ++consumed_;
+    if (!is_dot_or_dot_dot(entry->d_name)) {
+      *name = entry->d_name;
+      *kind = kind_of_type(entry->d_type);
+      return true;
+    }
+  }
+}
+
+#endif
+
+Kind Directory::resolve(const char* name, bool follow) const {
+  struct stat st;
+  if (::fstatat(fd_, name, &st, follow ? 0 : AT_SYMLINK_NOFOLLOW) != 0) {
+    return Kind::OTHER;  // gone, or a dangling link
+  }
+  return kind_of_mode(st.st_mode);
+}
+
+#endif
+
+/// Paths waiting for the detection threads, at most a fixed number at once.
+class PathQueue {
+ public:
+  explicit PathQueue(size_t capacity)
+      : capacity_(std::max<size_t>(capacity, 1)) {}
+
+  /// Queue @p path, waiting while the queue is full.
+  void push(std::string path) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return paths_.size() < capacity_; });
+    paths_.push_back(std::move(path));
+    not_empty_.notify_one();
+  }
+
+  /// Take the oldest path; false once the queue is closed and empty.
+  bool pop(std::string* path) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return !paths_.empty() || closed_; });
+    if (paths_.empty()) {
+      return false;
+    }
+    *path = std::move(paths_.front());
+    paths_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /// No more paths are coming.
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<std::string> paths_;
+  bool closed_ = false;
+};
+
+/// Extension of the last path component without the dot, or empty.
+std::string_view extension(std::string_view name) {
+  const size_t dot = name.rfind('.');
+  return dot == std::string_view::npos || dot == 0 ? std::string_view()
+                                                   : name.substr(dot + 1);
+}
+
+std::string lower(std::string_view text) {
+  std::string out(text);
+  for (char& c : out) {
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+  }
+  return out;
+}
+
+/// Extension lists lowered and stripped of dots, as names are compared.
+std::vector<std::string> normalize(const std::vector<std::string>& list) {
+  std::vector<std::string> out;
+  for (const std::string& ext : list) {
+    out.push_back(lower(ext.size() > 0 && ext[0] == '.'
+                            ? std::string_view(ext).substr(1)
+                            : std::string_view(ext)));
+  }
+  return out;
+}
+
+/**
+ * @brief State shared by the walk and the detection threads.
+ *
+ * The threads start on construction and are joined on destruction, which
+ * closes the queue first. They are created per scan rather than drawn from
+ * the shared pool because they spend their time blocked, on the queue while
+ * the walk lists directories and on the disk while they read, and would
+ * hold up the CPU-bound work the pool is sized for.
+ */
+class DirectoryScan {
+ public:
+  DirectoryScan(const DirectorySink& sink, const DirectoryScanOptions& options)
+      : sink_(sink),
+        options_(options),
+        include_(normalize(options.include_extensions)),
+        exclude_(normalize(options.exclude_extensions)),
+        queue_(options.queue_capacity) {
+    size_t threads = options.threads;
+    if (threads == 0) {
+      threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    for (size_t i = 0; i < threads; ++i) {
+      workers_.emplace_back([this] {
+        std::string path;
+        while (queue_.pop(&path)) {
+          detect(path);
+        }
+      });
+    }
+  }
+
+  ~DirectoryScan() {
+    queue_.close();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  DirectoryScan(const DirectoryScan&) = delete;
+  DirectoryScan& operator=(const DirectoryScan&) = delete;
+
+  /// Whether a file named @p name passes the extension filters.
+  bool wanted(std::string_view name) const {
+    if (include_.empty() && exclude_.empty()) {
+      return true;
+    }
+    const std::string ext = lower(extension(name));
+    if (!include_.empty() &&
+        std::find(include_.begin(), include_.end(), ext) == include_.end()) {
+      return false;
+    }
+    return std::find(exclude_.begin(), exclude_.end(), ext) == exclude_.end();
+  }
+
+  /// Queue a file for detection, waiting while the queue is full.
+  void push(std::string path) { queue_.push(std::move(path)); }
+
+  /// Report a directory that cannot be opened or listed.
+  void report_error(std::string_view path, const std::error_code& ec) {
+    DirectoryEntry entry;
+    entry.path = path;
+    entry.ec = ec;
+    report(entry);
+  }
+
+  /// Stop the detection threads once the queue is drained.
+  size_t finish() {
+    queue_.close();
+    for (std::thread& worker : workers_) {
+      worker.join();
+    }
+    workers_.clear();
+    return reported_;
+  }
+
+ private:
+  void report(const DirectoryEntry& entry) {
+    std::lock_guard<std::mutex> lock(sink_mutex_);
+    sink_(entry);
+    ++reported_;
+  }
+
+  void detect(const std::string& path) {
+    DirectoryEntry entry;
+    entry.path = path;
+    internal::File file;
+    uint64_t size = 0;
+    if (!file.open_regular(path, &size, entry.ec)) {
+      if (entry.ec) {
+        report(entry);
+      }
+      return;  // no longer a regular file, like the others the walk skips
+    }
+    if (size < options_.min_size || size > options_.max_size) {
+      return;
+    }
+    entry.size = size;
+    uint8_t buffer[SIGNATURE_DB_MAX_END];
+    {
+      const internal::SnapshotGuard snapshot;
+      const size_t read = file.read_at(0, buffer, snapshot->max_end, entry.ec);
+      if (!entry.ec) {
+        entry.result = snapshot->detect_open(file, ByteView(buffer, read),
+                                             read == size, options_.categories,
+                                             entry.ec);
+      }
+    }
+    if (entry.ec) {
+      entry.size = 0;
+    } else if (!entry.result && !options_.include_unknown) {
+      return;
+    }
+    report(entry);
+  }
+
+  const DirectorySink& sink_;
+  const DirectoryScanOptions& options_;
+  const std::vector<std::string> include_;
+  const std::vector<std::string> exclude_;
+  PathQueue queue_;
+  std::mutex sink_mutex_;
+  size_t reported_ = 0;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace
+
+size_t scan_directory(std::string_view root, const DirectorySink& sink,
+                      std::error_code& ec,
+                      const DirectoryScanOptions& options) {
+  std::string path(root);
+  auto top = std::make_unique<Directory>();
+  if (!top->open(nullptr, nullptr, path, options.follow_symlinks, ec)) {
+    return 0;
+  }
+  if (path.empty() || path.back() != '/') {
+    path += '/';
+  }
+  DirectoryScan scan(sink, options);
+
+  // Depth first: the directories from the root down, and the length of
+  // each one's path with its trailing separator. Those above first_open are
+  // suspended; the last one left is kept to reopen its parent through.
+  std::vector<std::unique_ptr<Directory>> open;
+  std::vector<size_t> lengths;
+  size_t first_open = 0;
+  std::unique_ptr<Directory> finished;
+  open.push_back(std::move(top));
+  lengths.push_back(path.size());
+  while (!open.empty()) {
+    Directory& directory = *open.back();
+    path.resize(lengths.back());
+    std::error_code list_ec;
+    if (directory.suspended()) {
+      first_open = open.size() - 1;
+      directory.resume(finished.get(), path, list_ec);
+    }
+    finished.reset();
+    const char* name;
+    Kind kind;
+    if (list_ec || !directory.next(&name, &kind, list_ec)) {
+      if (list_ec) {
+        scan.report_error(path.substr(0, std::max<size_t>(path.size() - 1, 1)),
+                          list_ec);
+      }
+      finished = std::move(open.back());
+      open.pop_back();
+      lengths.pop_back();
+      continue;
+    }
+    if (kind == Kind::LINK && !options.follow_symlinks) {
+      continue;
+    }
+    if (kind == Kind::LINK || kind == Kind::UNKNOWN) {
+      kind = directory.resolve(name, options.follow_symlinks);
+    }
+    path += name;
+    if (kind == Kind::FILE) {
+      if (scan.wanted(name)) {
+        scan.push(path);
+      }
+    } else if (kind == Kind::DIRECTORY) {
+      auto child = std::make_unique<Directory>();
+      std::error_code open_ec;
+      if (!child->open(&directory, name, path, options.follow_symlinks,
+                       open_ec)) {
+        scan.report_error(path, open_ec);
+        continue;
+      }
+      if (options.follow_symlinks &&
+          std::any_of(open.begin(), open.end(),
+                      [&](const std::unique_ptr<Directory>& ancestor) {
+                        return ancestor->same(*child);
+                      })) {
+        continue;  // a link back up the tree
+      }
+      path += '/';
+      open.push_back(std::move(child));
+      lengths.push_back(path.size());
+      if (open.size() - first_open > kMaxOpenDirectories) {
+        open[first_open++]->suspend();
+      }
+    }
+  }
+  return scan.finish();
+}
+
+}  // namespace filetype
@@ -0,0 +1,86 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "ebml.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+#include "filetype/types/video.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+constexpr uint64_t kHeaderId = 0x1A45DFA3;
+constexpr uint64_t kDocTypeId = 0x4282;
+
+/**
+ * @brief Decode the variable-length integer at @p *pos.
+ *
+ * The number of leading zero bits of the first byte gives the number of
+ * bytes that follow. Element IDs keep that length marker, sizes drop it.
+ *
+ * @return false if the integer is malformed or runs past @p end.
+ */
+bool read_vint(const uint8_t* data, size_t end, size_t* pos, bool keep_marker,
+               uint64_t* value) {
+  if (*pos >= end || data[*pos] == 0) {
+    return false;
+  }
+  const uint8_t first = data[*pos];
+  size_t length = 1;
+  while ((first & (0x80 >> (length - 1))) == 0) {
+    ++length;
+  }
+  if (*pos + length > end) {
+    return false;
+  }
+  uint64_t v = keep_marker ? first : first & (0xFF >> length);
+  for (size_t i = 1; i < length; ++i) {
+    v = v << 8 | data[*pos + i];
+  }
+  *pos += length;
+  *value = v;
+  return true;
+}
+
+}  // namespace
+
+const Type* refine_ebml(ByteSource& source) {
+  uint8_t header[kEbmlMaxRead];
+  const size_t n = source.read(0, header, sizeof(header));
+  size_t pos = 0;
+  uint64_t id;
+  uint64_t size;
+  if (!read_vint(header, n, &pos, true, &id) || id != kHeaderId ||
+      !read_vint(header, n, &pos, false, &size)) {
+    return nullptr;
+  }
+  // An unknown or oversized header length still ends at the buffer.
+  const size_t end = size < n - pos ? pos + static_cast<size_t>(size) : n;
+
+  while (read_vint(header, end, &pos, true, &id) &&
+         read_vint(header, end, &pos, false, &size)) {
+    if (size > end - pos) {
+      return nullptr;
+    }
+    if (id == kDocTypeId) {
+      std::string_view doc_type(reinterpret_cast<const char*>(header + pos),
+                                static_cast<size_t>(size));
+      // String elements may be padded with zero bytes.
+      doc_type = doc_type.substr(0, doc_type.find('\0'));
+      if (doc_type == "webm") {
+        return &video::TYPE_WEBM;
+      }
+      if (doc_type == "matroska") {
+        return &video::TYPE_MKV;
+      }
+      return nullptr;
+    }
+    pos += static_cast<size_t>(size);
+  }
+  return nullptr;
+}
+
+}  // namespace internal
+}  // namespace filetype
@@ -0,0 +1,37 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_EBML_HPP_
+#define SRC_EBML_HPP_
+
+#include <cstddef>
+
+#include "byte_source.hpp"
+#include "engine.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+namespace internal {
+
+/// Bytes of the EBML header read at most while looking for the DocType.
+constexpr size_t kEbmlMaxRead = 64;
+
+/**
+ * @brief Tell WebM from Matroska by the DocType of the EBML header.
+ *
+ * Walks the elements of the EBML header, decoding their variable-length IDs
+ * and sizes, until the DocType element. Only the first kEbmlMaxRead bytes
+ * are looked at; real headers are about 40 bytes long.
+ *
+ * @return TYPE_WEBM for a `webm` DocType, TYPE_MKV for `matroska`, or
+ * nullptr if the DocType is missing, unknown or out of reach.
+ */
+const Type* refine_ebml(ByteSource& source);
+
+/// Refiner attached to the EBML signature.
+inline constexpr Refiner kEbmlRefiner{&refine_ebml, to_mask(Category::VIDEO),
+                                      kEbmlMaxRead};
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_EBML_HPP_
@@ -0,0 +1,260 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "engine.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "byte_source.hpp"
+#include "kernel.hpp"
+
+namespace filetype {
+namespace internal {
+
+size_t significant_bytes(const Signature& sig) {
+  if (sig.mask == nullptr) {
+    return sig.length;
+  }
+  return static_cast<size_t>(
+      std::count_if(sig.mask, sig.mask + sig.length,
+                    [](uint8_t m) { return m != 0; }));
+}
+
+bool matches(const Signature& sig, const uint8_t* data, size_t size) {
+  if (size < sig.offset + sig.length) {
+    return false;
+  }
+  const uint8_t* bytes = data + sig.offset;
+  if (sig.mask == nullptr) {
+    return std::memcmp(bytes, sig.magic, sig.length) == 0;
+  }
+  for (size_t i = 0; i < sig.length; ++i) {
+    if (((bytes[i] ^ sig.magic[i]) & sig.mask[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+
+uint8_t mask_at(const Signature& sig, size_t i) {
+  return sig.mask ? sig.mask[i] : 0xFF;
+}
+
+bool can_start_with(const Signature& sig, uint8_t byte) {
+  if (sig.offset != 0) {
+    return true;
+  }
+  const uint8_t mask = mask_at(sig, 0);
+  return ((byte ^ sig.magic[0]) & mask) == 0;
+}
+
+}  // namespace
+
+Engine::Engine(const Signature* signatures, size_t count,
+               CategoryMask categories, const TailSignature* tails,
+               size_t tail_count)
+    : categories_(categories) {
+  for (size_t i = 0; i < tail_count; ++i) {
+    if ((categories_of(tails[i]) & categories) != 0) {
+      tails_.push_back(&tails[i]);
+      tail_reach_ = std::max(tail_reach_, tails[i].reach);
+    }
+  }
+
+  // Stable sort keeps table order as the tie-breaker between equally specific
+  // signatures (e.g. ZIP before the ZIP-based document formats). Priorities
+  // only differ in compiled databases; built-in rows all use 0.
+  std::vector<const Signature*> ordered;
+  ordered.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if ((categories_of(signatures[i]) & categories) != 0) {
+      ordered.push_back(&signatures[i]);
+    }
+  }
+  std::stable_sort(ordered.begin(), ordered.end(),
+                   [](const Signature* a, const Signature* b) {
+                     if (a->priority != b->priority) {
+                       return a->priority > b->priority;
+                     }
+                     return significant_bytes(*a) > significant_bytes(*b);
+                   });
+
+  for (size_t byte = 0; byte < 256; ++byte) {
+    bucket_start_[byte] = static_cast<uint32_t>(candidates_.size());
+    for (const Signature* sig : ordered) {
+      if (!can_start_with(*sig, static_cast<uint8_t>(byte))) {
+        continue;
+      }
+      candidates_.push_back(sig);
+      ends_.push_back(sig->offset + sig->length);
+
+      // Window bytes the signature does not cover keep a zero mask, so they
+      // compare equal whatever the buffer holds there.
+      uint8_t pattern[kWindowSize] = {};
+      uint8_t mask[kWindowSize] = {};
+      for (size_t i = 0; i < sig->length; ++i) {
+        const size_t pos = sig->offset + i;
+        if (pos >= kWindowSize) {
+          break;
+        }
+        mask[pos] = mask_at(*sig, i);
+        pattern[pos] = sig->magic[i] & mask[pos];
+      }
+      patterns_.insert(patterns_.end(), pattern, pattern + kWindowSize);
+      masks_.insert(masks_.end(), mask, mask + kWindowSize);
+    }
+  }
+  bucket_start_[256] = static_cast<uint32_t>(candidates_.size());
+}
+
+const Signature* Engine::find(const uint8_t* data, size_t size) const {
+  if (size == 0) {
+    return nullptr;
+  }
+  const size_t hit = find_candidate(index(), data, size, [&](size_t i) {
+    return size >= ends_[i] &&
+           (ends_[i] <= kWindowSize || matches(*candidates_[i], data, size));
+  });
+  return hit == kNoCandidate ? nullptr : candidates_[hit];
+}
+
+const TailSignature* Engine::find_tail(ByteView tail,
+                                      size_t* position) const {
+  for (const TailSignature* sig : tails_) {
+    const size_t skip = tail.size() > sig->reach ? tail.size() - sig->reach : 0;
+    const size_t at = sig->locate(tail.subview(skip));
+    if (at != kNoCandidate) {
+      *position = skip + at;
+      return sig;
+    }
+  }
+  return nullptr;
+}
+
+const Signature* const* Engine::bucket(uint8_t first_byte,
+                                       size_t* count) const {
+  *count = bucket_start_[first_byte + 1] - bucket_start_[first_byte];
+  return candidates_.data() + bucket_start_[first_byte];
+}
+
+DetectionResult to_result(const Signature* sig) {
+  DetectionResult result;
+  if (sig != nullptr) {
+    result.type = sig->type;
+    result.categories = to_mask(sig->type->category);
+    result.offset = sig->offset;
+    result.length = sig->length;
+  }
+  return result;
+}
+
+namespace {
+
+/// Run @p refiner over @p source and keep its answer if it has one.
+DetectionResult refine(const Engine& engine, DetectionResult result,
+                       const Refiner* refiner, ByteSource& source) {
+  if (refiner == nullptr) {
+    return result;
+  }
+  if (const Type* refined = refiner->refine(source)) {
+    result.type = refined;
+    result.categories = to_mask(refined->category);
+  }
+  if (!result.in(engine.categories())) {
+    return DetectionResult();
+  }
+  return result;
+}
+
+}  // namespace
+
+DetectionResult resolve(const Engine& engine, const Signature* sig,
+                        ByteSource& source) {
+  if (sig == nullptr) {
+    return DetectionResult();
+  }
+  return refine(engine, to_result(sig), sig->refiner, source);
+}
+
+DetectionResult resolve_tail(const Engine& engine, ByteView tail,
+                             uint64_t size, ByteSource& source) {
+  size_t position = 0;
+  const TailSignature* sig = engine.find_tail(tail, &position);
+  if (sig == nullptr) {
+    return DetectionResult();
+  }
+  DetectionResult result;
+  result.type = sig->type;
+  result.categories = to_mask(sig->type->category);
+  result.offset = static_cast<size_t>(size - tail.size() + position);
+  result.length = sig->length;
+  return refine(engine, result, sig->refiner, source);
+}
+
+DetectionResult detect_with(const Engine& engine, ByteView bytes) {
+  BufferSource source(bytes);
+  return resolve(engine, engine.find(bytes.data(), bytes.size()), source);
+}
+
+DetectionResult detect_with(const Engine& engine, ByteView head, ByteView tail,
+                            uint64_t size, ByteSource& source) {
+  if (const Signature* sig = engine.find(head.data(), head.size())) {
+    return resolve(engine, sig, source);
+  }
+  const size_t reach = std::min(tail.size(), engine.tail_reach());
+  source.will_need(size - reach, reach);
+  return resolve_tail(engine, tail, size, source);
+}
+
+EngineCache::EngineCache(const Signature* signatures, size_t count,
+                         const TailSignature* tails, size_t tail_count)
+    : signatures_(signatures),
+      count_(count),
+      tails_(tails),
+      tail_count_(tail_count) {}
+
+EngineCache::~EngineCache() {
+  for (auto& slot : engines_) {
+    delete slot.load(std::memory_order_relaxed);
+  }
+}
+
+const Engine& EngineCache::get(CategoryMask categories) const {
+  std::atomic<const Engine*>& slot = engines_[categories & (kSlots - 1)];
+  const Engine* engine = slot.load(std::memory_order_acquire);
+  if (engine != nullptr) {
+    return *engine;
+  }
+  const Engine* built =
+      new Engine(signatures_, count_, categories & (kSlots - 1), tails_,
+                 tail_count_);
+  if (slot.compare_exchange_strong(engine, built, std::memory_order_acq_rel,
+                                   std::memory_order_acquire)) {
+    return *built;
+  }
+  // Another thread published its engine first; use that one.
+  delete built;
+  return *engine;
+}
+
+const EngineCache& default_engines() {
+  static const EngineCache engines = [] {
+    size_t count = 0;
+    const Signature* table = builtin_signatures(&count);
+    size_t tail_count = 0;
+    const TailSignature* tails = builtin_tail_signatures(&tail_count);
+    return EngineCache(table, count, tails, tail_count);
+  }();
+  return engines;
+}
+
+const Engine& default_engine() {
+  static const Engine& engine = default_engines().get(ALL_CATEGORIES);
+  return engine;
+}
+
+}  // namespace internal
+}  // namespace filetype
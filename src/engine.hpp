@@ -0,0 +1,353 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_ENGINE_HPP_
+#define SRC_ENGINE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "filetype/byte_view.hpp"
+#include "filetype/result.hpp"
+#include "filetype/type.hpp"
+#include "kernel.hpp"
+
+namespace filetype {
+namespace internal {
+
+class ByteSource;
+
+/**
+ * @brief Container parser run after a signature matches.
+ *
+ * Formats sharing a container magic (Office documents, EPUB and JAR inside
+ * ZIP, ...) are told apart by looking inside the container with a few
+ * bounded reads.
+ */
+struct Refiner {
+  /// Returns the more specific type, or nullptr to keep the signature's.
+  const Type* (*refine)(ByteSource& source);
+
+  /// Categories refine() can report, besides the signature type's own.
+  CategoryMask categories;
+
+  /// Leading bytes refine() reads at most, or 0 if it may read anywhere.
+  size_t reach = 0;
+};
+
+/// One row of the signature table: a magic sequence at a fixed offset.
+struct Signature {
+  const Type* type;      ///< Type reported when the signature matches.
+  const uint8_t* magic;  ///< Magic byte sequence.
+  const uint8_t* mask;   ///< Per-byte mask, or nullptr for an exact match.
+  size_t length;         ///< Length of the magic sequence.
+  size_t offset;         ///< Offset of the magic sequence in the file.
+  const Refiner* refiner = nullptr;  ///< Container parser, if any.
+  int16_t priority = 0;  ///< Higher rows are tried first, before specificity.
+};
+
+/// find_candidate() and TailSignature::locate() result when nothing
+/// matches.
+constexpr size_t kNoCandidate = ~size_t{0};
+
+/**
+ * @brief Trailer recognised at the end of a file.
+ *
+ * Some files are only reliable from their last bytes: ZIP archives behind an
+ * executable stub, MP3 streams with an ID3v1 tag but no frame sync at offset
+ * 0, PDF files with junk before the header, disk images. Tail signatures are
+ * tried when no head signature matches, on the last reach bytes of the file.
+ */
+struct TailSignature {
+  const Type* type;  ///< Type reported when the trailer is found.
+
+  /**
+   * @brief Find the trailer.
+   *
+   * @param tail The last bytes of the file: min(reach, file size) of them.
+   * @return Offset of the trailer in @p tail, or kNoCandidate.
+   */
+  size_t (*locate)(ByteView tail);
+
+  size_t length;  ///< Length of the trailer's magic.
+  size_t reach;   ///< Last bytes of the file locate() looks at.
+  const Refiner* refiner = nullptr;  ///< Container parser, if any.
+};
+
+/// Categories a signature can report, including through its refiner.
+constexpr CategoryMask categories_of(const Signature& sig) {
+  return to_mask(sig.type->category) |
+         (sig.refiner != nullptr ? sig.refiner->categories : 0);
+}
+
+/// Categories a tail signature can report, including through its refiner.
+constexpr CategoryMask categories_of(const TailSignature& sig) {
+  return to_mask(sig.type->category) |
+         (sig.refiner != nullptr ? sig.refiner->categories : 0);
+}
+
+/// Number of bytes a signature actually constrains (non-zero mask bits).
+size_t significant_bytes(const Signature& sig);
+
+/// Check a signature against a buffer, honouring its mask.
+bool matches(const Signature& sig, const uint8_t* data, size_t size);
+
+/**
+ * @brief Candidate arrays indexed by first byte, as laid out by Engine and
+ * by compiled signature databases.
+ */
+struct PrefixIndex {
+  const uint32_t* bucket_start;  ///< 257 offsets; bucket b ends at [b + 1].
+  const uint8_t* patterns;       ///< kWindowSize pre-masked bytes each.
+  const uint8_t* masks;          ///< kWindowSize mask bytes each.
+};
+
+/**
+ * @brief Walk the bucket of a buffer's first byte with the prefix kernel.
+ *
+ * @param index Candidate arrays to search.
+ * @param data Buffer containing file data; must not be empty.
+ * @param size Size of the buffer in bytes.
+ * @param verify Called with the index of each candidate whose window
+ * prefix matches, in bucket order; checks the buffer length and any bytes
+ * beyond the window.
+ * @return Index of the first candidate @p verify accepts, or kNoCandidate.
+ */
+template <typename Verify>
+size_t find_candidate(const PrefixIndex& index, const uint8_t* data,
+                      size_t size, Verify verify) {
+  // Load the window once. Short buffers are zero padded and @p verify
+  // rejects any hit that relied on the padding.
+  uint8_t window[kWindowSize] = {};
+  std::memcpy(window, data, size < kWindowSize ? size : kWindowSize);
+
+  uint32_t begin = index.bucket_start[data[0]];
+  const uint32_t end = index.bucket_start[data[0] + 1];
+  while (begin < end) {
+    const size_t batch =
+        end - begin < kMaxPrefixBatch ? end - begin : kMaxPrefixBatch;
+    uint64_t hits =
+        match_prefixes(window, index.patterns + size_t{begin} * kWindowSize,
+                       index.masks + size_t{begin} * kWindowSize, batch);
+    while (hits != 0) {
+      const size_t i = begin + lowest_bit(hits);
+      hits &= hits - 1;
+      if (verify(i)) {
+        return i;
+      }
+    }
+    begin += static_cast<uint32_t>(batch);
+  }
+  return kNoCandidate;
+}
+
+/**
+ * @brief Signature table indexed by the first byte of the buffer.
+ *
+ * Every bucket holds the signatures that can still match once the first byte
+ * is known: offset-0 signatures whose (masked) first byte agrees, plus every
+ * signature anchored at a non-zero offset. Buckets are ordered most specific
+ * signature first, so the first hit is also the best one.
+ *
+ * The part of each signature falling inside the first kWindowSize bytes is
+ * stored as a pre-masked 16-byte pattern, so a bucket is checked with one
+ * vector compare per candidate; bytes beyond the window are compared
+ * afterwards for the few signatures that need them.
+ */
+class Engine {
+ public:
+  /**
+   * @brief Index a signature table.
+   *
+   * @param signatures First row of the table.
+   * @param count Number of rows.
+   * @param categories Only rows whose type belongs to one of these categories
+   * are indexed.
+   * @param tails First row of a tail signature table, or nullptr.
+   * @param tail_count Number of rows in @p tails.
+   */
+  Engine(const Signature* signatures, size_t count,
+         CategoryMask categories = ALL_CATEGORIES,
+         const TailSignature* tails = nullptr, size_t tail_count = 0);
+
+  /**
+   * @brief Find the first signature matching a buffer.
+   *
+   * @param data Buffer containing file data.
+   * @param size Size of the buffer in bytes.
+   * @return Matching signature, or nullptr if none matches.
+   */
+  const Signature* find(const uint8_t* data, size_t size) const;
+
+  /**
+   * @brief Candidates for buffers starting with @p first_byte.
+   *
+   * @param first_byte First byte of the buffer.
+   * @param count Receives the number of candidates.
+   * @return Candidates, most specific first; find() returns the first of
+   * them that matches.
+   */
+  const Signature* const* bucket(uint8_t first_byte, size_t* count) const;
+
+  /**
+   * @brief Find the first tail signature matching the end of a file.
+   *
+   * @param tail The last bytes of the file: at least
+   * min(tail_reach(), file size) of them.
+   * @param position Receives the offset of the trailer in @p tail.
+   * @return Matching tail signature, or nullptr if none matches.
+   */
+  const TailSignature* find_tail(ByteView tail, size_t* position) const;
+
+  /// Last bytes of a file find_tail() looks at; 0 without tail signatures.
+  size_t tail_reach() const { return tail_reach_; }
+
+  /// Categories this engine was built for.
+  CategoryMask categories() const { return categories_; }
+
+  /// Candidate arrays searched by find().
+  PrefixIndex index() const {
+    return PrefixIndex{bucket_start_.data(), patterns_.data(), masks_.data()};
+  }
+
+  /// Every bucket's candidates back to back, in index() order.
+  const std::vector<const Signature*>& candidates() const {
+    return candidates_;
+  }
+
+ private:
+  CategoryMask categories_;
+  std::vector<const Signature*> candidates_;
+  std::vector<size_t> ends_;        ///< offset + length per candidate.
+  std::vector<uint8_t> patterns_;   ///< kWindowSize bytes per candidate.
+  std::vector<uint8_t> masks_;      ///< kWindowSize bytes per candidate.
+  std::array<uint32_t, 257> bucket_start_{};
+  std::vector<const TailSignature*> tails_;
+  size_t tail_reach_ = 0;
+};
+
+/// Package a matched signature (or nullptr) as a DetectionResult.
+DetectionResult to_result(const Signature* sig);
+
+/**
+ * @brief Package a hit of @p engine, running the signature's refiner.
+ *
+ * @param engine Engine that produced @p sig; a refined type outside its
+ * categories yields an empty result.
+ * @param sig Matched signature, or nullptr.
+ * @param source Whole input, read by the refiner.
+ */
+DetectionResult resolve(const Engine& engine, const Signature* sig,
+                        ByteSource& source);
+
+/// Run @p engine over a buffer and package the hit as a DetectionResult.
+DetectionResult detect_with(const Engine& engine, ByteView bytes);
+
+/**
+ * @brief Run @p engine's tail signatures and package the hit like resolve().
+ *
+ * @param tail The last bytes of the input, as find_tail() takes them.
+ * @param size Size of the whole input.
+ * @param source Whole input, read by the refiner.
+ */
+DetectionResult resolve_tail(const Engine& engine, ByteView tail,
+                             uint64_t size, ByteSource& source);
+
+/**
+ * @brief Run @p engine over the first and last bytes of an input.
+ *
+ * Head signatures are tried first, tail signatures only if none matches;
+ * the tail is announced to @p source with ByteSource::will_need() first.
+ *
+ * @param head The first bytes of the input.
+ * @param tail The last bytes of the input; may overlap @p head.
+ * @param size Size of the whole input.
+ * @param source Whole input, read by refiners.
+ */
+DetectionResult detect_with(const Engine& engine, ByteView head, ByteView tail,
+                            uint64_t size, ByteSource& source);
+
+/**
+ * @brief Engines over one table, one per category mask, built on demand.
+ *
+ * Category-filtered lookups use an engine that indexes only the requested
+ * categories, so probing skips every other signature. Engines are built the
+ * first time a mask is requested and published with a compare-and-swap;
+ * later lookups are a single atomic load.
+ */
+class EngineCache {
+ public:
+  EngineCache(const Signature* signatures, size_t count,
+              const TailSignature* tails = nullptr, size_t tail_count = 0);
+  ~EngineCache();
+
+  EngineCache(const EngineCache&) = delete;
+  EngineCache& operator=(const EngineCache&) = delete;
+
+  /// Engine indexing the signatures of the categories in @p categories.
+  const Engine& get(CategoryMask categories) const;
+
+ private:
+  static constexpr size_t kSlots = size_t{1}
+                                   << static_cast<size_t>(Category::COUNT);
+
+  const Signature* signatures_;
+  size_t count_;
+  const TailSignature* tails_;
+  size_t tail_count_;
+  mutable std::array<std::atomic<const Engine*>, kSlots> engines_{};
+};
+
+/**
+ * @brief Largest offset + length over the built-in signature table.
+ *
+ * A file prefix of this many bytes is enough to evaluate every built-in
+ * signature (TAR's "ustar" magic at offset 257 is the deepest).
+ */
+constexpr size_t kMaxSignatureEnd = 262;
+
+/**
+ * @brief Built-in signature table covering every format in filetype/types/.
+ *
+ * @param count Receives the number of rows in the table.
+ * @return Pointer to the first row.
+ */
+const Signature* builtin_signatures(size_t* count);
+
+/**
+ * @brief Largest reach over the built-in tail signature table.
+ *
+ * A file tail of this many bytes is enough to evaluate every built-in tail
+ * signature.
+ */
+constexpr size_t kMaxTailReach = 4096;
+
+/**
+ * @brief Built-in tail signature table.
+ *
+ * @param count Receives the number of rows in the table.
+ * @return Pointer to the first row.
+ */
+const TailSignature* builtin_tail_signatures(size_t* count);
+
+/**
+ * @brief Hash of the built-in signature tables and type identifiers.
+ *
+ * Changes with any row, refiner reach or category, or new TypeId, so
+ * results saved by another version of the library can be told apart.
+ */
+uint64_t builtin_fingerprint();
+
+/// Engines over the built-in signature table.
+const EngineCache& default_engines();
+
+/// Engine over the whole built-in signature table.
+const Engine& default_engine();
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_ENGINE_HPP_
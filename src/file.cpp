@@ -0,0 +1,326 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "file.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace filetype {
+namespace internal {
+namespace {
+
+/// NUL-terminated copy of a path, kept on the stack when it is short.
+class PathString {
+ public:
+  explicit PathString(std::string_view path) {
+    if (path.size() < sizeof(inline_)) {
+      std::memcpy(inline_, path.data(), path.size());
+      inline_[path.size()] = '\0';
+      str_ = inline_;
+    } else {
+      heap_.assign(path.data(), path.size());
+      str_ = heap_.c_str();
+    }
+  }
+
+  PathString(const PathString&) = delete;
+  PathString& operator=(const PathString&) = delete;
+
+  const char* c_str() const { return str_; }
+
+ private:
+  char inline_[256];
+  std::string heap_;
+  const char* str_;
+};
+
+std::error_code last_error() {
+  return std::error_code(errno, std::generic_category());
+}
+
+#if !defined(_WIN32)
+/// Fill @p identity from @p st; false unless it describes a regular file.
+bool to_identity(const struct stat& st, FileIdentity* identity) {
+  if (!S_ISREG(st.st_mode)) {
+    return false;
+  }
+#if defined(__APPLE__)
+  const struct timespec& mtime = st.st_mtimespec;
+#else
+  const struct timespec& mtime = st.st_mtim;
+#endif
+  identity->device = static_cast<uint64_t>(st.st_dev);
+  identity->inode = static_cast<uint64_t>(st.st_ino);
+  identity->size = static_cast<uint64_t>(st.st_size);
+  identity->mtime_ns = static_cast<int64_t>(mtime.tv_sec) * 1000000000 +
+                       static_cast<int64_t>(mtime.tv_nsec);
+  return true;
+}
+#endif
+
+}  // namespace
+
+#if defined(_WIN32)
+
+File::~File() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+
+bool File::open(std::string_view path, std::error_code& ec) {
+  ec.clear();
+  const PathString name(path);
+  file_ = std::fopen(name.c_str(), "rb");
+  if (file_ == nullptr) {
+    ec = last_error();
+    return false;
+  }
+  return true;
+}
+
+bool File::open_regular(std::string_view path, uint64_t* size,
+                        std::error_code& ec) {
+  if (!open(path, ec)) {
+    return false;
+  }
+  *size = this->size();
+  if (*size == kUnknownSize) {
+    std::fclose(file_);
+    file_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+size_t File::read_at(uint64_t offset, uint8_t* buffer, size_t count,
+                     std::error_code& ec) const {
+  ec.clear();
+  if (_fseeki64(file_, static_cast<__int64>(offset), SEEK_SET) != 0) {
+    ec = last_error();
+    return 0;
+  }
+  const size_t total = std::fread(buffer, 1, count, file_);
+  if (total < count && std::ferror(file_)) {
+    ec = last_error();
+  }
+  return total;
+}
+
+uint64_t File::size() const {
+  if (_fseeki64(file_, 0, SEEK_END) != 0) {
+    return kUnknownSize;
+  }
+  const __int64 end = _ftelli64(file_);
+  return end < 0 ? kUnknownSize : static_cast<uint64_t>(end);
+}
+
+FileMapping::~FileMapping() = default;
+
+bool FileMapping::open(std::string_view path, std::error_code& ec) {
+  File file;
+  if (!file.open(path, ec)) {
+    return false;
+  }
+  const uint64_t size = file.size();
+  if (size == kUnknownSize) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return false;
+  }
+  copy_.resize(static_cast<size_t>(size));
+  copy_.resize(file.read_at(0, copy_.data(), copy_.size(), ec));
+  if (ec) {
+    return false;
+  }
+  data_ = copy_.data();
+  size_ = copy_.size();
+  return true;
+}
+
+void FileMapping::advise(Access) const {}
+
+void FileMapping::will_need(uint64_t, uint64_t) const {}
+
+#else
+
+File::~File() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+bool File::open(std::string_view path, std::error_code& ec) {
+  ec.clear();
+  const PathString name(path);
+  do {
+    fd_ = ::open(name.c_str(), O_RDONLY | O_CLOEXEC);
+  } while (fd_ < 0 && errno == EINTR);
+  if (fd_ < 0) {
+    ec = last_error();
+    return false;
+  }
+  return true;
+}
+
+bool File::open_regular(std::string_view path, uint64_t* size,
+                        std::error_code& ec) {
+  ec.clear();
+  const PathString name(path);
+  do {
+    fd_ = ::open(name.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK | O_NOCTTY);
+  } while (fd_ < 0 && errno == EINTR);
+  if (fd_ < 0) {
+    ec = last_error();
+    return false;
+  }
+  struct stat st;
+  if (::fstat(fd_, &st) != 0) {
+    ec = last_error();
+  } else if (S_ISREG(st.st_mode)) {
+    *size = static_cast<uint64_t>(st.st_size);
+    return true;
+  }
+  ::close(fd_);
+  fd_ = -1;
+  return false;
+}
+
+size_t File::read_at(uint64_t offset, uint8_t* buffer, size_t count,
+                     std::error_code& ec) const {
+  ec.clear();
+  size_t total = 0;
+  while (total < count) {
+    const ssize_t n = ::pread(fd_, buffer + total, count - total,
+                              static_cast<off_t>(offset + total));
+    if (n > 0) {
+      total += static_cast<size_t>(n);
+    } else if (n == 0) {
+      break;
+    } else if (errno != EINTR) {
+      ec = last_error();
+      break;
+    }
+  }
+  return total;
+}
+
+uint64_t File::size() const {
+  struct stat st;
+  if (::fstat(fd_, &st) != 0 || !S_ISREG(st.st_mode)) {
+    return kUnknownSize;
+  }
+  return static_cast<uint64_t>(st.st_size);
+}
+
+bool File::identity(FileIdentity* identity) const {
+  struct stat st;
+  return ::fstat(fd_, &st) == 0 && to_identity(st, identity);
+}
+
+FileMapping::~FileMapping() {
+  if (size_ != 0) {
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+  }
+}
+
+bool FileMapping::open(std::string_view path, std::error_code& ec) {
+  File file;
+  if (!file.open(path, ec)) {
+    return false;
+  }
+  const uint64_t size = file.size();
+  if (size == kUnknownSize) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return false;
+  }
+  if (size == 0) {
+    return true;
+  }
+  // The mapping outlives the descriptor, which File closes.
+  void* address = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ,
+                         MAP_PRIVATE, file.fd_, 0);
+  if (address == MAP_FAILED) {
+    ec = last_error();
+    return false;
+  }
+  data_ = static_cast<const uint8_t*>(address);
+  size_ = static_cast<size_t>(size);
+  return true;
+}
+
+void FileMapping::advise(Access access) const {
+  if (size_ == 0) {
+    return;
+  }
+  int advice = POSIX_MADV_NORMAL;
+  if (access == Access::SEQUENTIAL) {
+    advice = POSIX_MADV_SEQUENTIAL;
+  } else if (access == Access::RANDOM) {
+    advice = POSIX_MADV_RANDOM;
+  }
+  // Only a hint: a kernel that ignores it still gives correct reads.
+  ::posix_madvise(const_cast<uint8_t*>(data_), size_, advice);
+}
+
+void FileMapping::will_need(uint64_t offset, uint64_t count) const {
+  if (offset >= size_ || count == 0) {
+    return;
+  }
+  static const uint64_t page = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+  const uint64_t begin = offset - offset % page;
+  const uint64_t end = offset + std::min<uint64_t>(count, size_ - offset);
+  ::posix_madvise(const_cast<uint8_t*>(data_) + begin,
+                  static_cast<size_t>(end - begin), POSIX_MADV_WILLNEED);
+}
+
+bool stat_identity(std::string_view path, FileIdentity* identity,
+                   std::error_code& ec) {
+  ec.clear();
+  const PathString name(path);
+  struct stat st;
+  if (::stat(name.c_str(), &st) != 0) {
+    ec = last_error();
+    return false;
+  }
+  return to_identity(st, identity);
+}
+
+#endif
+
+uint64_t FileSource::size() {
+  if (!size_known_) {
+    size_ = file_.size();
+    size_known_ = true;
+  }
+  return size_;
+}
+
+size_t FileSource::read(uint64_t offset, uint8_t* out, size_t count) {
+  if (offset + count <= prefix_.size()) {
+    std::memcpy(out, prefix_.data() + offset, count);
+    return count;
+  }
+  std::error_code ec;
+  return file_.read_at(offset, out, count, ec);
+}
+
+size_t read_file_prefix(std::string_view path, uint8_t* buffer,
+                        size_t capacity, std::error_code& ec) {
+  File file;
+  if (!file.open(path, ec)) {
+    return 0;
+  }
+  return file.read_at(0, buffer, capacity, ec);
+}
+
+}  // namespace internal
+}  // namespace filetype
@@ -0,0 +1,190 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_FILE_HPP_
+#define SRC_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "byte_source.hpp"
+#include "filetype/byte_view.hpp"
+#include "filetype/mapped_file.hpp"
+
+namespace filetype {
+namespace internal {
+
+/// What stat() tells about a file: enough to notice that it has changed.
+struct FileIdentity {
+  uint64_t device = 0;
+  uint64_t inode = 0;
+  uint64_t size = 0;
+  int64_t mtime_ns = 0;  ///< Modification time, nanoseconds since the epoch.
+
+  bool operator==(const FileIdentity& other) const {
+    return device == other.device && inode == other.inode &&
+           size == other.size && mtime_ns == other.mtime_ns;
+  }
+};
+
+/**
+ * @brief Read-only file handle doing positioned reads.
+ *
+ * Uses open() + pread() where available, so the only allocation is for a
+ * path too long for the on-stack copy, and nothing is written to any stream.
+ */
+class File {
+ public:
+  File() = default;
+#if !defined(_WIN32)
+  /// Take ownership of the open descriptor @p fd.
+  explicit File(int fd) : fd_(fd) {}
+#endif
+  ~File();
+
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  /**
+   * @brief Open @p path for reading.
+   *
+   * @param ec Set to the errno-derived error on failure, cleared on success.
+   * @return true on success.
+   */
+  bool open(std::string_view path, std::error_code& ec);
+
+  /**
+   * @brief Open @p path for reading only if it is a regular file.
+   *
+   * Never blocks on a FIFO or takes a controlling terminal, so it is safe on
+   * a path that may have been replaced since it was listed. The type is
+   * checked on the opened descriptor.
+   *
+   * @param size Receives the size of the file.
+   * @param ec Set to the errno-derived error on failure, cleared otherwise.
+   * @return true on success; false with @p ec clear if @p path is not a
+   * regular file.
+   */
+  bool open_regular(std::string_view path, uint64_t* size,
+                    std::error_code& ec);
+
+  /**
+   * @brief Read up to @p count bytes at @p offset.
+   *
+   * @param ec Set to the errno-derived error on failure, cleared on success.
+   * @return Bytes read; short only at end of file or on failure.
+   */
+  size_t read_at(uint64_t offset, uint8_t* buffer, size_t count,
+                 std::error_code& ec) const;
+
+  /// Size of the file in bytes, or kUnknownSize if it cannot be determined.
+  uint64_t size() const;
+
+#if !defined(_WIN32)
+  /// fstat() the file; see stat_identity().
+  bool identity(FileIdentity* identity) const;
+#endif
+
+ private:
+  friend class FileMapping;
+
+#if defined(_WIN32)
+  std::FILE* file_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+};
+
+/**
+ * @brief Read-only view of a whole file.
+ *
+ * Maps the file with mmap() where available, so opening costs no reads and
+ * pages are faulted in as they are touched; elsewhere the file is read into
+ * memory.
+ */
+class FileMapping {
+ public:
+  FileMapping() = default;
+  ~FileMapping();
+
+  FileMapping(const FileMapping&) = delete;
+  FileMapping& operator=(const FileMapping&) = delete;
+
+  /**
+   * @brief Map @p path.
+   *
+   * @param ec Set to the errno-derived error on failure, cleared on success.
+   * @return true on success; an empty file maps to an empty view.
+   */
+  bool open(std::string_view path, std::error_code& ec);
+
+  /// Mapped bytes.
+  ByteView bytes() const { return ByteView(data_, size_); }
+
+  /// Tell the kernel how the mapping is going to be read.
+  void advise(Access access) const;
+
+  /// Ask for the pages of [offset, offset + count) to be read in.
+  void will_need(uint64_t offset, uint64_t count) const;
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+#if defined(_WIN32)
+  std::vector<uint8_t> copy_;
+#endif
+};
+
+/**
+ * @brief ByteSource over an open file whose first bytes are already read.
+ *
+ * Reads inside the prefix are served from memory; anything else costs one
+ * pread(). The file size is only queried when a parser asks for it.
+ */
+class FileSource : public ByteSource {
+ public:
+  FileSource(const File& file, ByteView prefix)
+      : file_(file), prefix_(prefix) {}
+
+  uint64_t size() override;
+  size_t read(uint64_t offset, uint8_t* out, size_t count) override;
+
+ private:
+  const File& file_;
+  ByteView prefix_;
+  uint64_t size_ = 0;
+  bool size_known_ = false;
+};
+
+#if !defined(_WIN32)
+/**
+ * @brief stat() @p path.
+ *
+ * @param identity Receives the identity of a regular file.
+ * @param ec Set to the errno-derived error on failure, cleared otherwise.
+ * @return true if @p path is a regular file; false on error or, with @p ec
+ * clear, for directories, devices and pipes.
+ */
+bool stat_identity(std::string_view path, FileIdentity* identity,
+                   std::error_code& ec);
+#endif
+
+/**
+ * @brief Read the first bytes of a file into a caller-provided buffer.
+ *
+ * @param path Path to the file.
+ * @param buffer Destination buffer.
+ * @param capacity Number of bytes to read at most.
+ * @param ec Set to the errno-derived error on failure, cleared on success.
+ * @return Number of bytes read; short only at end of file or on failure.
+ */
+size_t read_file_prefix(std::string_view path, uint8_t* buffer,
+                        size_t capacity, std::error_code& ec);
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_FILE_HPP_
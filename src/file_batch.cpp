@@ -0,0 +1,517 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/file_batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+// openat and read through the ring arrived in Linux 5.6, along with this.
+#if defined(IORING_FEAT_CUR_PERSONALITY) && defined(__NR_io_uring_setup)
+#define FILETYPE_IO_URING 1
+#endif
+#endif
+#endif
+
+#include "file.hpp"
+#include "snapshot.hpp"
+#include "thread_pool.hpp"
+
+namespace filetype {
+namespace {
+
+/// Cap on the threads of the blocking fallback.
+constexpr size_t kMaxBlockingThreads = 64;
+
+/// Cap on the requests in flight on one ring.
+constexpr size_t kMaxRingEntries = 4096;
+
+/// Paths and options shared by the threads of one detect_files() call.
+struct Batch {
+  const std::string_view* paths;
+  size_t count;
+  const FileCallback& on_result;
+  CategoryMask categories;
+  std::atomic<size_t> next{0};
+};
+
+/// detect_file() on path @p index of @p batch, on this thread.
+void detect_one(const Batch& batch, size_t index) {
+  std::error_code ec;
+  DetectionResult result;
+  {
+    const internal::SnapshotGuard snapshot;
+    result = snapshot->detect_file(batch.paths[index], ec, batch.categories);
+  }
+  batch.on_result(index, result, ec);
+}
+
+/// Fallback: a thread per request in flight, each running detect_file().
+void detect_blocking(Batch* batch, size_t queue_depth) {
+  const size_t threads =
+      std::min({queue_depth, batch->count, kMaxBlockingThreads});
+  auto run = [batch](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      detect_one(*batch, i);
+    }
+  };
+  internal::parallel_for_blocking(threads, batch->count, run);
+}
+
+#if defined(FILETYPE_IO_URING)
+
+/**
+ * @brief One io_uring, set up with raw system calls.
+ *
+ * Only what detect_files() needs: entries are queued one at a time,
+ * submitted together, and reaped from the completion ring. The caller keeps
+ * no more requests in flight than the ring has entries, so neither ring can
+ * overflow.
+ */
+class Ring {
+ public:
+  Ring() = default;
+  ~Ring();
+
+  Ring(const Ring&) = delete;
+  Ring& operator=(const Ring&) = delete;
+
+  /**
+   * @brief Set up a ring of at least @p entries entries.
+   *
+   * @return false if io_uring is unavailable or cannot open and read files.
+   */
+  bool init(unsigned entries);
+
+  /// Queue a cleared submission entry and return it for filling in.
+  io_uring_sqe* queue();
+
+  /**
+   * @brief Submit the queued entries and wait for a completion.
+   *
+   * @return 0, or the errno of a failure other than an interruption or a
+   * transient shortage.
+   */
+  int submit_and_wait();
+
+  /// Wait for a completion without submitting; see submit_and_wait().
+  int wait();
+
+  /**
+   * @brief Take back the entries the kernel has not consumed.
+   *
+   * Their requests never started. The user_data of each is appended to
+   * @p ids.
+   */
+  void retract(std::vector<uint64_t>* ids);
+
+  /// Take the oldest completion; false if there is none.
+  bool pop(io_uring_cqe* cqe);
+
+ private:
+  bool supports(std::initializer_list<unsigned> opcodes) const;
+
+  int fd_ = -1;
+  unsigned queued_ = 0;
+  void* sq_map_ = MAP_FAILED;
+  size_t sq_map_size_ = 0;
+  void* cq_map_ = MAP_FAILED;
+  size_t cq_map_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_mask_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned* cq_mask_ = nullptr;
+  io_uring_cqe* cqes_ = nullptr;
+};
+
+Ring::~Ring() {
+  if (sqes_ != nullptr) {
+    ::munmap(sqes_, sqes_size_);
+  }
+  if (cq_map_ != MAP_FAILED && cq_map_ != sq_map_) {
+    ::munmap(cq_map_, cq_map_size_);
+  }
+  if (sq_map_ != MAP_FAILED) {
+    ::munmap(sq_map_, sq_map_size_);
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+bool Ring::init(unsigned entries) {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+  if (fd_ < 0) {
+    return false;  // ENOSYS, or EPERM where io_uring is disabled
+  }
+  sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_map_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_map) {
+    sq_map_size_ = cq_map_size_ = std::max(sq_map_size_, cq_map_size_);
+  }
+  sq_map_ = ::mmap(nullptr, sq_map_size_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+  if (sq_map_ == MAP_FAILED) {
+    return false;
+  }
+  cq_map_ = single_map ? sq_map_
+                       : ::mmap(nullptr, cq_map_size_, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, fd_,
+                                IORING_OFF_CQ_RING);
+  if (cq_map_ == MAP_FAILED) {
+    return false;
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  auto* sq = static_cast<uint8_t*>(sq_map_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  auto* cq = static_cast<uint8_t*>(cq_map_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  return supports({IORING_OP_OPENAT, IORING_OP_READ});
+}
+
+bool Ring::supports(std::initializer_list<unsigned> opcodes) const {
+  constexpr unsigned kProbeOps = 256;
+  // Words, so that the probe is suitably aligned.
+  std::vector<uint64_t> buffer(
+      (sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op)) /
+          sizeof(uint64_t) +
+      1);
+  auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+  if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe,
+                kProbeOps) < 0) {
+    return false;
+  }
+  for (unsigned op : opcodes) {
+    if (op > probe->last_op ||
+        (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+io_uring_sqe* Ring::queue() {
+  // Only this thread writes the tail, so it can be read back plainly.
+  const unsigned index = (*sq_tail_ + queued_) & *sq_mask_;
+  io_uring_sqe* sqe = &sqes_[index];
+  std::memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  ++queued_;
+  return sqe;
+}
+
+int Ring::submit_and_wait() {
+  // Publish the filled-in entries, then hand over every entry the kernel
+  // has not consumed yet, including any left by an interrupted call.
+  const unsigned tail = *sq_tail_ + queued_;
+  queued_ = 0;
+  __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+  const unsigned count = tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (::syscall(__NR_io_uring_enter, fd_, count, 1, IORING_ENTER_GETEVENTS,
+                nullptr, 0) >= 0) {
+    return 0;
+  }
+  const int error = errno;
+  return error == EINTR || error == EAGAIN || error == EBUSY ? 0 : error;
+}
+
+int Ring::wait() {
+  if (::syscall(__NR_io_uring_enter, fd_, 0, 1, IORING_ENTER_GETEVENTS,
+                nullptr, 0) >= 0) {
+    return 0;
+  }
+  return errno == EINTR ? 0 : errno;
+}
+
+void Ring::retract(std::vector<uint64_t>* ids) {
+  // Without SQPOLL the kernel consumes entries only inside io_uring_enter(),
+  // on this thread, so the head cannot move meanwhile.
+  const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  const unsigned tail = *sq_tail_ + queued_;
+  for (unsigned i = head; i != tail; ++i) {
+    ids->push_back(sqes_[i & *sq_mask_].user_data);
+  }
+  queued_ = 0;
+  __atomic_store_n(sq_tail_, head, __ATOMIC_RELEASE);
+}
+
+bool Ring::pop(io_uring_cqe* cqe) {
+  const unsigned head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+  *cqe = cqes_[head & *cq_mask_];
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+/// A request in flight: opening a path, then reading its first bytes.
+struct Slot {
+  bool busy = false;
+  size_t index = 0;
+  int fd = -1;  ///< Negative while the open is in flight.
+  std::string path;
+  uint8_t head[SIGNATURE_DB_MAX_END];
+};
+
+void queue_open(Ring* ring, Slot* slot, uint64_t id) {
+  io_uring_sqe* sqe = ring->queue();
+  sqe->opcode = IORING_OP_OPENAT;
+  sqe->fd = AT_FDCWD;
+  sqe->addr = reinterpret_cast<uint64_t>(slot->path.c_str());
+  sqe->open_flags = O_RDONLY | O_CLOEXEC;
+  sqe->user_data = id;
+}
+
+void queue_read(Ring* ring, Slot* slot, uint64_t id) {
+  io_uring_sqe* sqe = ring->queue();
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = slot->fd;
+  sqe->addr = reinterpret_cast<uint64_t>(slot->head);
+  sqe->len = sizeof(slot->head);
+  sqe->off = 0;
+  sqe->user_data = id;
+}
+
+/// user_data of cancellation requests, which name no slot.
+constexpr uint64_t kCancelId = ~uint64_t{0};
+
+void queue_cancel(Ring* ring, uint64_t id) {
+  io_uring_sqe* sqe = ring->queue();
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->addr = id;
+  sqe->user_data = kCancelId;
+}
+
+/// Detect the file whose first @p size bytes have arrived, and report it.
+void finish(const Batch& batch, Slot* slot, size_t size) {
+  std::error_code ec;
+  DetectionResult result;
+  {
+    const internal::File file(slot->fd);
+    const internal::SnapshotGuard snapshot;
+    // A short read normally means the end of the file, but the size is
+    // taken from the file itself should a trailer need it.
+    result = snapshot->detect_open(file, ByteView(slot->head, size), false,
+                                   batch.categories, ec);
+  }
+  slot->fd = -1;
+  batch.on_result(slot->index, result, ec);
+}
+
+/// Give up on the request of @p slot: close its file and detect it anew.
+void settle(const Batch& batch, Slot* slot) {
+  if (slot->fd >= 0) {
+    ::close(slot->fd);
+    slot->fd = -1;
+  }
+  slot->busy = false;
+  detect_one(batch, slot->index);
+}
+
+/**
+ * @brief Settle every request on @p ring after it failed to submit.
+ *
+ * Entries the kernel has not taken are withdrawn, and the rest cancelled and
+ * reaped, closing any descriptor an open returned, so that nothing is left
+ * reading into @p slots. Their paths are detected the blocking way.
+ *
+ * @return false if the ring stopped completing requests still in flight.
+ */
+bool drain(Ring* ring, std::vector<Slot>* slots, const Batch& batch) {
+  std::vector<uint64_t> withdrawn;
+  ring->retract(&withdrawn);
+  for (uint64_t id : withdrawn) {
+    if (id != kCancelId) {
+      settle(batch, &(*slots)[id]);
+    }
+  }
+  // The submission ring is empty now and has room for one per slot.
+  for (size_t id = 0; id < slots->size(); ++id) {
+    if ((*slots)[id].busy) {
+      queue_cancel(ring, id);
+    }
+  }
+  for (;;) {
+    io_uring_cqe cqe;
+    while (ring->pop(&cqe)) {
+      if (cqe.user_data == kCancelId) {
+        continue;
+      }
+      Slot& slot = (*slots)[cqe.user_data];
+      if (cqe.res >= 0 && slot.fd < 0) {
+        slot.fd = cqe.res;  // an open that completed
+      }
+      settle(batch, &slot);
+    }
+    if (std::none_of(slots->begin(), slots->end(),
+                     [](const Slot& slot) { return slot.busy; })) {
+      return true;
+    }
+    if (ring->submit_and_wait() != 0) {
+      // The cancellations did not go in either; wait for the requests.
+      withdrawn.clear();
+      ring->retract(&withdrawn);
+      if (ring->wait() != 0) {
+        return false;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Keep @p ring full with paths of @p batch until none are left.
+ *
+ * Each path costs an openat and a read through the ring; detection runs on
+ * this thread as reads complete.
+ */
+void drive(Ring* ring, std::vector<Slot>* slots, Batch* batch) {
+  std::vector<uint64_t> idle;
+  for (size_t i = slots->size(); i-- > 0;) {
+    idle.push_back(i);
+  }
+  size_t in_flight = 0;
+  for (;;) {
+    while (!idle.empty()) {
+      const size_t index = batch->next.fetch_add(1);
+      if (index >= batch->count) {
+        break;
+      }
+      const uint64_t id = idle.back();
+      idle.pop_back();
+      Slot& slot = (*slots)[id];
+      slot.busy = true;
+      slot.index = index;
+      slot.fd = -1;
+      slot.path.assign(batch->paths[index]);
+      queue_open(ring, &slot, id);
+      ++in_flight;
+    }
+    if (in_flight == 0) {
+      return;
+    }
+    if (ring->submit_and_wait() != 0) {
+      // Not expected from a working ring; this thread's paths are read the
+      // blocking way instead.
+      if (!drain(ring, slots, *batch)) {
+        // The kernel may still write into the slots, so they are leaked
+        // rather than freed.
+        for (Slot& slot : *slots) {
+          if (slot.busy) {
+            settle(*batch, &slot);
+          }
+        }
+        static_cast<void>(new std::vector<Slot>(std::move(*slots)));
+      }
+      for (size_t i = batch->next.fetch_add(1); i < batch->count;
+           i = batch->next.fetch_add(1)) {
+        detect_one(*batch, i);
+      }
+      return;
+    }
+    io_uring_cqe cqe;
+    while (ring->pop(&cqe)) {
+      Slot& slot = (*slots)[cqe.user_data];
+      if (cqe.res < 0) {
+        if (slot.fd >= 0) {
+          ::close(slot.fd);
+          slot.fd = -1;
+        }
+        batch->on_result(slot.index, DetectionResult(),
+                         std::error_code(-cqe.res, std::generic_category()));
+      } else if (slot.fd < 0) {
+        slot.fd = cqe.res;
+        queue_read(ring, &slot, cqe.user_data);
+        continue;
+      } else {
+        finish(*batch, &slot, static_cast<size_t>(cqe.res));
+      }
+      slot.busy = false;
+      idle.push_back(cqe.user_data);
+      --in_flight;
+    }
+  }
+}
+
+/// detect_files() through io_uring; false if it is unavailable.
+bool detect_uring(Batch* batch, const FileBatchOptions& options) {
+  const size_t threads =
+      std::max<size_t>(std::min(options.threads, batch->count), 1);
+  const size_t depth = std::clamp<size_t>(options.queue_depth / threads, 1,
+                                          kMaxRingEntries);
+  // Declared first, so that the slots outlive the rings reading into them.
+  std::vector<std::vector<Slot>> slots(threads);
+  std::vector<std::unique_ptr<Ring>> rings;
+  for (size_t i = 0; i < threads; ++i) {
+    rings.push_back(std::make_unique<Ring>());
+    if (!rings.back()->init(static_cast<unsigned>(depth))) {
+      return false;
+    }
+    slots[i].resize(depth);
+  }
+  // Each thread waits in its ring for completions.
+  const auto run = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      drive(rings[i].get(), &slots[i], batch);
+    }
+  };
+  internal::parallel_for_blocking(threads, threads, run);
+  return true;
+}
+
+#endif  // FILETYPE_IO_URING
+
+}  // namespace
+
+void detect_files(const std::string_view* paths, size_t count,
+                  const FileCallback& on_result,
+                  const FileBatchOptions& options) {
+  if (count == 0) {
+    return;
+  }
+  Batch batch{paths, count, on_result, options.categories};
+#if defined(FILETYPE_IO_URING)
+  if (options.use_io_uring && detect_uring(&batch, options)) {
+    return;
+  }
+#endif
+  detect_blocking(&batch, options.queue_depth);
+}
+
+}  // namespace filetype
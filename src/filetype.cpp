@@ -4,216 +4,175 @@
 
 #include <algorithm>
 #include <cstring>
-#include <fstream>
-#include <iostream>
-#include <iterator>
-#include <string>
 #include <string_view>
-#include <vector>
+#include <system_error>
 
-#include "filetype/types/archive.hpp"
-#include "filetype/types/audio.hpp"
-#include "filetype/types/document.hpp"
-#include "filetype/types/image.hpp"
-#include "filetype/types/video.hpp"
+#include "engine.hpp"
+#include "file.hpp"
+#include "snapshot.hpp"
 
 namespace filetype {
-namespace internal {
-bool match_magic(const std::vector<uint8_t>& bytes, const uint8_t* magic,
-                 size_t length, size_t offset = 0) {
-  if (bytes.size() < length + offset) {
+
+bool is_valid_buffer(ByteView bytes, size_t min_size) {
+  return bytes.size() >= min_size;
+}
+
+bool match_magic(ByteView bytes, const uint8_t* magic, size_t magic_size,
+                 size_t offset) {
+  if (bytes.size() < offset || bytes.size() - offset < magic_size) {
     return false;
   }
-  return std::memcmp(bytes.data() + offset, magic, length) == 0;
+  return std::memcmp(bytes.data() + offset, magic, magic_size) == 0;
 }
-}  // namespace internal
 
-const Type* match(const std::vector<uint8_t>& bytes) {
-  if (bytes.empty()) {
-    return nullptr;
-  }
+bool is_type(ByteView bytes, const uint8_t* magic, size_t magic_size,
+             size_t offset) {
+  return match_magic(bytes, magic, magic_size, offset);
+}
 
-  // Check image formats
-  if (internal::match_magic(bytes, image::PNG_MAGIC.data(),
-                            image::PNG_MAGIC.size())) {
-    return &image::TYPE_PNG;
-  }
-  if (internal::match_magic(bytes, image::JPEG_MAGIC.data(),
-                            image::JPEG_MAGIC.size())) {
-    return &image::TYPE_JPEG;
-  }
-  if (internal::match_magic(bytes, image::GIF_MAGIC.data(),
-                            image::GIF_MAGIC.size())) {
-    return &image::TYPE_GIF;
-  }
-  if (internal::match_magic(bytes, image::WEBP_MAGIC.data(),
-                            image::WEBP_MAGIC.size())) {
-    return &image::TYPE_WEBP;
-  }
-  if (internal::match_magic(bytes, image::CR2_MAGIC.data(),
-                            image::CR2_MAGIC.size())) {
-    return &image::TYPE_CR2;
-  }
-  if (internal::match_magic(bytes, image::TIFF_MAGIC_LE.data(),
-                            image::TIFF_MAGIC_LE.size()) ||
-      internal::match_magic(bytes, image::TIFF_MAGIC_BE.data(),
-                            image::TIFF_MAGIC_BE.size())) {
-    return &image::TYPE_TIFF;
-  }
+DetectionResult detect(ByteView bytes) {
+  return detect(bytes, ALL_CATEGORIES);
+}
 
-  // Check document formats
-  if (internal::match_magic(bytes, document::PDF_MAGIC.data(),
-                            document::PDF_MAGIC.size())) {
-    return &document::TYPE_PDF;
-  }
-  if (internal::match_magic(bytes, document::DOC_MAGIC.data(),
-                            document::DOC_MAGIC.size())) {
-    return &document::TYPE_DOC;
-  }
-  if (internal::match_magic(bytes, document::RTF_MAGIC.data(),
-                            document::RTF_MAGIC.size())) {
-    return &document::TYPE_RTF;
-  }
+DetectionResult detect(ByteView bytes, CategoryMask categories) {
+  const internal::SnapshotGuard snapshot;
+  return snapshot->detect(bytes, categories);
+}
 
-  // Check archive formats
-  if (internal::match_magic(bytes, archive::ZIP_MAGIC.data(),
-                            archive::ZIP_MAGIC.size())) {
-    return &archive::TYPE_ZIP;
-  }
-  if (internal::match_magic(bytes, archive::RAR_MAGIC.data(),
-                            archive::RAR_MAGIC.size())) {
-    return &archive::TYPE_RAR;
-  }
-  // For TAR, the magic appears at offset 257
-  if (internal::match_magic(bytes, archive::TAR_MAGIC.data(),
-                            archive::TAR_MAGIC.size(), 257)) {
-    return &archive::TYPE_TAR;
-  }
+const Type* match(ByteView bytes) { return detect(bytes).type; }
 
-  // Check audio formats
-  if (internal::match_magic(bytes, audio::MP3_MAGIC.data(),
-                            audio::MP3_MAGIC.size()) ||
-      internal::match_magic(bytes, audio::MP3_ID3_MAGIC.data(),
-                            audio::MP3_ID3_MAGIC.size())) {
-    return &audio::TYPE_MP3;
-  }
-  if (internal::match_magic(bytes, audio::WAV_MAGIC.data(),
-                            audio::WAV_MAGIC.size())) {
-    return &audio::TYPE_WAV;
-  }
+const Type* match(ByteView bytes, CategoryMask categories) {
+  return detect(bytes, categories).type;
+}
 
-  // Check video formats
-  if (internal::match_magic(bytes, video::MP4_MAGIC.data(),
-                            video::MP4_MAGIC.size())) {
-    return &video::TYPE_MP4;
-  }
-  if (internal::match_magic(bytes, video::AVI_MAGIC.data(),
-                            video::AVI_MAGIC.size())) {
-    return &video::TYPE_AVI;
-  }
+DetectionResult detect(ByteView head, ByteView tail, uint64_t size,
+                       CategoryMask categories) {
+  // Neither part can be longer than the file it was taken from.
+  size = std::max<uint64_t>({size, head.size(), tail.size()});
+  const internal::SnapshotGuard snapshot;
+  return snapshot->detect(head, tail, size, categories);
+}
 
-  return nullptr;
+const Type* match(ByteView head, ByteView tail, uint64_t size,
+                  CategoryMask categories) {
+  return detect(head, tail, size, categories).type;
 }
 
-const Type* match_file(std::string_view filepath, size_t max_read_size) {
-  std::ifstream file(std::string(filepath), std::ios::binary);
-  if (!file) {
-    std::cerr << "Error: Could not open file: " << filepath << "\n";
-    return nullptr;
+static_assert(TAIL_PROBE_SIZE == internal::kMaxTailReach,
+              "TAIL_PROBE_SIZE must cover every built-in trailer");
+
+namespace {
+
+/// Every built-in type, in TypeId order; null where there is none.
+constexpr const Type* kTypesById[] = {
+    nullptr,
+    &image::TYPE_PNG, &image::TYPE_JPEG, &image::TYPE_GIF, &image::TYPE_WEBP,
+    &image::TYPE_CR2, &image::TYPE_TIFF, &image::TYPE_BMP, &image::TYPE_JXR,
+    &image::TYPE_PSD, &image::TYPE_ICO, &image::TYPE_HEIC,
+    &document::TYPE_PDF, &document::TYPE_DOC, &document::TYPE_DOCX,
+    &document::TYPE_XLS, &document::TYPE_XLSX, &document::TYPE_PPT,
+    &document::TYPE_PPTX, &document::TYPE_ODT, &document::TYPE_ODS,
+    &document::TYPE_ODP, &document::TYPE_RTF, &document::TYPE_EPUB,
+    &archive::TYPE_ZIP, &archive::TYPE_RAR, &archive::TYPE_TAR,
+    &archive::TYPE_7Z, &archive::TYPE_GZ, &archive::TYPE_GZIP,
+    &archive::TYPE_BZ2, &archive::TYPE_BZIP2, &archive::TYPE_XZ,
+    &archive::TYPE_Z, &archive::TYPE_LZ,
+    &audio::TYPE_MP3, &audio::TYPE_WAV, &audio::TYPE_MIDI, &audio::TYPE_FLAC,
+    &audio::TYPE_AAC, &audio::TYPE_OGG, &audio::TYPE_WMA, &audio::TYPE_AIFF,
+    &audio::TYPE_M4A,
+    &video::TYPE_MP4, &video::TYPE_AVI, &video::TYPE_MKV, &video::TYPE_WEBM,
+    &video::TYPE_MOV, &video::TYPE_FLV, &video::TYPE_WMV, &video::TYPE_MPEG,
+    &video::TYPE_3GP,
+    &archive::TYPE_JAR, &archive::TYPE_APK, &document::TYPE_MSG,
+    &image::TYPE_AVIF, &image::TYPE_CR3,
+    nullptr,  // CUSTOM
+    &document::TYPE_TXT, &archive::TYPE_DMG,
+};
+
+constexpr bool types_by_id_match() {
+  for (size_t i = 0; i < sizeof(kTypesById) / sizeof(kTypesById[0]); ++i) {
+    // Null slots are skipped by index: comparing an address with nullptr is
+    // not a constant expression under sanitizers.
+    if (i != static_cast<size_t>(TypeId::UNKNOWN) &&
+        i != static_cast<size_t>(TypeId::CUSTOM) &&
+        static_cast<size_t>(kTypesById[i]->id) != i) {
+      return false;
+    }
   }
-  std::vector<uint8_t> buffer(max_read_size);
-  file.read(reinterpret_cast<char*>(buffer.data()), max_read_size);
-  buffer.resize(static_cast<size_t>(file.gcount()));
-  return match(buffer);
+  return true;
 }
 
-bool is(const std::vector<uint8_t>& bytes, const Type& type) {
-  const Type* detected = match(bytes);
-  if (!detected) return false;
-  return std::string_view(detected->mime) == type.mime &&
-         std::string_view(detected->extension) == type.extension;
-}
-
-bool is_image(const std::vector<uint8_t>& bytes) {
-  const Type* type = match(bytes);
-  if (!type) return false;
-  std::string_view mime(type->mime);
-  if (mime.size() < 6) return false;
-  return mime.substr(0, 6) == "image/";
-}
-
-bool is_document(const std::vector<uint8_t>& bytes) {
-  const Type* type = match(bytes);
-  if (!type) return false;
-  std::string_view mime(type->mime);
-  if (mime.size() < 12) return false;
-  if (mime.substr(0, 12) != "application/") return false;
-  if (mime.size() >= 14 && mime.substr(0, 14) == "application/x-") return false;
-  return true;
+static_assert(sizeof(kTypesById) / sizeof(kTypesById[0]) ==
+                  static_cast<size_t>(TypeId::COUNT),
+              "every TypeId needs an entry");
+static_assert(types_by_id_match(), "kTypesById is out of TypeId order");
+
+}  // namespace
+
+const Type* type_from_id(TypeId id) {
+  const size_t index = static_cast<size_t>(id);
+  return index < static_cast<size_t>(TypeId::COUNT) ? kTypesById[index]
+                                                    : nullptr;
 }
 
-bool is_archive(const std::vector<uint8_t>& bytes) {
-  const Type* type = match(bytes);
-  if (!type) return false;
-  std::string_view mime(type->mime);
-  if (mime.size() < 14) return false;
-  return mime.substr(0, 14) == "application/x-" || mime == "application/zip";
+DetectionResult detect_file(std::string_view filepath, std::error_code& ec) {
+  const internal::SnapshotGuard snapshot;
+  return snapshot->detect_file(filepath, ec);
 }
 
-bool is_audio(const std::vector<uint8_t>& bytes) {
-  const Type* type = match(bytes);
-  if (!type) return false;
-  std::string_view mime(type->mime);
-  if (mime.size() < 6) return false;
-  return mime.substr(0, 6) == "audio/";
+const Type* match_file(std::string_view filepath, std::error_code& ec) {
+  return detect_file(filepath, ec).type;
 }
 
-bool is_video(const std::vector<uint8_t>& bytes) {
-  const Type* type = match(bytes);
-  if (!type) return false;
-  std::string_view mime(type->mime);
-  if (mime.size() < 6) return false;
-  return mime.substr(0, 6) == "video/";
+const Type* match_file(std::string_view filepath, size_t max_read_size) {
+  std::error_code ec;
+  if (max_read_size >= internal::kMaxSignatureEnd) {
+    return detect_file(filepath, ec).type;
+  }
+  uint8_t buffer[internal::kMaxSignatureEnd];
+  const size_t size =
+      internal::read_file_prefix(filepath, buffer, max_read_size, ec);
+  if (ec) {
+    return nullptr;
+  }
+  return match(ByteView(buffer, size));
 }
 
-template <typename Predicate>
-const Type* match_if(const std::vector<uint8_t>& bytes, Predicate pred) {
-  const Type* t = match(bytes);
-  return (t && pred(std::string_view(t->mime))) ? t : nullptr;
+bool is(ByteView bytes, const Type& type) {
+  const Type* detected = match(bytes);
+  return detected != nullptr && *detected == type;
 }
 
+bool is_image(ByteView bytes) { return detect(bytes).is_image(); }
+
+bool is_document(ByteView bytes) { return detect(bytes).is_document(); }
+
+bool is_archive(ByteView bytes) { return detect(bytes).is_archive(); }
+
+bool is_audio(ByteView bytes) { return detect(bytes).is_audio(); }
+
+bool is_video(ByteView bytes) { return detect(bytes).is_video(); }
+
 namespace matcher {
 
-const Type* match_image(const std::vector<uint8_t>& bytes) {
-  return match_if(bytes, [](std::string_view mime) {
-    return mime.size() >= 6 && mime.substr(0, 6) == "image/";
-  });
+const Type* match_image(ByteView bytes) {
+  return match(bytes, to_mask(Category::IMAGE));
 }
 
-const Type* match_document(const std::vector<uint8_t>& bytes) {
-  return match_if(bytes, [](std::string_view mime) {
-    return mime.size() >= 12 && mime.substr(0, 12) == "application/" &&
-           (mime.size() < 14 || mime.substr(0, 14) != "application/x-");
-  });
+const Type* match_document(ByteView bytes) {
+  return match(bytes, to_mask(Category::DOCUMENT));
 }
 
-const Type* match_archive(const std::vector<uint8_t>& bytes) {
-  return match_if(bytes, [](std::string_view mime) {
-    return (mime.size() >= 14 && mime.substr(0, 14) == "application/x-") ||
-           mime == "application/zip";
-  });
+const Type* match_archive(ByteView bytes) {
+  return match(bytes, to_mask(Category::ARCHIVE));
 }
 
-const Type* match_audio(const std::vector<uint8_t>& bytes) {
-  return match_if(bytes, [](std::string_view mime) {
-    return mime.size() >= 6 && mime.substr(0, 6) == "audio/";
-  });
+const Type* match_audio(ByteView bytes) {
+  return match(bytes, to_mask(Category::AUDIO));
 }
 
-const Type* match_video(const std::vector<uint8_t>& bytes) {
-  return match_if(bytes, [](std::string_view mime) {
-    return mime.size() >= 6 && mime.substr(0, 6) == "video/";
-  });
+const Type* match_video(ByteView bytes) {
+  return match(bytes, to_mask(Category::VIDEO));
 }
 
 }  // namespace matcher
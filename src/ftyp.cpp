@@ -0,0 +1,133 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "ftyp.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "filetype/types/audio.hpp"
+#include "filetype/types/image.hpp"
+#include "filetype/types/video.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+constexpr size_t kHeaderSize = 16;  // size, "ftyp", major brand, version
+
+constexpr uint32_t fourcc(const char (&code)[5]) {
+  return static_cast<uint32_t>(static_cast<uint8_t>(code[0])) << 24 |
+         static_cast<uint32_t>(static_cast<uint8_t>(code[1])) << 16 |
+         static_cast<uint32_t>(static_cast<uint8_t>(code[2])) << 8 |
+         static_cast<uint32_t>(static_cast<uint8_t>(code[3]));
+}
+
+uint32_t be32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) << 24 |
+         static_cast<uint32_t>(p[1]) << 16 |
+         static_cast<uint32_t>(p[2]) << 8 | static_cast<uint32_t>(p[3]);
+}
+
+/// One row of the brand table.
+struct Brand {
+  uint32_t code;
+  const Type* type;
+  bool generic;  ///< Shared by several formats; a specific brand overrides it.
+};
+
+constexpr Brand brand(const char (&code)[5], const Type& type,
+                      bool generic = false) {
+  return Brand{fourcc(code), &type, generic};
+}
+
+// Brands registered with the MP4 registration authority, most common first.
+constexpr Brand kBrands[] = {
+    // Generic ISO base media and MP4 brands
+    brand("isom", video::TYPE_MP4, true),
+    brand("mp42", video::TYPE_MP4, true),
+    brand("mp41", video::TYPE_MP4, true),
+    brand("iso2", video::TYPE_MP4, true),
+    brand("iso4", video::TYPE_MP4, true),
+    brand("iso5", video::TYPE_MP4, true),
+    brand("iso6", video::TYPE_MP4, true),
+    brand("avc1", video::TYPE_MP4, true),
+    brand("dash", video::TYPE_MP4),
+    brand("M4V ", video::TYPE_MP4),
+    brand("M4VH", video::TYPE_MP4),
+    brand("M4VP", video::TYPE_MP4),
+    brand("f4v ", video::TYPE_MP4),
+    brand("mmp4", video::TYPE_MP4),
+
+    // Audio-only MP4
+    brand("M4A ", audio::TYPE_M4A),
+    brand("M4B ", audio::TYPE_M4A),
+    brand("M4P ", audio::TYPE_M4A),
+    brand("F4A ", audio::TYPE_M4A),
+
+    // QuickTime
+    brand("qt  ", video::TYPE_MOV),
+
+    // 3GPP and 3GPP2
+    brand("3gp4", video::TYPE_3GP),
+    brand("3gp5", video::TYPE_3GP),
+    brand("3gp6", video::TYPE_3GP),
+    brand("3gp7", video::TYPE_3GP),
+    brand("3gs7", video::TYPE_3GP),
+    brand("3ge6", video::TYPE_3GP),
+    brand("3ge7", video::TYPE_3GP),
+    brand("3gg6", video::TYPE_3GP),
+    brand("3g2a", video::TYPE_3GP),
+    brand("3g2b", video::TYPE_3GP),
+    brand("3g2c", video::TYPE_3GP),
+
+    // HEIF images; mif1/msf1 only say "HEIF", the codec brand follows
+    brand("mif1", image::TYPE_HEIC, true),
+    brand("msf1", image::TYPE_HEIC, true),
+    brand("heic", image::TYPE_HEIC),
+    brand("heix", image::TYPE_HEIC),
+    brand("heim", image::TYPE_HEIC),
+    brand("heis", image::TYPE_HEIC),
+    brand("hevc", image::TYPE_HEIC),
+    brand("hevx", image::TYPE_HEIC),
+    brand("avif", image::TYPE_AVIF),
+    brand("avis", image::TYPE_AVIF),
+
+    // Canon raw
+    brand("crx ", image::TYPE_CR3),
+};
+
+const Brand* find_brand(uint32_t code) {
+  const Brand* end = std::end(kBrands);
+  const Brand* it = std::find_if(
+      std::begin(kBrands), end,
+      [code](const Brand& row) { return row.code == code; });
+  return it == end ? nullptr : it;
+}
+
+}  // namespace
+
+const Type* refine_ftyp(ByteSource& source) {
+  uint8_t box[kFtypMaxRead];
+  const size_t n = source.read(0, box, sizeof(box));
+  if (n < 12) {
+    return nullptr;
+  }
+  // Compatible brands run to the end of the box, as far as it was read.
+  const size_t box_size = be32(box);
+  const size_t end = box_size < kHeaderSize ? 12 : std::min(box_size, n);
+
+  const Brand* best = find_brand(be32(box + 8));
+  for (size_t at = kHeaderSize; at + 4 <= end; at += 4) {
+    if (best != nullptr && !best->generic) {
+      break;
+    }
+    const Brand* row = find_brand(be32(box + at));
+    if (row != nullptr && (best == nullptr || !row->generic)) {
+      best = row;
+    }
+  }
+  return best == nullptr ? nullptr : best->type;
+}
+
+}  // namespace internal
+}  // namespace filetype
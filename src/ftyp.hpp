@@ -0,0 +1,40 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_FTYP_HPP_
+#define SRC_FTYP_HPP_
+
+#include <cstddef>
+
+#include "byte_source.hpp"
+#include "engine.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+namespace internal {
+
+/// Bytes of the `ftyp` box read at most: the header and 60 compatible brands.
+constexpr size_t kFtypMaxRead = 256;
+
+/**
+ * @brief Tell ISO base media formats apart by the brands of their `ftyp` box.
+ *
+ * Reads the box once and looks its major brand, then its compatible brands,
+ * up in a brand table. A brand naming one format (`heic`, `avif`, `M4A `,
+ * `qt  `, `3gp4`, `crx `, ...) decides; generic brands (`isom`, `mp42`,
+ * `mif1`, ...) only count if no specific brand follows.
+ *
+ * @return The specific type, or nullptr if no brand is known.
+ */
+const Type* refine_ftyp(ByteSource& source);
+
+/// Refiner attached to the `ftyp` signature.
+inline constexpr Refiner kFtypRefiner{
+    &refine_ftyp,
+    to_mask(Category::IMAGE) | to_mask(Category::AUDIO) |
+        to_mask(Category::VIDEO),
+    kFtypMaxRead};
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_FTYP_HPP_
@@ -0,0 +1,469 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/index.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "engine.hpp"
+#include "file.hpp"
+#include "filetype/filetype.hpp"
+#include "snapshot.hpp"
+
+namespace filetype {
+namespace internal {
+
+//------------------------------------------------------------------------------
+// Index layout
+//
+// The header, the fan-out table (1 << fanout_bits entries; entry b counts
+// the records whose hash has top bits <= b) and the records sorted by path
+// hash, all little-endian and 16-byte aligned.
+//------------------------------------------------------------------------------
+
+/// One indexed file.
+struct IndexRecord {
+  uint64_t path_hash;
+  uint64_t device;
+  uint64_t inode;
+  uint64_t size;
+  int64_t mtime_ns;
+  uint32_t generation;  ///< Commit in which the file was last seen.
+  uint16_t type;        ///< TypeId.
+  uint16_t reserved;
+};
+
+namespace {
+
+constexpr char kIndexMagic[8] = {'F', 'T', 'I', 'N', 'D', 'E', 'X', '\0'};
+constexpr uint32_t kIndexVersion = 1;
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr uint32_t kMaxFanoutBits = 20;
+
+struct IndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;  ///< kByteOrder as written by the host.
+  uint64_t total_size;
+  uint64_t record_count;
+  uint64_t fanout;  ///< Section offsets from the start of the file.
+  uint64_t records;
+  uint32_t fanout_bits;
+  uint32_t generation;
+  uint64_t fingerprint;  ///< builtin_fingerprint() of the writer.
+};
+
+static_assert(std::is_trivially_copyable_v<IndexHeader> &&
+                  std::is_trivially_copyable_v<IndexRecord>,
+              "index records are copied byte for byte");
+static_assert(sizeof(IndexHeader) == 64 && sizeof(IndexRecord) == 48,
+              "index records must not contain padding");
+
+/// FNV-1a: stable across platforms and standard libraries, unlike
+/// std::hash.
+uint64_t hash_path(std::string_view path) {
+  uint64_t hash = 0xCBF29CE484222325u;
+  for (char c : path) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3u;
+  }
+  return hash;
+}
+
+/// Fan-out bits for @p count records: about 16 records per bucket.
+uint32_t fanout_bits_for(uint64_t count) {
+  uint32_t bits = 0;
+  while (bits < kMaxFanoutBits && (count >> (bits + 4)) != 0) {
+    ++bits;
+  }
+  return bits;
+}
+
+size_t bucket_of(uint64_t hash, uint32_t bits) {
+  return bits == 0 ? 0 : static_cast<size_t>(hash >> (64 - bits));
+}
+
+/// stat_identity() where inode numbers exist; elsewhere nothing is indexed.
+bool identify(std::string_view path, FileIdentity* identity,
+              std::error_code& ec) {
+#if defined(_WIN32)
+  (void)path;
+  (void)identity;
+  ec.clear();
+  return false;
+#else
+  return stat_identity(path, identity, ec);
+#endif
+}
+
+bool same_file(const IndexRecord& record, const FileIdentity& identity) {
+  return record.device == identity.device && record.inode == identity.inode &&
+         record.size == identity.size && record.mtime_ns == identity.mtime_ns;
+}
+
+bool hash_less(const IndexRecord& a, const IndexRecord& b) {
+  return a.path_hash < b.path_hash;
+}
+
+std::error_code last_error() {
+  return std::error_code(errno, std::generic_category());
+}
+
+/// Buffered writer of an index file.
+class IndexFile {
+ public:
+  ~IndexFile() {
+    if (file_ != nullptr) {
+      std::fclose(file_);
+    }
+  }
+
+  bool open(const std::string& path, std::error_code& ec) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+      ec = last_error();
+      return false;
+    }
+    return true;
+  }
+
+  bool write(const void* data, size_t size, std::error_code& ec) {
+    if (std::fwrite(data, 1, size, file_) != size) {
+      ec = last_error();
+      return false;
+    }
+    return true;
+  }
+
+  /// Flush what is buffered and force it to stable storage.
+  bool sync(std::error_code& ec) {
+    if (std::fflush(file_) != 0) {
+      ec = last_error();
+      return false;
+    }
+#if !defined(_WIN32)
+    if (::fsync(::fileno(file_)) != 0) {
+      ec = last_error();
+      return false;
+    }
+#endif
+    return true;
+  }
+
+  bool close(std::error_code& ec) {
+    std::FILE* file = file_;
+    file_ = nullptr;
+    if (std::fclose(file) != 0) {
+      ec = last_error();
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  std::FILE* file_ = nullptr;
+};
+
+/// Make a rename into the directory holding @p path survive a crash.
+bool sync_directory(const std::string& path, std::error_code& ec) {
+#if defined(_WIN32)
+  (void)path;
+  (void)ec;
+  return true;
+#else
+  const size_t slash = path.find_last_of('/');
+  std::string directory = ".";
+  if (slash != std::string::npos) {
+    directory = slash == 0 ? "/" : path.substr(0, slash);
+  }
+  const int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    ec = last_error();
+    return false;
+  }
+  // Some file systems cannot sync a directory and need not.
+  const bool ok = ::fsync(fd) == 0 || errno == EINVAL;
+  if (!ok) {
+    ec = last_error();
+  }
+  ::close(fd);
+  return ok;
+#endif
+}
+
+}  // namespace
+}  // namespace internal
+
+DetectionIndex::DetectionIndex() = default;
+
+DetectionIndex::~DetectionIndex() = default;
+
+std::shared_ptr<const DetectionIndex> DetectionIndex::open(
+    std::string_view path, std::error_code& ec) {
+  auto mapping = std::make_unique<internal::FileMapping>();
+  if (!mapping->open(path, ec)) {
+    return nullptr;
+  }
+  // Lookups touch a fan-out entry and a few records each.
+  mapping->advise(Access::RANDOM);
+  std::shared_ptr<DetectionIndex> index(new DetectionIndex());
+  if (!index->attach(mapping->bytes())) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return nullptr;
+  }
+  index->mapping_ = std::move(mapping);
+  return index;
+}
+
+bool DetectionIndex::attach(ByteView image) {
+  using internal::IndexHeader;
+  using internal::IndexRecord;
+  IndexHeader header;
+  if (image.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, image.data(), sizeof(header));
+  if (std::memcmp(header.magic, internal::kIndexMagic,
+                  sizeof(header.magic)) != 0 ||
+      header.version != internal::kIndexVersion ||
+      header.byte_order != internal::kByteOrder ||
+      header.total_size != image.size() ||
+      header.fanout_bits > internal::kMaxFanoutBits) {
+    return false;
+  }
+  const uint64_t buckets = uint64_t{1} << header.fanout_bits;
+  const auto fits = [&](uint64_t offset, uint64_t count, uint64_t size) {
+    return offset % 16 == 0 && offset <= image.size() &&
+           count <= (image.size() - offset) / size;
+  };
+  if (!fits(header.fanout, buckets, sizeof(uint32_t)) ||
+      !fits(header.records, header.record_count, sizeof(IndexRecord))) {
+    return false;
+  }
+  fanout_ = reinterpret_cast<const uint32_t*>(image.data() + header.fanout);
+  // A non-decreasing fan-out ending at the record count keeps every search
+  // inside the table.
+  uint32_t previous = 0;
+  for (uint64_t b = 0; b < buckets; ++b) {
+    if (fanout_[b] < previous) {
+      return false;
+    }
+    previous = fanout_[b];
+  }
+  if (previous != header.record_count) {
+    return false;
+  }
+  records_ =
+      reinterpret_cast<const IndexRecord*>(image.data() + header.records);
+  count_ = static_cast<size_t>(header.record_count);
+  fanout_bits_ = header.fanout_bits;
+  generation_ = header.generation;
+  current_ = header.fingerprint == internal::builtin_fingerprint();
+  return true;
+}
+
+const internal::IndexRecord* DetectionIndex::find(
+    uint64_t hash, const internal::FileIdentity& identity) const {
+  // Results of other signature tables, or that registered signatures may
+  // override, do not count.
+  if (!current_ || !internal::SnapshotGuard()->databases.empty()) {
+    return nullptr;
+  }
+  const size_t bucket = internal::bucket_of(hash, fanout_bits_);
+  const internal::IndexRecord* first =
+      records_ + (bucket == 0 ? 0 : fanout_[bucket - 1]);
+  const internal::IndexRecord* last = records_ + fanout_[bucket];
+  internal::IndexRecord key{};
+  key.path_hash = hash;
+  const internal::IndexRecord* it =
+      std::lower_bound(first, last, key, internal::hash_less);
+  return it != last && it->path_hash == hash &&
+                 internal::same_file(*it, identity)
+             ? it
+             : nullptr;
+}
+
+bool DetectionIndex::find(std::string_view path, const Type** type,
+                          std::error_code& ec) const {
+  internal::FileIdentity identity;
+  if (!internal::identify(path, &identity, ec)) {
+    return false;
+  }
+  const internal::IndexRecord* record =
+      find(internal::hash_path(path), identity);
+  if (record == nullptr) {
+    return false;
+  }
+  *type = type_from_id(static_cast<TypeId>(record->type));
+  return true;
+}
+
+struct alignas(64) IndexWriter::Shard {
+  std::mutex mutex;
+  std::vector<internal::IndexRecord> records;
+};
+
+/// Shards of records; workers seldom wait for one another.
+constexpr size_t kWriterShards = 16;
+
+IndexWriter::IndexWriter(std::shared_ptr<const DetectionIndex> base)
+    : base_(std::move(base)),
+      generation_(base_ ? base_->generation() + 1 : 1),
+      shards_(new Shard[kWriterShards]) {}
+
+IndexWriter::~IndexWriter() = default;
+
+const Type* IndexWriter::match_file(std::string_view path,
+                                    std::error_code& ec) {
+  internal::FileIdentity identity;
+  if (!internal::identify(path, &identity, ec)) {
+    return ec ? nullptr : filetype::match_file(path, ec);
+  }
+  const uint64_t hash = internal::hash_path(path);
+  const internal::IndexRecord* known =
+      base_ ? base_->find(hash, identity) : nullptr;
+  const Type* type = nullptr;
+  if (known != nullptr) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    type = type_from_id(static_cast<TypeId>(known->type));
+  } else {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    type = filetype::match_file(path, ec);
+    if (ec || (type != nullptr && type->id == TypeId::CUSTOM)) {
+      return type;
+    }
+  }
+
+  internal::IndexRecord record{};
+  record.path_hash = hash;
+  record.device = identity.device;
+  record.inode = identity.inode;
+  record.size = identity.size;
+  record.mtime_ns = identity.mtime_ns;
+  record.generation = generation_;
+  record.type = static_cast<uint16_t>(type ? type->id : TypeId::UNKNOWN);
+  Shard& shard = shards_[hash % kWriterShards];
+  const std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.records.push_back(record);
+  return type;
+}
+
+bool IndexWriter::commit(std::string_view path, std::error_code& ec,
+                         const IndexCommitOptions& options) {
+  using internal::IndexRecord;
+  ec.clear();
+
+  // This scan's records, one per path: the newest if a file was seen twice.
+  std::vector<IndexRecord> seen;
+  for (size_t i = 0; i < kWriterShards; ++i) {
+    const std::lock_guard<std::mutex> lock(shards_[i].mutex);
+    seen.insert(seen.end(), shards_[i].records.begin(),
+                shards_[i].records.end());
+  }
+  std::sort(seen.begin(), seen.end(),
+            [](const IndexRecord& a, const IndexRecord& b) {
+              return a.path_hash != b.path_hash ? a.path_hash < b.path_hash
+                                                : a.mtime_ns > b.mtime_ns;
+            });
+  seen.erase(std::unique(seen.begin(), seen.end(),
+                         [](const IndexRecord& a, const IndexRecord& b) {
+                           return a.path_hash == b.path_hash;
+                         }),
+             seen.end());
+
+  // Merge with the base, which is streamed twice from its mapping: once to
+  // size the fan-out, once to write.
+  // A base written with other built-in signatures contributes nothing.
+  const bool merge_base = base_ && base_->current_;
+  const IndexRecord* base = merge_base ? base_->records_ : nullptr;
+  const size_t base_count = merge_base ? base_->size() : 0;
+  const auto merge = [&](const auto& emit) {
+    size_t i = 0;
+    size_t j = 0;
+    while (i < seen.size() || j < base_count) {
+      if (j == base_count ||
+          (i < seen.size() && seen[i].path_hash <= base[j].path_hash)) {
+        // A file seen in this scan supersedes its old entry.
+        if (j < base_count && base[j].path_hash == seen[i].path_hash) {
+          ++j;
+        }
+        emit(seen[i++]);
+      } else {
+        if (generation_ - base[j].generation <= options.keep_unseen) {
+          emit(base[j]);
+        }
+        ++j;
+      }
+    }
+  };
+
+  uint64_t count = 0;
+  merge([&](const IndexRecord&) { ++count; });
+  const uint32_t bits = internal::fanout_bits_for(count);
+  std::vector<uint32_t> fanout(size_t{1} << bits, 0);
+  merge([&](const IndexRecord& record) {
+    ++fanout[internal::bucket_of(record.path_hash, bits)];
+  });
+  for (size_t b = 1; b < fanout.size(); ++b) {
+    fanout[b] += fanout[b - 1];
+  }
+
+  internal::IndexHeader header{};
+  std::memcpy(header.magic, internal::kIndexMagic, sizeof(header.magic));
+  header.version = internal::kIndexVersion;
+  header.byte_order = internal::kByteOrder;
+  header.record_count = count;
+  header.fanout = sizeof(header);
+  const uint64_t fanout_bytes = fanout.size() * sizeof(uint32_t);
+  header.records = (header.fanout + fanout_bytes + 15) & ~uint64_t{15};
+  header.total_size = header.records + count * sizeof(IndexRecord);
+  header.fanout_bits = bits;
+  header.generation = generation_;
+  header.fingerprint = internal::builtin_fingerprint();
+
+  const std::string target(path);
+  const std::string temporary = target + ".tmp";
+  internal::IndexFile file;
+  if (!file.open(temporary, ec)) {
+    return false;
+  }
+  static constexpr uint8_t kPadding[16] = {};
+  bool ok = file.write(&header, sizeof(header), ec) &&
+            file.write(fanout.data(), fanout_bytes, ec) &&
+            file.write(kPadding,
+                       header.records - header.fanout - fanout_bytes, ec);
+  // Records go out in batches to keep the writes large.
+  std::vector<IndexRecord> batch;
+  batch.reserve(4096);
+  merge([&](const IndexRecord& record) {
+    batch.push_back(record);
+    if (batch.size() == batch.capacity()) {
+      ok = ok && file.write(batch.data(), batch.size() * sizeof(record), ec);
+      batch.clear();
+    }
+  });
+  ok = ok && file.write(batch.data(), batch.size() * sizeof(IndexRecord), ec);
+  // The records reach the disk before the rename can expose them.
+  ok = ok && file.sync(ec);
+  ok = file.close(ec) && ok;
+  if (!ok || std::rename(temporary.c_str(), target.c_str()) != 0) {
+    if (!ec) {
+      ec = internal::last_error();
+    }
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return internal::sync_directory(target, ec);
+}
+
+}  // namespace filetype
@@ -0,0 +1,608 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "kernel.hpp"
+
+#include <bitset>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FILETYPE_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(FILETYPE_HAVE_SSE2) && defined(__GNUC__)
+#define FILETYPE_HAVE_AVX2 1
+#define FILETYPE_HAVE_SSSE3 1
+#include <immintrin.h>
+#endif
+
+namespace filetype {
+namespace internal {
+namespace {
+
+[[maybe_unused]] uint64_t match_prefixes_scalar(const uint8_t* window,
+                                                const uint8_t* patterns,
+                                                const uint8_t* masks,
+                                                size_t count) {
+  uint64_t w[2];
+  std::memcpy(w, window, sizeof(w));
+  uint64_t hits = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t p[2];
+    uint64_t m[2];
+    std::memcpy(p, patterns + i * kWindowSize, sizeof(p));
+    std::memcpy(m, masks + i * kWindowSize, sizeof(m));
+    if (((w[0] & m[0]) ^ p[0]) == 0 && ((w[1] & m[1]) ^ p[1]) == 0) {
+      hits |= uint64_t{1} << i;
+    }
+  }
+  return hits;
+}
+
+#if defined(FILETYPE_HAVE_SSE2)
+uint64_t match_prefixes_sse2(const uint8_t* window, const uint8_t* patterns,
+                             const uint8_t* masks, size_t count) {
+  const __m128i w =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(window));
+  uint64_t hits = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const __m128i p = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(patterns + i * kWindowSize));
+    const __m128i m = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(masks + i * kWindowSize));
+    const __m128i eq = _mm_cmpeq_epi8(_mm_and_si128(w, m), p);
+    if (_mm_movemask_epi8(eq) == 0xFFFF) {
+      hits |= uint64_t{1} << i;
+    }
+  }
+  return hits;
+}
+#endif
+
+#if defined(FILETYPE_HAVE_AVX2)
+// Tests two patterns per iteration: the window is broadcast to both 128-bit
+// lanes and compared against a pair of adjacent patterns.
+__attribute__((target("avx2"))) uint64_t match_prefixes_avx2(
+    const uint8_t* window, const uint8_t* patterns, const uint8_t* masks,
+    size_t count) {
+  const __m256i w = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(window)));
+  uint64_t hits = 0;
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const __m256i p = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(patterns + i * kWindowSize));
+    const __m256i m = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(masks + i * kWindowSize));
+    const __m256i eq = _mm256_cmpeq_epi8(_mm256_and_si256(w, m), p);
+    const uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+    if ((bits & 0xFFFFu) == 0xFFFFu) {
+      hits |= uint64_t{1} << i;
+    }
+    if ((bits >> 16) == 0xFFFFu) {
+      hits |= uint64_t{1} << (i + 1);
+    }
+  }
+  if (i < count) {
+    hits |= match_prefixes_sse2(window, patterns + i * kWindowSize,
+                                masks + i * kWindowSize, count - i)
+            << i;
+  }
+  return hits;
+}
+#endif
+
+using PrefixKernel = uint64_t (*)(const uint8_t*, const uint8_t*,
+                                  const uint8_t*, size_t);
+
+PrefixKernel select_kernel() {
+#if defined(FILETYPE_HAVE_AVX2)
+  if (__builtin_cpu_supports("avx2")) {
+    return match_prefixes_avx2;
+  }
+#endif
+#if defined(FILETYPE_HAVE_SSE2)
+  return match_prefixes_sse2;
+#else
+  return match_prefixes_scalar;
+#endif
+}
+
+size_t find_pair_scalar(const uint8_t* data, size_t size,
+                        const BytePairSet& pairs) {
+  for (size_t i = 0; i + 1 < size; ++i) {
+    if (pairs.contains(data[i], data[i + 1])) {
+      return i;
+    }
+  }
+  return size;
+}
+
+#if defined(FILETYPE_HAVE_SSSE3)
+__attribute__((target("ssse3"))) size_t find_pair_ssse3(
+    const uint8_t* data, size_t size, const BytePairSet& pairs) {
+  const ByteSet& first = pairs.first();
+  const ByteSet& second = pairs.second();
+  const __m128i first_low =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(first.low()));
+  const __m128i first_high =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(first.high()));
+  const __m128i second_low =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(second.low()));
+  const __m128i second_high =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(second.high()));
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 17 <= size; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i w =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+    const __m128i a = _mm_and_si128(
+        _mm_shuffle_epi8(first_low, _mm_and_si128(v, nibble)),
+        _mm_shuffle_epi8(first_high,
+                         _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+    const __m128i b = _mm_and_si128(
+        _mm_shuffle_epi8(second_low, _mm_and_si128(w, nibble)),
+        _mm_shuffle_epi8(second_high,
+                         _mm_and_si128(_mm_srli_epi16(w, 4), nibble)));
+    // A position is a candidate when neither lookup came back zero; the
+    // byte sets cover more pairs than the set holds, so check each one.
+    const uint32_t misses = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(a, b), zero)));
+    for (uint32_t hits = ~misses & 0xFFFF; hits != 0; hits &= hits - 1) {
+      const size_t at = i + lowest_bit(hits);
+      if (pairs.contains(data[at], data[at + 1])) {
+        return at;
+      }
+    }
+  }
+  return i + find_pair_scalar(data + i, size - i, pairs);
+}
+#endif
+
+#if defined(FILETYPE_HAVE_AVX2)
+__attribute__((target("avx2"))) size_t find_pair_avx2(
+    const uint8_t* data, size_t size, const BytePairSet& pairs) {
+  const ByteSet& first = pairs.first();
+  const ByteSet& second = pairs.second();
+  const __m256i first_low = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(first.low())));
+  const __m256i first_high = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(first.high())));
+  const __m256i second_low = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(second.low())));
+  const __m256i second_high = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(second.high())));
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 33 <= size; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i w =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+    const __m256i a = _mm256_and_si256(
+        _mm256_shuffle_epi8(first_low, _mm256_and_si256(v, nibble)),
+        _mm256_shuffle_epi8(first_high,
+                            _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+    const __m256i b = _mm256_and_si256(
+        _mm256_shuffle_epi8(second_low, _mm256_and_si256(w, nibble)),
+        _mm256_shuffle_epi8(second_high,
+                            _mm256_and_si256(_mm256_srli_epi16(w, 4), nibble)));
+    const uint32_t misses = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_min_epu8(a, b), zero)));
+    for (uint32_t hits = ~misses; hits != 0; hits &= hits - 1) {
+      const size_t at = i + lowest_bit(hits);
+      if (pairs.contains(data[at], data[at + 1])) {
+        return at;
+      }
+    }
+  }
+  return i + find_pair_scalar(data + i, size - i, pairs);
+}
+#endif
+
+using PairKernel = size_t (*)(const uint8_t*, size_t, const BytePairSet&);
+
+PairKernel select_pair_kernel() {
+#if defined(FILETYPE_HAVE_AVX2)
+  if (__builtin_cpu_supports("avx2")) {
+    return find_pair_avx2;
+  }
+#endif
+#if defined(FILETYPE_HAVE_SSSE3)
+  if (__builtin_cpu_supports("ssse3")) {
+    return find_pair_ssse3;
+  }
+#endif
+  return find_pair_scalar;
+}
+
+// UTF-8 errors classified by the first two bytes of a sequence; see Keiser
+// and Lemire. Each table maps a nibble to the errors it can take part in,
+// and a pair of bytes is an error when all three lookups share a bit.
+constexpr uint8_t kTooShort = 1 << 0;   // 11______ 0_______, 11______ 11__
+constexpr uint8_t kTooLong = 1 << 1;    // 0_______ 10______
+constexpr uint8_t kOverlong3 = 1 << 2;  // 11100000 100_____
+constexpr uint8_t kTooLarge = 1 << 3;   // 11110100 1001____ and above
+constexpr uint8_t kSurrogate = 1 << 4;  // 11101101 101_____
+constexpr uint8_t kOverlong2 = 1 << 5;  // 1100000_ 10______
+constexpr uint8_t kTooLarge1000 = 1 << 6;  // 11110101 1000____ and above
+constexpr uint8_t kOverlong4 = 1 << 6;     // 11110000 1000____
+constexpr uint8_t kTwoConts = 1 << 7;      // 10______ 10______
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+alignas(16) constexpr uint8_t kByte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong,
+    kTooLong, kTooLong, kTooLong, kTooLong,
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4};
+
+alignas(16) constexpr uint8_t kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000};
+
+alignas(16) constexpr uint8_t kByte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 |
+        kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort};
+
+// Bytes above these in the last three positions of a block start a
+// sequence that continues in the next block.
+alignas(32) constexpr uint8_t kIncomplete[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+
+// Control bytes (is_control_byte()) by nibble: bit 0 for 0x0_, bit 1 for
+// 0x1_, bit 2 for 0x7_.
+alignas(16) constexpr uint8_t kControlLow[16] = {3, 3, 3, 3, 3, 3, 3, 3,
+                                                 2, 2, 2, 0, 2, 2, 3, 7};
+alignas(16) constexpr uint8_t kControlHigh[16] = {1, 2, 0, 0, 0, 0, 0, 4,
+                                                  0, 0, 0, 0, 0, 0, 0, 0};
+
+/// Whether @p data is UTF-8, allowing the last sequence to be cut off.
+bool valid_utf8(const uint8_t* data, size_t size) {
+  size_t i = 0;
+  while (i < size) {
+    const uint8_t lead = data[i];
+    if (lead < 0x80) {
+      ++i;
+      continue;
+    }
+    size_t length = 0;
+    uint8_t low = 0x80;
+    uint8_t high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+      length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+      length = 3;
+      low = lead == 0xE0 ? 0xA0 : low;
+      high = lead == 0xED ? 0x9F : high;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+      length = 4;
+      low = lead == 0xF0 ? 0x90 : low;
+      high = lead == 0xF4 ? 0x8F : high;
+    } else {
+      return false;
+    }
+    for (size_t k = 1; k < length; ++k) {
+      if (i + k == size) {
+        return true;
+      }
+      const uint8_t b = data[i + k];
+      if (b < (k == 1 ? low : 0x80) || b > (k == 1 ? high : 0xBF)) {
+        return false;
+      }
+    }
+    i += length;
+  }
+  return true;
+}
+
+/**
+ * Where valid_utf8() must take over from a vector loop that stopped at
+ * @p end: the lead byte of a sequence running past @p end, if any.
+ */
+size_t utf8_resume(const uint8_t* data, size_t end) {
+  for (size_t back = 1; back <= 3 && back <= end; ++back) {
+    const uint8_t b = data[end - back];
+    if (b >= 0xC0) {
+      const size_t length = b >= 0xF0 ? 4 : b >= 0xE0 ? 3 : 2;
+      return length > back ? end - back : end;
+    }
+    if (b < 0x80) {
+      break;
+    }
+  }
+  return end;
+}
+
+/// Adds the statistics of [begin, size) to @p stats, continuing a vector
+/// loop that stopped at @p begin.
+void finish_text(const uint8_t* data, size_t size, size_t begin,
+                 TextStats* stats) {
+  for (size_t i = begin; i < size; ++i) {
+    stats->controls += is_control_byte(data[i]);
+    stats->nul |= data[i] == 0;
+    stats->ascii &= data[i] < 0x80;
+  }
+  if (stats->utf8 && !stats->ascii) {
+    const size_t resume = utf8_resume(data, begin);
+    stats->utf8 = valid_utf8(data + resume, size - resume);
+  }
+}
+
+TextStats scan_text_scalar(const uint8_t* data, size_t size) {
+  TextStats stats;
+  finish_text(data, size, 0, &stats);
+  return stats;
+}
+
+#if defined(FILETYPE_HAVE_SSSE3)
+__attribute__((target("ssse3"))) TextStats scan_text_ssse3(
+    const uint8_t* data, size_t size) {
+  const __m128i byte_1_high =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1High));
+  const __m128i byte_1_low =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1Low));
+  const __m128i byte_2_high =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte2High));
+  const __m128i incomplete =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kIncomplete + 16));
+  const __m128i control_low =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kControlLow));
+  const __m128i control_high =
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kControlHigh));
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i prev = zero;
+  __m128i prev_incomplete = zero;
+  __m128i error = zero;
+  __m128i nul = zero;
+  TextStats stats;
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i input =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(input, 4), nibble);
+    const __m128i control =
+        _mm_and_si128(_mm_shuffle_epi8(control_low, _mm_and_si128(input,
+                                                                  nibble)),
+                      _mm_shuffle_epi8(control_high, high));
+    stats.controls += 16 - count_bits(static_cast<uint32_t>(
+                               _mm_movemask_epi8(_mm_cmpeq_epi8(control,
+                                                                zero))));
+    nul = _mm_or_si128(nul, _mm_cmpeq_epi8(input, zero));
+    if (_mm_movemask_epi8(input) == 0) {
+      // ASCII: only a sequence left open by the previous block can fail.
+      error = _mm_or_si128(error, prev_incomplete);
+      prev_incomplete = zero;
+    } else {
+      stats.ascii = false;
+      const __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+      const __m128i special = _mm_and_si128(
+          _mm_and_si128(
+              _mm_shuffle_epi8(byte_1_high, _mm_and_si128(
+                                                _mm_srli_epi16(prev1, 4),
+                                                nibble)),
+              _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+          _mm_shuffle_epi8(byte_2_high, high));
+      // Third and fourth bytes of a sequence must be continuations too.
+      const __m128i must_continue = _mm_and_si128(
+          _mm_or_si128(
+              _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14),
+                            _mm_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+              _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13),
+                            _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)))),
+          _mm_set1_epi8(static_cast<char>(0x80)));
+      error = _mm_or_si128(error, _mm_xor_si128(must_continue, special));
+      prev_incomplete = _mm_subs_epu8(input, incomplete);
+    }
+    prev = input;
+  }
+  stats.nul = _mm_movemask_epi8(nul) != 0;
+  stats.utf8 = _mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) == 0xFFFF;
+  finish_text(data, size, i, &stats);
+  return stats;
+}
+#endif
+
+#if defined(FILETYPE_HAVE_AVX2)
+__attribute__((target("avx2"))) TextStats scan_text_avx2(const uint8_t* data,
+                                                         size_t size) {
+  const __m256i byte_1_high = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1High)));
+  const __m256i byte_1_low = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte1Low)));
+  const __m256i byte_2_high = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kByte2High)));
+  const __m256i incomplete =
+      _mm256_load_si256(reinterpret_cast<const __m256i*>(kIncomplete));
+  const __m256i control_low = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kControlLow)));
+  const __m256i control_high = _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(kControlHigh)));
+  const __m256i nibble = _mm256_set1_epi8(0x0F);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i prev = zero;
+  __m256i prev_incomplete = zero;
+  __m256i error = zero;
+  __m256i nul = zero;
+  TextStats stats;
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i input =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i high =
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble);
+    const __m256i control = _mm256_and_si256(
+        _mm256_shuffle_epi8(control_low, _mm256_and_si256(input, nibble)),
+        _mm256_shuffle_epi8(control_high, high));
+    stats.controls += 32 - count_bits(static_cast<uint32_t>(
+                               _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                                   control, zero))));
+    nul = _mm256_or_si256(nul, _mm256_cmpeq_epi8(input, zero));
+    if (_mm256_movemask_epi8(input) == 0) {
+      error = _mm256_or_si256(error, prev_incomplete);
+      prev_incomplete = zero;
+    } else {
+      stats.ascii = false;
+      // The previous block's high lane followed by this block's low lane,
+      // so alignr can shift bytes across the lane boundary.
+      const __m256i carried = _mm256_permute2x128_si256(prev, input, 0x21);
+      const __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+      const __m256i special = _mm256_and_si256(
+          _mm256_and_si256(
+              _mm256_shuffle_epi8(
+                  byte_1_high,
+                  _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+              _mm256_shuffle_epi8(byte_1_low,
+                                  _mm256_and_si256(prev1, nibble))),
+          _mm256_shuffle_epi8(byte_2_high, high));
+      const __m256i must_continue = _mm256_and_si256(
+          _mm256_or_si256(
+              _mm256_subs_epu8(
+                  _mm256_alignr_epi8(input, carried, 14),
+                  _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+              _mm256_subs_epu8(
+                  _mm256_alignr_epi8(input, carried, 13),
+                  _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)))),
+          _mm256_set1_epi8(static_cast<char>(0x80)));
+      error =
+          _mm256_or_si256(error, _mm256_xor_si256(must_continue, special));
+      prev_incomplete = _mm256_subs_epu8(input, incomplete);
+    }
+    prev = input;
+  }
+  stats.nul = _mm256_movemask_epi8(nul) != 0;
+  stats.utf8 = _mm256_testz_si256(error, error) != 0;
+  finish_text(data, size, i, &stats);
+  return stats;
+}
+#endif
+
+using TextKernel = TextStats (*)(const uint8_t*, size_t);
+
+TextKernel select_text_kernel() {
+#if defined(FILETYPE_HAVE_AVX2)
+  if (__builtin_cpu_supports("avx2")) {
+    return scan_text_avx2;
+  }
+#endif
+#if defined(FILETYPE_HAVE_SSSE3)
+  if (__builtin_cpu_supports("ssse3")) {
+    return scan_text_ssse3;
+  }
+#endif
+  return scan_text_scalar;
+}
+}  // namespace
+
+void ByteSet::add(uint8_t b) {
+  members_[b >> 4] |= static_cast<uint16_t>(1u << (b & 0x0F));
+
+  // One bucket per distinct set of low nibbles, each holding the high
+  // nibbles that share it.
+  uint16_t lows[16];
+  uint16_t highs[16];
+  size_t count = 0;
+  for (size_t h = 0; h < 16; ++h) {
+    if (members_[h] == 0) {
+      continue;
+    }
+    size_t g = 0;
+    while (g < count && lows[g] != members_[h]) {
+      ++g;
+    }
+    if (g == count) {
+      lows[count] = members_[h];
+      highs[count++] = 0;
+    }
+    highs[g] |= static_cast<uint16_t>(1u << h);
+  }
+
+  // Past eight buckets, merge the pair that admits the fewest non-members.
+  const auto admitted = [](uint16_t low, uint16_t high) {
+    return static_cast<int>(std::bitset<16>(low).count() *
+                            std::bitset<16>(high).count());
+  };
+  while (count > 8) {
+    size_t best_i = 0;
+    size_t best_j = 1;
+    int best_cost = 257;
+    for (size_t i = 0; i < count; ++i) {
+      for (size_t j = i + 1; j < count; ++j) {
+        const int cost =
+            admitted(lows[i] | lows[j], highs[i] | highs[j]) -
+            admitted(lows[i], highs[i]) - admitted(lows[j], highs[j]);
+        if (cost < best_cost) {
+          best_cost = cost;
+          best_i = i;
+          best_j = j;
+        }
+      }
+    }
+    lows[best_i] |= lows[best_j];
+    highs[best_i] |= highs[best_j];
+    lows[best_j] = lows[--count];
+    highs[best_j] = highs[count];
+  }
+
+  std::memset(low_, 0, sizeof(low_));
+  std::memset(high_, 0, sizeof(high_));
+  for (size_t g = 0; g < count; ++g) {
+    const uint8_t bucket = static_cast<uint8_t>(1u << g);
+    for (size_t n = 0; n < 16; ++n) {
+      if ((lows[g] >> n) & 1) {
+        low_[n] |= bucket;
+      }
+      if ((highs[g] >> n) & 1) {
+        high_[n] |= bucket;
+      }
+    }
+  }
+}
+
+uint64_t match_prefixes(const uint8_t* window, const uint8_t* patterns,
+                        const uint8_t* masks, size_t count) {
+  static const PrefixKernel kernel = select_kernel();
+  return kernel(window, patterns, masks, count);
+}
+
+size_t find_pair(const uint8_t* data, size_t size, const BytePairSet& pairs) {
+  static const PairKernel kernel = select_pair_kernel();
+  return kernel(data, size, pairs);
+}
+
+TextStats scan_text(const uint8_t* data, size_t size) {
+  static const TextKernel kernel = select_text_kernel();
+  return kernel(data, size);
+}
+
+}  // namespace internal
+}  // namespace filetype
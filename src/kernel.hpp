@@ -0,0 +1,157 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_KERNEL_HPP_
+#define SRC_KERNEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace filetype {
+namespace internal {
+
+/// Number of leading bytes compared by the prefix kernel in one pass.
+constexpr size_t kWindowSize = 16;
+
+/// Maximum number of patterns tested by a single match_prefixes() call.
+constexpr size_t kMaxPrefixBatch = 64;
+
+/**
+ * @brief Test a window against a batch of masked prefix patterns.
+ *
+ * Pattern @c i occupies bytes [16 * i, 16 * i + 16) of @p patterns and
+ * @p masks. Pattern @c i matches when `(window & mask) == pattern` holds for
+ * all 16 bytes, so patterns must already be pre-masked. Uses AVX2 or SSE2
+ * when the CPU supports them, and a portable fallback otherwise.
+ *
+ * @param window First kWindowSize bytes of the buffer, zero padded.
+ * @param patterns Pre-masked patterns, 16 bytes each.
+ * @param masks Byte masks, 16 bytes each.
+ * @param count Number of patterns, at most kMaxPrefixBatch.
+ * @return Bit @c i is set when pattern @c i matches.
+ */
+uint64_t match_prefixes(const uint8_t* window, const uint8_t* patterns,
+                        const uint8_t* masks, size_t count);
+
+/**
+ * @brief Set of byte values, as tables for a vectorized membership test.
+ *
+ * High nibbles whose bytes share the same low nibbles are grouped into one
+ * of eight buckets; `low[b & 15] & high[b >> 4]` is non-zero for every
+ * member, so two table lookups per byte test a whole vector. With at most
+ * eight distinct groups the test is exact; past that, groups share buckets
+ * and the tables admit a few non-members.
+ */
+class ByteSet {
+ public:
+  void add(uint8_t b);
+
+  /// Bucket bits of each low nibble.
+  const uint8_t* low() const { return low_; }
+
+  /// Bucket bit of each high nibble.
+  const uint8_t* high() const { return high_; }
+
+ private:
+  uint16_t members_[16] = {};  ///< Low nibbles present, per high nibble.
+  uint8_t low_[16] = {};
+  uint8_t high_[16] = {};
+};
+
+/**
+ * @brief Set of byte pairs.
+ *
+ * contains() is exact; first() and second() hold the values either byte of
+ * a member may take, for filtering a buffer before testing pairs one by one.
+ */
+class BytePairSet {
+ public:
+  void add(uint8_t a, uint8_t b) {
+    first_.add(a);
+    second_.add(b);
+    bits_[a * 4 + (b >> 6)] |= uint64_t{1} << (b & 63);
+  }
+
+  bool contains(uint8_t a, uint8_t b) const {
+    return (bits_[a * 4 + (b >> 6)] >> (b & 63)) & 1;
+  }
+
+  const ByteSet& first() const { return first_; }
+  const ByteSet& second() const { return second_; }
+
+ private:
+  ByteSet first_;
+  ByteSet second_;
+  uint64_t bits_[1024] = {};
+};
+
+/**
+ * @brief Find the first position where a pair from a set occurs.
+ *
+ * Uses AVX2 or SSSE3 when the CPU supports them, and a portable fallback
+ * otherwise; on buffers with no candidate it runs at close to memchr()
+ * speed.
+ *
+ * @param data Buffer to search.
+ * @param size Size of the buffer in bytes.
+ * @param pairs Pairs to look for.
+ * @return Smallest @c i with `pairs` containing `(data[i], data[i + 1])`,
+ * or @p size if there is none.
+ */
+size_t find_pair(const uint8_t* data, size_t size, const BytePairSet& pairs);
+
+/// What scan_text() found in a buffer.
+struct TextStats {
+  /// Control bytes other than BS, TAB, LF, VT, FF, CR and ESC, NUL and DEL
+  /// included.
+  size_t controls = 0;
+  bool nul = false;    ///< Some byte is NUL.
+  bool ascii = true;   ///< No byte is 0x80 or above.
+  bool utf8 = true;    ///< Valid UTF-8, the last sequence possibly cut off.
+};
+
+/// Whether scan_text() counts @p b as a control byte.
+inline bool is_control_byte(uint8_t b) {
+  return (b < 0x20 && (b < 0x08 || b > 0x0D) && b != 0x1B) || b == 0x7F;
+}
+
+/**
+ * @brief Gather the byte statistics that tell text from binary data.
+ *
+ * One pass validates UTF-8 (with the lookup-table method of Keiser and
+ * Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte") and
+ * counts control bytes. Uses AVX2 or SSSE3 when the CPU supports them, and
+ * a portable fallback otherwise.
+ */
+TextStats scan_text(const uint8_t* data, size_t size);
+
+/// Index of the lowest set bit of a non-zero mask.
+inline size_t lowest_bit(uint64_t bits) {
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_ctzll(bits));
+#else
+  size_t index = 0;
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+/// Number of set bits in @p bits.
+inline size_t count_bits(uint32_t bits) {
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_popcount(bits));
+#else
+  size_t count = 0;
+  for (; bits != 0; bits &= bits - 1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_KERNEL_HPP_
@@ -0,0 +1,96 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/mapped_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "byte_source.hpp"
+#include "file.hpp"
+#include "filetype/filetype.hpp"
+#include "snapshot.hpp"
+
+namespace filetype {
+namespace {
+
+/// ByteSource over a mapped file, passing read hints on to the kernel.
+class MappedSource : public internal::ByteSource {
+ public:
+  explicit MappedSource(const MappedFile& file)
+      : file_(file), bytes_(file.bytes()) {}
+
+  uint64_t size() override { return bytes_.size(); }
+
+  size_t read(uint64_t offset, uint8_t* out, size_t count) override {
+    if (offset >= bytes_.size()) {
+      return 0;
+    }
+    const ByteView part = bytes_.subview(static_cast<size_t>(offset), count);
+    std::memcpy(out, part.data(), part.size());
+    return part.size();
+  }
+
+  void will_need(uint64_t offset, uint64_t count) override {
+    file_.will_need(offset, count);
+  }
+
+ private:
+  const MappedFile& file_;
+  ByteView bytes_;
+};
+
+}  // namespace
+
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile() = default;
+
+MappedFile::MappedFile(MappedFile&& other) noexcept = default;
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept = default;
+
+bool MappedFile::open(std::string_view path, std::error_code& ec,
+                      Access access) {
+  auto mapping = std::make_unique<internal::FileMapping>();
+  if (!mapping->open(path, ec)) {
+    return false;
+  }
+  mapping->advise(access);
+  mapping_ = std::move(mapping);
+  return true;
+}
+
+ByteView MappedFile::bytes() const {
+  return mapping_ ? mapping_->bytes() : ByteView();
+}
+
+void MappedFile::advise(Access access) const {
+  if (mapping_) {
+    mapping_->advise(access);
+  }
+}
+
+void MappedFile::will_need(uint64_t offset, uint64_t count) const {
+  if (mapping_) {
+    mapping_->will_need(offset, count);
+  }
+}
+
+DetectionResult detect(const MappedFile& file, CategoryMask categories) {
+  const ByteView bytes = file.bytes();
+  const internal::SnapshotGuard snapshot;
+  // Nothing is read here: pages of the head and the tail fault in as
+  // signatures touch them.
+  const ByteView head = bytes.subview(0, snapshot->max_end);
+  const ByteView tail =
+      bytes.subview(bytes.size() - std::min(bytes.size(), TAIL_PROBE_SIZE));
+  MappedSource source(file);
+  return snapshot->detect(head, tail, bytes.size(), source, categories);
+}
+
+const Type* match(const MappedFile& file, CategoryMask categories) {
+  return detect(file, categories).type;
+}
+
+}  // namespace filetype
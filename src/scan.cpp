@@ -0,0 +1,286 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "scan.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "file.hpp"
+#include "filetype/scan.hpp"
+#include "snapshot.hpp"
+#include "thread_pool.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+struct Key {
+  const uint8_t* bytes;
+  size_t length;
+  uint32_t back;  ///< Distance from the key's last byte to the file start.
+};
+
+/// Longest run of unmasked bytes of @p sig, capped at kMaxScanKey.
+bool make_key(const Signature& sig, Key* key) {
+  size_t best = 0;
+  size_t best_length = 0;
+  const auto exact = [&](size_t i) {
+    return sig.mask == nullptr || sig.mask[i] == 0xFF;
+  };
+  for (size_t i = 0; i < sig.length;) {
+    if (!exact(i)) {
+      ++i;
+      continue;
+    }
+    size_t end = i;
+    while (end < sig.length && exact(end)) {
+      ++end;
+    }
+    if (end - i > best_length) {
+      best = i;
+      best_length = end - i;
+    }
+    i = end;
+  }
+  if (best_length < kMinScanKey) {
+    return false;
+  }
+  key->bytes = sig.magic + best;
+  key->length = std::min(best_length, kMaxScanKey);
+  key->back = static_cast<uint32_t>(sig.offset + best + key->length - 1);
+  return true;
+}
+
+}  // namespace
+
+Scanner::Scanner(const std::vector<const Signature*>& rows) {
+  std::vector<Key> keys;
+  for (const Signature* sig : rows) {
+    Key key;
+    if (make_key(*sig, &key)) {
+      keys.push_back(key);
+      reach_ = std::max<size_t>(reach_, key.back + 1);
+    }
+  }
+
+  // Only bytes that occur in some key need their own class.
+  for (const Key& key : keys) {
+    for (size_t i = 0; i < key.length; ++i) {
+      uint16_t& cls = classes_[key.bytes[i]];
+      if (cls == 0) {
+        cls = static_cast<uint16_t>(class_count_++);
+      }
+    }
+    heads_.add(key.bytes[0], key.bytes[1]);
+  }
+
+  // Trie of the keys.
+  const size_t classes = class_count_;
+  delta_.assign(classes, kNone);
+  std::vector<std::vector<uint32_t>> outputs(1);
+  for (const Key& key : keys) {
+    uint32_t state = 0;
+    for (size_t i = 0; i < key.length; ++i) {
+      uint32_t& next = delta_[state * classes + classes_[key.bytes[i]]];
+      if (next == kNone) {
+        next = static_cast<uint32_t>(outputs.size());
+        outputs.emplace_back();
+        delta_.resize(delta_.size() + classes, kNone);
+      }
+      state = delta_[state * classes + classes_[key.bytes[i]]];
+    }
+    outputs[state].push_back(key.back);
+  }
+
+  // Failure links, breadth first, folded into a complete transition table;
+  // each state also reports the keys of its failure chain.
+  std::vector<uint32_t> fail(outputs.size(), 0);
+  std::deque<uint32_t> queue;
+  for (size_t c = 0; c < classes; ++c) {
+    uint32_t& next = delta_[c];
+    if (next == kNone) {
+      next = 0;
+    } else {
+      queue.push_back(next);
+    }
+  }
+  while (!queue.empty()) {
+    const uint32_t state = queue.front();
+    queue.pop_front();
+    const std::vector<uint32_t>& inherited = outputs[fail[state]];
+    outputs[state].insert(outputs[state].end(), inherited.begin(),
+                          inherited.end());
+    for (size_t c = 0; c < classes; ++c) {
+      const uint32_t fallback = delta_[fail[state] * classes + c];
+      uint32_t& next = delta_[state * classes + c];
+      if (next == kNone) {
+        next = fallback;
+      } else {
+        fail[next] = fallback;
+        queue.push_back(next);
+      }
+    }
+  }
+
+  output_start_.reserve(outputs.size() + 1);
+  for (std::vector<uint32_t>& out : outputs) {
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    output_start_.push_back(static_cast<uint32_t>(outputs_.size()));
+    outputs_.insert(outputs_.end(), out.begin(), out.end());
+  }
+  output_start_.push_back(static_cast<uint32_t>(outputs_.size()));
+}
+
+void Scanner::find_starts(const uint8_t* data, size_t size,
+                          std::vector<size_t>* starts) const {
+  uint32_t state = 0;
+  for (size_t i = 0; i < size; ++i) {
+    if (state == 0) {
+      // No key is under way: skip to the next position one could start at.
+      i += find_pair(data + i, size - i, heads_);
+      if (i >= size) {
+        break;
+      }
+    }
+    state = delta_[state * class_count_ + classes_[data[i]]];
+    for (uint32_t k = output_start_[state]; k < output_start_[state + 1];
+         ++k) {
+      if (i >= outputs_[k]) {
+        starts->push_back(i - outputs_[k]);
+      }
+    }
+  }
+}
+
+}  // namespace internal
+
+namespace {
+
+/// Hits of scan() that start in [begin, end), appended in offset order.
+void scan_range(const internal::SignatureSnapshot& snapshot, ByteView bytes,
+                size_t begin, size_t end, CategoryMask categories,
+                std::vector<ScanHit>* hits) {
+  const internal::Scanner& scanner = snapshot.scanner();
+  // A key ends at most reach() - 1 bytes after its file starts.
+  const ByteView window =
+      bytes.subview(begin, end - begin + scanner.reach() - 1);
+  // The start of the buffer is always a candidate, as for match().
+  std::vector<size_t> starts;
+  if (begin == 0) {
+    starts.push_back(0);
+  }
+  scanner.find_starts(window.data(), window.size(), &starts);
+  std::sort(starts.begin(), starts.end());
+  starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+  for (size_t start : starts) {
+    if (start >= end - begin) {
+      break;
+    }
+    if (DetectionResult result =
+            snapshot.detect(bytes.subview(begin + start), categories)) {
+      hits->push_back(ScanHit{begin + start, result});
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<ScanHit> scan(ByteView bytes, CategoryMask categories) {
+  std::vector<ScanHit> hits;
+  if (bytes.empty()) {
+    return hits;
+  }
+  const internal::SnapshotGuard snapshot;
+  scan_range(*snapshot, bytes, 0, bytes.size(), categories, &hits);
+  return hits;
+}
+
+const Type* match_anywhere(ByteView bytes, size_t* offset) {
+  if (bytes.empty()) {
+    return nullptr;
+  }
+  const internal::SnapshotGuard snapshot;
+  std::vector<size_t> starts = {0};
+  snapshot->scanner().find_starts(bytes.data(), bytes.size(), &starts);
+  std::sort(starts.begin(), starts.end());
+  for (size_t i = 0; i < starts.size(); ++i) {
+    if (i > 0 && starts[i] == starts[i - 1]) {
+      continue;
+    }
+    if (const Type* type =
+            snapshot->detect(bytes.subview(starts[i]), ALL_CATEGORIES).type) {
+      if (offset != nullptr) {
+        *offset = starts[i];
+      }
+      return type;
+    }
+  }
+  return nullptr;
+}
+
+size_t carve(ByteView bytes, const CarveCallback& on_hit,
+             const CarveOptions& options) {
+  if (bytes.empty()) {
+    return 0;
+  }
+  const size_t chunk = std::max<size_t>(options.chunk_size, 1);
+  const size_t count = (bytes.size() - 1) / chunk + 1;
+  size_t threads = options.threads;
+  if (threads == 0) {
+    threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+
+  // Chunks finish in any order; each one's hits wait until every chunk
+  // before it has been reported.
+  struct Pending {
+    std::vector<ScanHit> hits;
+    bool done = false;
+  };
+  std::vector<Pending> pending(count);
+  std::mutex mutex;
+  size_t next = 0;
+  size_t reported = 0;
+  const auto run = [&](size_t first, size_t last) {
+    for (size_t c = first; c < last; ++c) {
+      std::vector<ScanHit> hits;
+      {
+        // Released before on_hit runs, so that the callback may publish
+        // signatures without waiting on its own snapshot.
+        const internal::SnapshotGuard snapshot;
+        const size_t begin = c * chunk;
+        scan_range(*snapshot, bytes, begin,
+                   std::min(bytes.size() - begin, chunk) + begin,
+                   options.categories, &hits);
+      }
+      const std::lock_guard<std::mutex> lock(mutex);
+      pending[c].hits = std::move(hits);
+      pending[c].done = true;
+      for (; next < count && pending[next].done; ++next) {
+        for (const ScanHit& hit : pending[next].hits) {
+          on_hit(hit);
+        }
+        reported += pending[next].hits.size();
+        pending[next].hits = std::vector<ScanHit>();
+      }
+    }
+  };
+  internal::parallel_for(threads, count, 1, run);
+  return reported;
+}
+
+size_t carve_file(std::string_view path, const CarveCallback& on_hit,
+                  std::error_code& ec, const CarveOptions& options) {
+  internal::FileMapping mapping;
+  if (!mapping.open(path, ec)) {
+    return 0;
+  }
+  mapping.advise(Access::SEQUENTIAL);
+  return carve(mapping.bytes(), on_hit, options);
+}
+
+}  // namespace filetype
@@ -0,0 +1,85 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_SCAN_HPP_
+#define SRC_SCAN_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "engine.hpp"
+#include "kernel.hpp"
+
+namespace filetype {
+namespace internal {
+
+/**
+ * @brief Shortest run of constant bytes a signature needs to be scanned for.
+ *
+ * Two-byte magics (BMP, MP3 frame sync, AAC, compress) would turn up about
+ * every 64 KiB of arbitrary data, so scanning skips them; they are still
+ * matched at the start of a buffer.
+ */
+constexpr size_t kMinScanKey = 3;
+
+/// Longest key taken from one signature; the rest of it is verified.
+constexpr size_t kMaxScanKey = 8;
+
+/**
+ * @brief Aho-Corasick automaton over the constant bytes of a signature set.
+ *
+ * Every signature contributes its longest run of unmasked bytes as a key.
+ * One pass over a buffer reports each position where a key occurs, turned
+ * back into the position a file would start at for the signature to match
+ * there; callers then verify those positions with the regular engine.
+ *
+ * While the automaton sits in its root state, find_pair() skips ahead to
+ * the next pair of bytes that begins some key, so buffers with no hit are
+ * scanned at close to memchr() speed.
+ */
+class Scanner {
+ public:
+  /**
+   * @brief Build the automaton.
+   *
+   * @param rows Signatures to scan for; rows without kMinScanKey constant
+   * bytes in a row are left out.
+   */
+  explicit Scanner(const std::vector<const Signature*>& rows);
+
+  /**
+   * @brief Collect candidate file starts.
+   *
+   * @param data Buffer to scan.
+   * @param size Size of the buffer in bytes.
+   * @param starts Receives candidate start positions, unordered and possibly
+   * repeated.
+   */
+  void find_starts(const uint8_t* data, size_t size,
+                   std::vector<size_t>* starts) const;
+
+  /// Largest distance from a file start to the end of its key.
+  size_t reach() const { return reach_; }
+
+ private:
+  static constexpr uint32_t kNone = ~uint32_t{0};
+
+  std::array<uint16_t, 256> classes_{};  ///< Byte to alphabet class.
+  size_t class_count_ = 1;               ///< Class 0: bytes in no key.
+  std::vector<uint32_t> delta_;          ///< [state * class_count_ + class].
+
+  /// Per state, the distances from the key's last byte back to the file
+  /// start of every key ending there: outputs_[output_start_[s] ...
+  /// output_start_[s + 1]).
+  std::vector<uint32_t> output_start_;
+  std::vector<uint32_t> outputs_;
+
+  BytePairSet heads_;  ///< First two bytes of each key.
+  size_t reach_ = 0;
+};
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_SCAN_HPP_
@@ -0,0 +1,627 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/signature_db.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "engine.hpp"
+#include "file.hpp"
+#include "kernel.hpp"
+#include "snapshot.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+//------------------------------------------------------------------------------
+// Image layout
+//
+// A compiled image is the header followed by 16-byte aligned sections, all
+// little-endian: type records, signature records, the 257 bucket offsets,
+// one signature index per candidate, the candidates' pre-masked window
+// patterns and masks (the arrays Engine builds in memory), and a pool with
+// the magic, mask and string bytes records point into.
+//------------------------------------------------------------------------------
+
+constexpr char kImageMagic[8] = {'F', 'T', 'S', 'I', 'G', 'D', 'B', '\0'};
+constexpr uint32_t kImageVersion = 2;
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr uint32_t kNoMask = 0xFFFFFFFF;
+constexpr size_t kSectionAlignment = 16;
+constexpr size_t kBucketCount = 257;
+
+struct ImageHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;  ///< kByteOrder as written by the compiling host.
+  uint32_t total_size;
+  uint32_t type_count;
+  uint32_t signature_count;
+  uint32_t candidate_count;
+  uint32_t types;  ///< Section offsets from the start of the image.
+  uint32_t signatures;
+  uint32_t buckets;
+  uint32_t candidates;
+  uint32_t patterns;
+  uint32_t masks;
+  uint32_t pool;
+  uint32_t pool_size;
+};
+
+struct ImageType {
+  uint32_t mime;  ///< Pool offsets.
+  uint32_t extension;
+  uint16_t mime_length;
+  uint8_t extension_length;
+  uint8_t category;
+};
+
+struct ImageSignature {
+  uint32_t offset;
+  uint32_t magic;  ///< Pool offsets; mask is kNoMask for an exact match.
+  uint32_t mask;
+  uint16_t length;
+  uint16_t type;
+  int16_t priority;  ///< Ranks hits against other databases.
+  uint16_t reserved;
+};
+
+static_assert(std::is_trivially_copyable_v<ImageHeader> &&
+                  std::is_trivially_copyable_v<ImageType> &&
+                  std::is_trivially_copyable_v<ImageSignature>,
+              "image records are copied byte for byte");
+static_assert(sizeof(ImageType) == 12 && sizeof(ImageSignature) == 20,
+              "image records must not contain padding");
+
+//------------------------------------------------------------------------------
+// Description parser
+//------------------------------------------------------------------------------
+
+constexpr size_t kMaxMagicLength = 256;
+
+struct TypeEntry {
+  std::string mime;
+  std::string extension;
+  Category category;
+};
+
+struct SignatureEntry {
+  size_t type;
+  uint32_t offset;
+  std::vector<uint8_t> magic;
+  std::vector<uint8_t> mask;  ///< Empty for an exact match.
+  int16_t priority;
+};
+
+int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+bool parse_category(std::string_view name, Category* category) {
+  static constexpr std::pair<std::string_view, Category> kNames[] = {
+      {"image", Category::IMAGE},
+      {"document", Category::DOCUMENT},
+      {"archive", Category::ARCHIVE},
+      {"audio", Category::AUDIO},
+      {"video", Category::VIDEO},
+  };
+  for (const auto& [text, value] : kNames) {
+    if (name == text) {
+      *category = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Decimal, or hexadecimal after `0x`, with an optional leading minus.
+bool parse_number(std::string_view text, int64_t min, int64_t max,
+                  int64_t* value) {
+  const bool negative = !text.empty() && text[0] == '-';
+  text.remove_prefix(negative ? 1 : 0);
+  int base = 10;
+  if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+    text.remove_prefix(2);
+    base = 16;
+  }
+  int64_t v = 0;
+  const char* end = text.data() + text.size();
+  const auto [ptr, err] = std::from_chars(text.data(), end, v, base);
+  if (text.empty() || err != std::errc() || ptr != end) {
+    return false;
+  }
+  v = negative ? -v : v;
+  *value = v;
+  return v >= min && v <= max;
+}
+
+/// Hexadecimal bytes; `??` (if @p mask is given) is a byte not compared.
+bool parse_bytes(std::string_view text, std::vector<uint8_t>* bytes,
+                 std::vector<uint8_t>* mask) {
+  if (text.empty() || text.size() % 2 != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < text.size(); i += 2) {
+    if (mask != nullptr && text[i] == '?' && text[i + 1] == '?') {
+      bytes->push_back(0);
+      mask->push_back(0);
+      continue;
+    }
+    const int hi = hex_digit(text[i]);
+    const int lo = hex_digit(text[i + 1]);
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    bytes->push_back(static_cast<uint8_t>(hi << 4 | lo));
+    if (mask != nullptr) {
+      mask->push_back(0xFF);
+    }
+  }
+  return true;
+}
+
+class DescriptionParser {
+ public:
+  bool parse(std::string_view source) {
+    size_t line_number = 0;
+    while (!source.empty()) {
+      const size_t eol = std::min(source.find('\n'), source.size());
+      std::string_view line = source.substr(0, eol);
+      source.remove_prefix(std::min(eol + 1, source.size()));
+      ++line_number;
+      line = line.substr(0, line.find('#'));
+      if (!parse_line(line)) {
+        error_ = "line " + std::to_string(line_number) + ": " + error_;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const std::string& error() const { return error_; }
+  const std::vector<TypeEntry>& types() const { return types_; }
+  const std::vector<SignatureEntry>& signatures() const { return signatures_; }
+
+ private:
+  bool fail(std::string reason) {
+    error_ = std::move(reason);
+    return false;
+  }
+
+  bool parse_line(std::string_view line) {
+    std::vector<std::string_view> fields;
+    size_t pos = 0;
+    while (true) {
+      pos = line.find_first_not_of(" \t\r", pos);
+      if (pos == std::string_view::npos) {
+        break;
+      }
+      const size_t end =
+          std::min(line.find_first_of(" \t\r", pos), line.size());
+      fields.push_back(line.substr(pos, end - pos));
+      pos = end;
+    }
+    if (fields.empty()) {
+      return true;
+    }
+    if (fields.size() < 5) {
+      return fail("expected mime, extension, category, offset and magic");
+    }
+
+    TypeEntry type{std::string(fields[0]), std::string(fields[1]),
+                   Category::UNKNOWN};
+    if (type.mime.find('/') == std::string::npos || type.mime.size() > 255) {
+      return fail("invalid MIME type '" + type.mime + "'");
+    }
+    if (type.extension.size() > 255) {
+      return fail("extension too long");
+    }
+    if (!parse_category(fields[2], &type.category)) {
+      return fail("unknown category '" + std::string(fields[2]) + "'");
+    }
+
+    SignatureEntry sig{0, 0, {}, {}, 0};
+    int64_t offset;
+    if (!parse_number(fields[3], 0, SIGNATURE_DB_MAX_END, &offset)) {
+      return fail("invalid offset '" + std::string(fields[3]) + "'");
+    }
+    sig.offset = static_cast<uint32_t>(offset);
+    std::vector<uint8_t> wildcards;
+    if (!parse_bytes(fields[4], &sig.magic, &wildcards)) {
+      return fail("invalid magic '" + std::string(fields[4]) + "'");
+    }
+    if (sig.magic.size() > kMaxMagicLength ||
+        sig.offset + sig.magic.size() > SIGNATURE_DB_MAX_END) {
+      return fail("signature ends past byte " +
+                  std::to_string(SIGNATURE_DB_MAX_END));
+    }
+    if (std::count(wildcards.begin(), wildcards.end(), 0) != 0) {
+      sig.mask = wildcards;
+    }
+
+    for (size_t i = 5; i < fields.size(); ++i) {
+      const std::string_view option = fields[i];
+      if (option.substr(0, 5) == "mask=") {
+        if (!sig.mask.empty()) {
+          return fail("mask= cannot be combined with ?? or repeated");
+        }
+        if (!parse_bytes(option.substr(5), &sig.mask, nullptr) ||
+            sig.mask.size() != sig.magic.size()) {
+          return fail("mask must be hexadecimal and as long as the magic");
+        }
+      } else if (option.substr(0, 9) == "priority=") {
+        int64_t priority;
+        if (!parse_number(option.substr(9), INT16_MIN, INT16_MAX, &priority)) {
+          return fail("invalid priority '" + std::string(option) + "'");
+        }
+        sig.priority = static_cast<int16_t>(priority);
+      } else {
+        return fail("unknown option '" + std::string(option) + "'");
+      }
+    }
+    if (!sig.mask.empty()) {
+      if (std::count(sig.mask.begin(), sig.mask.end(), 0xFF) ==
+          static_cast<std::ptrdiff_t>(sig.mask.size())) {
+        sig.mask.clear();
+      } else if (std::count(sig.mask.begin(), sig.mask.end(), 0) ==
+                 static_cast<std::ptrdiff_t>(sig.mask.size())) {
+        return fail("the mask leaves no byte to compare");
+      }
+    }
+
+    // Rows with the same MIME type share one type.
+    sig.type = types_.size();
+    for (size_t i = 0; i < types_.size(); ++i) {
+      if (types_[i].mime == type.mime) {
+        if (types_[i].extension != type.extension ||
+            types_[i].category != type.category) {
+          return fail("'" + type.mime +
+                      "' was declared with another extension or category");
+        }
+        sig.type = i;
+      }
+    }
+    if (sig.type == types_.size()) {
+      if (types_.size() == UINT16_MAX) {
+        return fail("too many types");
+      }
+      types_.push_back(std::move(type));
+    }
+    signatures_.push_back(std::move(sig));
+    return true;
+  }
+
+  std::vector<TypeEntry> types_;
+  std::vector<SignatureEntry> signatures_;
+  std::string error_;
+};
+
+/// Appends sections to an image under construction.
+class ImageWriter {
+ public:
+  ImageWriter() : out_(sizeof(ImageHeader), 0) {}
+
+  /// Append @p size bytes aligned to kSectionAlignment; returns the offset.
+  uint32_t section(const void* data, size_t size) {
+    const size_t mask = kSectionAlignment - 1;
+    out_.resize((out_.size() + mask) & ~mask, 0);
+    const size_t offset = out_.size();
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    out_.insert(out_.end(), bytes, bytes + size);
+    return static_cast<uint32_t>(offset);
+  }
+
+  std::vector<uint8_t> finish(ImageHeader header) {
+    header.total_size = static_cast<uint32_t>(out_.size());
+    std::memcpy(out_.data(), &header, sizeof(header));
+    return std::move(out_);
+  }
+
+ private:
+  std::vector<uint8_t> out_;
+};
+
+/// Pool of magic, mask and string bytes; returns offsets into it.
+class Pool {
+ public:
+  uint32_t add(const void* data, size_t size) {
+    const size_t offset = bytes_.size();
+    const auto* p = static_cast<const uint8_t*>(data);
+    bytes_.insert(bytes_.end(), p, p + size);
+    return static_cast<uint32_t>(offset);
+  }
+
+  const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+std::vector<uint8_t> build_image(const DescriptionParser& description) {
+  const std::vector<TypeEntry>& type_entries = description.types();
+  const std::vector<SignatureEntry>& entries = description.signatures();
+
+  // Index the signatures with the same Engine the built-in table uses, so
+  // the image holds exactly the arrays find() searches.
+  std::vector<Type> types;
+  types.reserve(type_entries.size());
+  for (const TypeEntry& entry : type_entries) {
+    types.emplace_back(entry.mime, entry.extension, TypeId::CUSTOM,
+                       entry.category);
+  }
+  std::vector<Signature> rows;
+  rows.reserve(entries.size());
+  for (const SignatureEntry& entry : entries) {
+    Signature row{&types[entry.type], entry.magic.data(),
+                  entry.mask.empty() ? nullptr : entry.mask.data(),
+                  entry.magic.size(), entry.offset};
+    row.priority = entry.priority;
+    rows.push_back(row);
+  }
+  const Engine engine(rows.data(), rows.size());
+
+  Pool pool;
+  std::vector<ImageType> image_types;
+  for (const TypeEntry& entry : type_entries) {
+    ImageType record{};
+    record.mime = pool.add(entry.mime.data(), entry.mime.size());
+    record.mime_length = static_cast<uint16_t>(entry.mime.size());
+    record.extension = pool.add(entry.extension.data(), entry.extension.size());
+    record.extension_length = static_cast<uint8_t>(entry.extension.size());
+    record.category = static_cast<uint8_t>(entry.category);
+    image_types.push_back(record);
+  }
+  std::vector<ImageSignature> image_signatures;
+  for (const SignatureEntry& entry : entries) {
+    ImageSignature record{};
+    record.offset = entry.offset;
+    record.magic = pool.add(entry.magic.data(), entry.magic.size());
+    record.mask = entry.mask.empty()
+                      ? kNoMask
+                      : pool.add(entry.mask.data(), entry.mask.size());
+    record.length = static_cast<uint16_t>(entry.magic.size());
+    record.type = static_cast<uint16_t>(entry.type);
+    record.priority = entry.priority;
+    image_signatures.push_back(record);
+  }
+  std::vector<uint32_t> candidates;
+  for (const Signature* sig : engine.candidates()) {
+    candidates.push_back(static_cast<uint32_t>(sig - rows.data()));
+  }
+
+  const PrefixIndex index = engine.index();
+  const size_t window_bytes = candidates.size() * kWindowSize;
+  ImageWriter writer;
+  ImageHeader header{};
+  std::memcpy(header.magic, kImageMagic, sizeof(kImageMagic));
+  header.version = kImageVersion;
+  header.byte_order = kByteOrder;
+  header.type_count = static_cast<uint32_t>(image_types.size());
+  header.signature_count = static_cast<uint32_t>(image_signatures.size());
+  header.candidate_count = static_cast<uint32_t>(candidates.size());
+  header.types = writer.section(image_types.data(),
+                                image_types.size() * sizeof(ImageType));
+  header.signatures = writer.section(
+      image_signatures.data(),
+      image_signatures.size() * sizeof(ImageSignature));
+  header.buckets =
+      writer.section(index.bucket_start, kBucketCount * sizeof(uint32_t));
+  header.candidates =
+      writer.section(candidates.data(), candidates.size() * sizeof(uint32_t));
+  header.patterns = writer.section(index.patterns, window_bytes);
+  header.masks = writer.section(index.masks, window_bytes);
+  header.pool = writer.section(pool.bytes().data(), pool.bytes().size());
+  header.pool_size = static_cast<uint32_t>(pool.bytes().size());
+  return writer.finish(header);
+}
+
+}  // namespace
+}  // namespace internal
+
+bool compile_signatures(std::string_view source, std::vector<uint8_t>* image,
+                        std::string* error) {
+  internal::DescriptionParser parser;
+  if (!parser.parse(source)) {
+    if (error != nullptr) {
+      *error = parser.error();
+    }
+    return false;
+  }
+  *image = internal::build_image(parser);
+  return true;
+}
+
+SignatureDatabase::SignatureDatabase() = default;
+
+SignatureDatabase::~SignatureDatabase() = default;
+
+std::shared_ptr<const SignatureDatabase> SignatureDatabase::open(
+    std::string_view path, std::error_code& ec) {
+  auto mapping = std::make_unique<internal::FileMapping>();
+  if (!mapping->open(path, ec)) {
+    return nullptr;
+  }
+  std::shared_ptr<SignatureDatabase> database(new SignatureDatabase());
+  if (!database->attach(mapping->bytes())) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return nullptr;
+  }
+  database->mapping_ = std::move(mapping);
+  return database;
+}
+
+std::shared_ptr<const SignatureDatabase> SignatureDatabase::load(
+    ByteView image, std::error_code& ec) {
+  ec.clear();
+  std::shared_ptr<SignatureDatabase> database(new SignatureDatabase());
+  database->copy_.assign(image.data(), image.data() + image.size());
+  if (!database->attach(ByteView(database->copy_))) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return nullptr;
+  }
+  return database;
+}
+
+bool SignatureDatabase::attach(ByteView image) {
+  using internal::ImageHeader;
+  using internal::ImageSignature;
+  using internal::ImageType;
+
+  ImageHeader header;
+  if (image.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, image.data(), sizeof(header));
+  if (std::memcmp(header.magic, internal::kImageMagic, sizeof(header.magic)) !=
+          0 ||
+      header.version != internal::kImageVersion ||
+      header.byte_order != internal::kByteOrder ||
+      header.total_size != image.size()) {
+    return false;
+  }
+
+  // Every section must lie inside the image, suitably aligned.
+  auto section = [&](uint32_t offset, size_t count,
+                     size_t size) -> const uint8_t* {
+    if (offset % internal::kSectionAlignment != 0 || offset > image.size() ||
+        count > (image.size() - offset) / size) {
+      return nullptr;
+    }
+    return image.data() + offset;
+  };
+  const auto* types = reinterpret_cast<const ImageType*>(
+      section(header.types, header.type_count, sizeof(ImageType)));
+  const auto* signatures = reinterpret_cast<const ImageSignature*>(section(
+      header.signatures, header.signature_count, sizeof(ImageSignature)));
+  buckets_ = reinterpret_cast<const uint32_t*>(
+      section(header.buckets, internal::kBucketCount, sizeof(uint32_t)));
+  candidates_ = reinterpret_cast<const uint32_t*>(
+      section(header.candidates, header.candidate_count, sizeof(uint32_t)));
+  patterns_ =
+      section(header.patterns, header.candidate_count, internal::kWindowSize);
+  masks_ = section(header.masks, header.candidate_count, internal::kWindowSize);
+  const uint8_t* pool = section(header.pool, header.pool_size, 1);
+  if (types == nullptr || signatures == nullptr || buckets_ == nullptr ||
+      candidates_ == nullptr || patterns_ == nullptr || masks_ == nullptr ||
+      pool == nullptr) {
+    return false;
+  }
+  auto in_pool = [&](uint32_t offset, size_t length) {
+    return offset <= header.pool_size && length <= header.pool_size - offset;
+  };
+
+  types_.reserve(header.type_count);
+  for (uint32_t i = 0; i < header.type_count; ++i) {
+    const ImageType& record = types[i];
+    if (!in_pool(record.mime, record.mime_length) ||
+        !in_pool(record.extension, record.extension_length) ||
+        record.category == 0 ||
+        record.category >= static_cast<uint8_t>(Category::COUNT)) {
+      return false;
+    }
+    const char* chars = reinterpret_cast<const char*>(pool);
+    types_.emplace_back(
+        std::string_view(chars + record.mime, record.mime_length),
+        std::string_view(chars + record.extension, record.extension_length),
+        TypeId::CUSTOM, static_cast<Category>(record.category));
+  }
+
+  signatures_ =
+      std::make_unique<internal::Signature[]>(header.signature_count);
+  for (uint32_t i = 0; i < header.signature_count; ++i) {
+    const ImageSignature& record = signatures[i];
+    if (record.type >= header.type_count || record.length == 0 ||
+        record.offset + size_t{record.length} > SIGNATURE_DB_MAX_END ||
+        !in_pool(record.magic, record.length) ||
+        (record.mask != internal::kNoMask &&
+         !in_pool(record.mask, record.length))) {
+      return false;
+    }
+    internal::Signature& sig = signatures_[i];
+    sig.type = &types_[record.type];
+    sig.magic = pool + record.magic;
+    sig.mask = record.mask == internal::kNoMask ? nullptr : pool + record.mask;
+    sig.length = record.length;
+    sig.offset = record.offset;
+    sig.priority = record.priority;
+    max_end_ = std::max(max_end_, sig.offset + sig.length);
+  }
+  signature_count_ = header.signature_count;
+
+  if (buckets_[0] != 0 ||
+      buckets_[internal::kBucketCount - 1] != header.candidate_count ||
+      !std::is_sorted(buckets_, buckets_ + internal::kBucketCount)) {
+    return false;
+  }
+  return std::all_of(
+      candidates_, candidates_ + header.candidate_count,
+      [&](uint32_t index) { return index < header.signature_count; });
+}
+
+DetectionResult SignatureDatabase::detect(ByteView bytes,
+                                          CategoryMask categories) const {
+  return internal::to_result(find(bytes, categories));
+}
+
+const internal::Signature* SignatureDatabase::find(
+    ByteView bytes, CategoryMask categories) const {
+  if (bytes.empty()) {
+    return nullptr;
+  }
+  const internal::PrefixIndex index{buckets_, patterns_, masks_};
+  const size_t hit = internal::find_candidate(
+      index, bytes.data(), bytes.size(), [&](size_t i) {
+        const internal::Signature& sig = signatures_[candidates_[i]];
+        const size_t end = sig.offset + sig.length;
+        return bytes.size() >= end &&
+               (to_mask(sig.type->category) & categories) != 0 &&
+               (end <= internal::kWindowSize ||
+                internal::matches(sig, bytes.data(), bytes.size()));
+      });
+  if (hit == internal::kNoCandidate) {
+    return nullptr;
+  }
+  return &signatures_[candidates_[hit]];
+}
+
+void register_signatures(std::shared_ptr<const SignatureDatabase> database) {
+  if (database == nullptr) {
+    return;
+  }
+  internal::publish_databases([&](const internal::DatabaseList& current) {
+    internal::DatabaseList next;
+    next.reserve(current.size() + 1);
+    next.push_back(std::move(database));
+    next.insert(next.end(), current.begin(), current.end());
+    return next;
+  });
+}
+
+void replace_signatures(
+    std::vector<std::shared_ptr<const SignatureDatabase>> databases) {
+  databases.erase(std::remove(databases.begin(), databases.end(), nullptr),
+                  databases.end());
+  internal::publish_databases(
+      [&](const internal::DatabaseList&) { return std::move(databases); });
+}
+
+void clear_signatures() {
+  internal::publish_databases(
+      [](const internal::DatabaseList&) { return internal::DatabaseList(); });
+}
+
+}  // namespace filetype
@@ -0,0 +1,195 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "cfb.hpp"
+#include "ebml.hpp"
+#include "engine.hpp"
+#include "filetype/types/archive.hpp"
+#include "filetype/types/audio.hpp"
+#include "filetype/types/document.hpp"
+#include "filetype/types/image.hpp"
+#include "filetype/types/video.hpp"
+#include "ftyp.hpp"
+#include "trailer.hpp"
+#include "zip.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+template <size_t N>
+constexpr Signature sig(const Type& type, const std::array<uint8_t, N>& magic,
+                        size_t offset = 0) {
+  return Signature{&type, magic.data(), nullptr, N, offset};
+}
+
+template <size_t N>
+constexpr Signature sig(const Type& type, const std::array<uint8_t, N>& magic,
+                        const std::array<uint8_t, N>& mask) {
+  return Signature{&type, magic.data(), mask.data(), N, 0};
+}
+
+constexpr Signature refined(Signature row, const Refiner& refiner) {
+  row.refiner = &refiner;
+  return row;
+}
+
+//------------------------------------------------------------------------------
+// Built-in signature table
+//
+// Rows sharing a magic sequence are listed most generic first; the engine
+// keeps table order between equally specific signatures. DOCX, XLSX, PPTX,
+// ODT, ODS, ODP, EPUB, JAR and APK share ZIP's magic and are told apart by
+// the ZIP row's refiner; XLS, PPT and MSG share DOC's Compound File Binary
+// magic and are told apart by the DOC row's refiner. Every ISO base media
+// file (MP4, M4A, MOV, 3GP, HEIC, AVIF, CR3) starts with an `ftyp` box and
+// is matched by the MP4 row, whose refiner reads the box's brands; WebM
+// shares MKV's EBML magic and is told apart by the MKV row's refiner. WMA
+// shares WMV's ASF header, so it is not listed here.
+//------------------------------------------------------------------------------
+constexpr Signature kBuiltinSignatures[] = {
+    // Image formats
+    sig(image::TYPE_PNG, image::PNG_MAGIC),
+    sig(image::TYPE_JPEG, image::JPEG_MAGIC),
+    sig(image::TYPE_GIF, image::GIF_MAGIC),
+    sig(image::TYPE_WEBP, image::WEBP_MAGIC, image::WEBP_MASK),
+    sig(image::TYPE_CR2, image::CR2_MAGIC),
+    sig(image::TYPE_TIFF, image::TIFF_MAGIC_LE),
+    sig(image::TYPE_TIFF, image::TIFF_MAGIC_BE),
+    sig(image::TYPE_BMP, image::BMP_MAGIC),
+    sig(image::TYPE_JXR, image::JXR_MAGIC),
+    sig(image::TYPE_PSD, image::PSD_MAGIC),
+    sig(image::TYPE_ICO, image::ICO_MAGIC),
+
+    // Document formats
+    sig(document::TYPE_PDF, document::PDF_MAGIC),
+    refined(sig(document::TYPE_DOC, document::DOC_MAGIC), kCfbRefiner),
+    sig(document::TYPE_RTF, document::RTF_MAGIC),
+
+    // Archive formats
+    refined(sig(archive::TYPE_ZIP, archive::ZIP_MAGIC), kZipRefiner),
+    sig(archive::TYPE_RAR, archive::RAR_MAGIC),
+    sig(archive::TYPE_TAR, archive::TAR_MAGIC, 257),
+    sig(archive::TYPE_7Z, archive::SEVEN_Z_MAGIC),
+    sig(archive::TYPE_GZ, archive::GZ_MAGIC),
+    sig(archive::TYPE_BZ2, archive::BZ2_MAGIC),
+    sig(archive::TYPE_XZ, archive::XZ_MAGIC),
+    sig(archive::TYPE_Z, archive::Z_MAGIC),
+    sig(archive::TYPE_LZ, archive::LZ_MAGIC),
+
+    // Audio formats
+    sig(audio::TYPE_MP3, audio::MP3_MAGIC),
+    sig(audio::TYPE_MP3, audio::MP3_ID3_MAGIC),
+    sig(audio::TYPE_WAV, audio::WAV_MAGIC, audio::WAV_MASK),
+    sig(audio::TYPE_MIDI, audio::MIDI_MAGIC),
+    sig(audio::TYPE_FLAC, audio::FLAC_MAGIC),
+    sig(audio::TYPE_AAC, audio::AAC_MAGIC),
+    sig(audio::TYPE_OGG, audio::OGG_MAGIC),
+    sig(audio::TYPE_AIFF, audio::AIFF_MAGIC, audio::AIFF_MASK),
+
+    // Video formats
+    refined(sig(video::TYPE_MP4, video::MP4_MAGIC, video::MP4_MASK),
+            kFtypRefiner),
+    sig(video::TYPE_AVI, video::AVI_MAGIC, video::AVI_MASK),
+    refined(sig(video::TYPE_MKV, video::MKV_MAGIC), kEbmlRefiner),
+    sig(video::TYPE_FLV, video::FLV_MAGIC),
+    sig(video::TYPE_WMV, video::WMV_MAGIC),
+    sig(video::TYPE_MPEG, video::MPEG_MAGIC),
+    sig(video::TYPE_MPEG, video::MPEG_MAGIC_ALT),
+};
+
+//------------------------------------------------------------------------------
+// Built-in tail signature table
+//
+// Tried in order when no head signature matches, strongest trailer first. A
+// ZIP archive found by its end record still goes through the ZIP refiner.
+//------------------------------------------------------------------------------
+constexpr TailSignature kBuiltinTailSignatures[] = {
+    {&archive::TYPE_DMG, &locate_koly, archive::DMG_MAGIC.size(), kKolySize},
+    // PK\5\6
+    {&archive::TYPE_ZIP, &locate_zip_end, 4, kZipTailRead, &kZipRefiner},
+    // %%EOF
+    {&document::TYPE_PDF, &locate_pdf_end, 5, kPdfTailRead},
+    // TAG
+    {&audio::TYPE_MP3, &locate_id3v1, 3, kId3v1Size},
+};
+
+template <size_t N>
+constexpr size_t max_end(const Signature (&table)[N]) {
+  size_t end = 0;
+  for (const Signature& row : table) {
+    end = row.offset + row.length > end ? row.offset + row.length : end;
+  }
+  return end;
+}
+
+// File readers size their buffers from kMaxSignatureEnd; keep it exact so a
+// new deep signature cannot be silently truncated.
+static_assert(max_end(kBuiltinSignatures) == kMaxSignatureEnd,
+              "kMaxSignatureEnd must match the built-in signature table");
+
+template <size_t N>
+constexpr size_t max_reach(const TailSignature (&table)[N]) {
+  size_t reach = 0;
+  for (const TailSignature& row : table) {
+    reach = row.reach > reach ? row.reach : reach;
+  }
+  return reach;
+}
+
+static_assert(max_reach(kBuiltinTailSignatures) == kMaxTailReach,
+              "kMaxTailReach must match the built-in tail signature table");
+
+}  // namespace
+
+const Signature* builtin_signatures(size_t* count) {
+  *count = std::size(kBuiltinSignatures);
+  return kBuiltinSignatures;
+}
+
+const TailSignature* builtin_tail_signatures(size_t* count) {
+  *count = std::size(kBuiltinTailSignatures);
+  return kBuiltinTailSignatures;
+}
+
+uint64_t builtin_fingerprint() {
+  static const uint64_t fingerprint = [] {
+    // FNV-1a over every field that can change a built-in result.
+    uint64_t hash = 0xCBF29CE484222325u;
+    const auto mix = [&hash](uint64_t value) {
+      for (int shift = 0; shift < 64; shift += 8) {
+        hash = (hash ^ ((value >> shift) & 0xFF)) * 0x100000001B3u;
+      }
+    };
+    const auto mix_refiner = [&mix](const Refiner* refiner) {
+      mix(refiner != nullptr ? (uint64_t{1} << 32) | refiner->categories : 0);
+      mix(refiner != nullptr ? refiner->reach : 0);
+    };
+    mix(static_cast<uint64_t>(TypeId::COUNT));
+    for (const Signature& row : kBuiltinSignatures) {
+      mix(static_cast<uint64_t>(row.type->id));
+      mix(row.offset);
+      mix(row.length);
+      for (size_t i = 0; i < row.length; ++i) {
+        mix(row.magic[i] | (row.mask != nullptr ? row.mask[i] : 0xFF) << 8);
+      }
+      mix(static_cast<uint16_t>(row.priority));
+      mix_refiner(row.refiner);
+    }
+    for (const TailSignature& row : kBuiltinTailSignatures) {
+      mix(static_cast<uint64_t>(row.type->id));
+      mix(row.length);
+      mix(row.reach);
+      mix_refiner(row.refiner);
+    }
+    return hash;
+  }();
+  return fingerprint;
+}
+
+}  // namespace internal
+}  // namespace filetype
@@ -0,0 +1,252 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "snapshot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "file.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+/// Reader counters are striped so that threads seldom share a cache line.
+constexpr size_t kReaderSlots = 64;
+
+/**
+ * @brief Grace-period tracking for published snapshots.
+ *
+ * Readers announce themselves on the counter of the current epoch parity in
+ * their slot. A writer swaps the snapshot pointer, then flips the epoch
+ * twice, each time waiting for the counters of the parity it left to drain:
+ * a reader still counted on either parity after that may only have loaded
+ * the new pointer.
+ */
+struct Publication {
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> readers[2];
+  };
+
+  SignatureSnapshot builtin{{}, &default_engines(), kMaxSignatureEnd, 0};
+  std::atomic<const SignatureSnapshot*> current{&builtin};
+  std::atomic<unsigned> epoch{0};
+  std::array<Slot, kReaderSlots> slots{};
+  std::mutex writer;  ///< Serializes publish_databases().
+  uint64_t generations = 0;  ///< Last generation handed out; under writer.
+
+  ~Publication() {
+    const SignatureSnapshot* last = current.load();
+    if (last != &builtin) {
+      delete last;
+    }
+  }
+
+  void wait_for_readers() {
+    for (int flip = 0; flip < 2; ++flip) {
+      const unsigned parity = epoch.fetch_add(1) & 1;
+      for (Slot& slot : slots) {
+        while (slot.readers[parity].load() != 0) {
+          std::this_thread::yield();
+        }
+      }
+    }
+  }
+};
+
+Publication& publication() {
+  static Publication instance;
+  return instance;
+}
+
+/// Slot of the calling thread, assigned round-robin on first use.
+size_t reader_slot() {
+  static std::atomic<size_t> next{0};
+  thread_local const size_t slot = next.fetch_add(1) % kReaderSlots;
+  return slot;
+}
+
+}  // namespace
+
+SignatureSnapshot::~SignatureSnapshot() {
+  delete scanner_.load(std::memory_order_relaxed);
+}
+
+DetectionResult SignatureSnapshot::detect_custom(
+    ByteView bytes, CategoryMask categories) const {
+  // The highest priority wins; on a tie, the database listed first.
+  const Signature* best = nullptr;
+  for (const auto& database : databases) {
+    const Signature* sig = database->find(bytes, categories);
+    if (sig != nullptr && (best == nullptr || sig->priority > best->priority)) {
+      best = sig;
+    }
+  }
+  return to_result(best);
+}
+
+DetectionResult SignatureSnapshot::detect(ByteView bytes,
+                                          CategoryMask categories) const {
+  if (!databases.empty()) {
+    if (DetectionResult result = detect_custom(bytes, categories)) {
+      return result;
+    }
+  }
+  return detect_with(engine(categories), bytes);
+}
+
+DetectionResult SignatureSnapshot::detect(ByteView head, ByteView tail,
+                                          uint64_t size,
+                                          CategoryMask categories) const {
+  SampleSource source(head, tail, size);
+  return detect(head, tail, size, source, categories);
+}
+
+DetectionResult SignatureSnapshot::detect(ByteView head, ByteView tail,
+                                          uint64_t size, ByteSource& source,
+                                          CategoryMask categories) const {
+  if (!databases.empty()) {
+    if (DetectionResult result = detect_custom(head, categories)) {
+      return result;
+    }
+  }
+  return detect_with(engine(categories), head, tail, size, source);
+}
+
+static_assert(SIGNATURE_DB_MAX_END >= kMaxSignatureEnd,
+              "detect_file() reads both tables into one buffer");
+
+DetectionResult SignatureSnapshot::detect_file(std::string_view path,
+                                               std::error_code& ec,
+                                               CategoryMask categories) const {
+  File file;
+  if (!file.open(path, ec)) {
+    return DetectionResult();
+  }
+  // Registered databases may look deeper than the built-in signatures.
+  uint8_t buffer[SIGNATURE_DB_MAX_END];
+  const size_t size = file.read_at(0, buffer, max_end, ec);
+  if (ec) {
+    return DetectionResult();
+  }
+  return detect_open(file, ByteView(buffer, size), size < max_end, categories,
+                     ec);
+}
+
+DetectionResult SignatureSnapshot::detect_open(const File& file, ByteView head,
+                                               bool whole,
+                                               CategoryMask categories,
+                                               std::error_code& ec) const {
+  if (!databases.empty()) {
+    if (DetectionResult result = detect_custom(head, categories)) {
+      return result;
+    }
+  }
+  // Container refiners read beyond the prefix through the open file.
+  const Engine& builtin_engine = engine(categories);
+  FileSource source(file, head);
+  if (const Signature* sig = builtin_engine.find(head.data(), head.size())) {
+    return resolve(builtin_engine, sig, source);
+  }
+
+  // Trailers cost one more read, unless the head was the whole file.
+  const size_t size = head.size();
+  const uint64_t file_size = whole ? size : source.size();
+  if (file_size == kUnknownSize) {
+    return DetectionResult();
+  }
+  const size_t reach = static_cast<size_t>(
+      std::min<uint64_t>(builtin_engine.tail_reach(), file_size));
+  uint8_t tail_buffer[kMaxTailReach];
+  ByteView tail = head.subview(size - std::min(reach, size));
+  if (file_size > size) {
+    if (file.read_at(file_size - reach, tail_buffer, reach, ec) != reach) {
+      return DetectionResult();  // truncated meanwhile, or failed
+    }
+    tail = ByteView(tail_buffer, reach);
+  }
+  SampleSource sample(head, tail, file_size, &source);
+  return resolve_tail(builtin_engine, tail, file_size, sample);
+}
+
+const Scanner& SignatureSnapshot::scanner() const {
+  const Scanner* current = scanner_.load(std::memory_order_acquire);
+  if (current != nullptr) {
+    return *current;
+  }
+  std::vector<const Signature*> rows;
+  for (const auto& database : databases) {
+    for (size_t i = 0; i < database->signature_count_; ++i) {
+      rows.push_back(&database->signatures_[i]);
+    }
+  }
+  size_t count = 0;
+  const Signature* table = builtin_signatures(&count);
+  for (size_t i = 0; i < count; ++i) {
+    rows.push_back(&table[i]);
+  }
+  const Scanner* built = new Scanner(rows);
+  if (scanner_.compare_exchange_strong(current, built,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+    return *built;
+  }
+  // Another thread published its scanner first; use that one.
+  delete built;
+  return *current;
+}
+
+SnapshotGuard::SnapshotGuard() {
+  Publication& p = publication();
+  snapshot_ = p.current.load(std::memory_order_acquire);
+  if (snapshot_ == &p.builtin) {
+    return;  // Never freed, so there is nothing to announce.
+  }
+  slot_ = reader_slot();
+  parity_ = p.epoch.load() & 1;
+  p.slots[slot_].readers[parity_].fetch_add(1);
+  counted_ = true;
+  // Loaded after announcing: a writer that freed what the first load saw
+  // has already published something newer.
+  snapshot_ = p.current.load();
+}
+
+SnapshotGuard::~SnapshotGuard() {
+  if (counted_) {
+    publication().slots[slot_].readers[parity_].fetch_sub(
+        1, std::memory_order_release);
+  }
+}
+
+void publish_databases(
+    const std::function<DatabaseList(const DatabaseList& current)>& update) {
+  Publication& p = publication();
+  std::lock_guard<std::mutex> lock(p.writer);
+  const SignatureSnapshot* old = p.current.load();
+
+  DatabaseList databases = update(old->databases);
+  const SignatureSnapshot* next = &p.builtin;
+  if (!databases.empty()) {
+    size_t max_end = kMaxSignatureEnd;
+    for (const auto& database : databases) {
+      max_end = std::max(max_end, database->max_end());
+    }
+    next = new SignatureSnapshot{std::move(databases), &default_engines(),
+                                 max_end, ++p.generations};
+  }
+  p.current.store(next);
+
+  if (old != &p.builtin) {
+    p.wait_for_readers();
+    delete old;
+  }
+}
+
+}  // namespace internal
+}  // namespace filetype
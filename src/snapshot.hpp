@@ -0,0 +1,131 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_SNAPSHOT_HPP_
+#define SRC_SNAPSHOT_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "engine.hpp"
+#include "filetype/byte_view.hpp"
+#include "filetype/result.hpp"
+#include "filetype/signature_db.hpp"
+#include "filetype/type.hpp"
+#include "scan.hpp"
+
+namespace filetype {
+namespace internal {
+
+class File;
+
+/// Databases of a snapshot, most recently registered first; ties in priority
+/// go to the earlier one.
+using DatabaseList = std::vector<std::shared_ptr<const SignatureDatabase>>;
+
+/**
+ * @brief Immutable set of signatures consulted by match() and friends.
+ *
+ * A snapshot is never modified once published; updates build a new one and
+ * publish it in a single atomic store. The default snapshot holds only the
+ * built-in table and is never freed.
+ */
+struct SignatureSnapshot {
+  DatabaseList databases;  ///< Searched first, in order.
+  const EngineCache* builtin;
+
+  /// Prefix length that evaluates every signature of the snapshot.
+  size_t max_end;
+
+  /// Distinct for every published snapshot with databases; 0 for the
+  /// built-in one.
+  uint64_t generation;
+
+  /// Automaton over every signature, built on first use.
+  mutable std::atomic<const Scanner*> scanner_{nullptr};
+
+  ~SignatureSnapshot();
+
+  /// First hit among the databases, or an empty result.
+  DetectionResult detect_custom(ByteView bytes, CategoryMask categories) const;
+
+  /// Databases first, then the built-in signatures, as detect() does.
+  DetectionResult detect(ByteView bytes, CategoryMask categories) const;
+
+  /// detect() over the first and last bytes of an input.
+  DetectionResult detect(ByteView head, ByteView tail, uint64_t size,
+                         CategoryMask categories) const;
+
+  /// detect() over the first and last bytes of an input, refiners reading
+  /// the rest from @p source.
+  DetectionResult detect(ByteView head, ByteView tail, uint64_t size,
+                         ByteSource& source, CategoryMask categories) const;
+
+  /// Open and read @p path as detect_file() does.
+  DetectionResult detect_file(std::string_view path, std::error_code& ec,
+                              CategoryMask categories = ALL_CATEGORIES) const;
+
+  /**
+   * @brief detect_file() over an open file whose first bytes are read.
+   *
+   * @param head At least the first max_end bytes of the file, or all of it.
+   * @param whole Whether @p head is the whole file.
+   */
+  DetectionResult detect_open(const File& file, ByteView head, bool whole,
+                              CategoryMask categories,
+                              std::error_code& ec) const;
+
+  /// Engine over the built-in signatures of @p categories.
+  const Engine& engine(CategoryMask categories) const {
+    return builtin->get(categories);
+  }
+
+  /// Scanner over the databases' and the built-in signatures.
+  const Scanner& scanner() const;
+};
+
+/**
+ * @brief Read-side critical section over the published snapshot.
+ *
+ * Entering costs one atomic load while the default snapshot is published,
+ * and two uncontended increments on a per-thread counter otherwise; it
+ * never blocks. The snapshot stays alive until the guard is destroyed, even
+ * if another one is published meanwhile. Guards may nest.
+ */
+class SnapshotGuard {
+ public:
+  SnapshotGuard();
+  ~SnapshotGuard();
+
+  SnapshotGuard(const SnapshotGuard&) = delete;
+  SnapshotGuard& operator=(const SnapshotGuard&) = delete;
+
+  const SignatureSnapshot& operator*() const { return *snapshot_; }
+  const SignatureSnapshot* operator->() const { return snapshot_; }
+
+ private:
+  const SignatureSnapshot* snapshot_;
+  size_t slot_ = 0;
+  unsigned parity_ = 0;
+  bool counted_ = false;
+};
+
+/**
+ * @brief Publish a snapshot built from the current one.
+ *
+ * Writers are serialized. Returns once every reader that could still see
+ * the previous snapshot has left its critical section, after freeing it.
+ *
+ * @param update Turns the current database list into the new one.
+ */
+void publish_databases(
+    const std::function<DatabaseList(const DatabaseList& current)>& update);
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_SNAPSHOT_HPP_
@@ -0,0 +1,160 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/stream.hpp"
+
+#include <algorithm>
+
+#include "byte_source.hpp"
+#include "engine.hpp"
+#include "kernel.hpp"
+
+namespace filetype {
+
+StreamDetector::StreamDetector(CategoryMask categories)
+    : engine_(&internal::default_engines().get(categories)) {
+  settle(false);
+}
+
+StreamStatus StreamDetector::feed(ByteView chunk) {
+  if (!status_.need_more() || chunk.empty()) {
+    return status_;
+  }
+  if (consumed_ == 0) {
+    select_bucket(chunk[0]);
+  }
+  if (keep_prefix_ && prefix_.size() < STREAM_REFINE_WINDOW) {
+    const ByteView kept =
+        chunk.subview(0, STREAM_REFINE_WINDOW - prefix_.size());
+    prefix_.insert(prefix_.end(), kept.data(), kept.data() + kept.size());
+  }
+  check(chunk);
+  consumed_ += chunk.size();
+  settle(false);
+  return status_;
+}
+
+StreamStatus StreamDetector::finish() {
+  if (status_.need_more()) {
+    settle(true);
+  }
+  return status_;
+}
+
+void StreamDetector::reset() {
+  candidates_ = nullptr;
+  candidate_count_ = 0;
+  alive_.clear();
+  prefix_.clear();
+  keep_prefix_ = false;
+  consumed_ = 0;
+  settle(false);
+}
+
+void StreamDetector::select_bucket(uint8_t first_byte) {
+  candidates_ = engine_->bucket(first_byte, &candidate_count_);
+  alive_.assign((candidate_count_ + 63) / 64, ~uint64_t{0});
+  if (candidate_count_ % 64 != 0) {
+    alive_.back() = (uint64_t{1} << (candidate_count_ % 64)) - 1;
+  }
+  keep_prefix_ = std::any_of(
+      candidates_, candidates_ + candidate_count_,
+      [](const internal::Signature* sig) { return sig->refiner != nullptr; });
+}
+
+void StreamDetector::check(ByteView chunk) {
+  const size_t begin = consumed_;
+  const size_t end = consumed_ + chunk.size();
+  for (size_t word = 0; word < alive_.size(); ++word) {
+    uint64_t bits = alive_[word];
+    while (bits != 0) {
+      const size_t bit = internal::lowest_bit(bits);
+      bits &= bits - 1;
+      const internal::Signature& sig = *candidates_[word * 64 + bit];
+
+      // Compare only the part of the signature that falls inside this chunk.
+      const size_t lo = std::max(sig.offset, begin);
+      const size_t hi = std::min(sig.offset + sig.length, end);
+      for (size_t pos = lo; pos < hi; ++pos) {
+        const size_t i = pos - sig.offset;
+        const uint8_t mask = sig.mask ? sig.mask[i] : 0xFF;
+        if (((chunk[pos - begin] ^ sig.magic[i]) & mask) != 0) {
+          alive_[word] &= ~(uint64_t{1} << bit);
+          break;
+        }
+      }
+    }
+  }
+}
+
+void StreamDetector::settle(bool at_end) {
+  status_ = StreamStatus();
+  result_ = DetectionResult();
+  if (consumed_ == 0) {
+    status_.state = at_end ? StreamState::REJECTED : StreamState::NEED_MORE;
+    status_.need = at_end ? 0 : 1;
+    return;
+  }
+
+  // Walk the surviving candidates in the engine's priority order. The first
+  // one that has matched in full wins, unless a more specific one is still
+  // waiting for bytes.
+  size_t need = 0;
+  bool refinable = false;
+  for (size_t i = 0; i < candidate_count_; ++i) {
+    if ((alive_[i / 64] >> (i % 64) & 1) == 0) {
+      continue;
+    }
+    const internal::Signature* sig = candidates_[i];
+    refinable |= sig->refiner != nullptr;
+    const size_t sig_end = sig->offset + sig->length;
+    if (sig_end <= consumed_) {
+      if (need != 0) {
+        status_.type = sig->type;
+        break;
+      }
+      decide(sig, at_end);
+      return;
+    }
+    if (!at_end && need == 0) {
+      need = sig_end - consumed_;
+    }
+  }
+  if (keep_prefix_ && !refinable) {
+    // No container signature is left; stop keeping bytes.
+    keep_prefix_ = false;
+    prefix_.clear();
+  }
+  if (need != 0) {
+    status_.state = StreamState::NEED_MORE;
+    status_.need = need;
+  } else {
+    status_.state = StreamState::REJECTED;
+  }
+}
+
+void StreamDetector::decide(const internal::Signature* winner, bool at_end) {
+  if (winner->refiner == nullptr) {
+    status_.state = StreamState::DETECTED;
+    status_.type = winner->type;
+    result_ = internal::to_result(winner);
+    return;
+  }
+  const size_t reach = winner->refiner->reach;
+  const size_t window = reach != 0 && reach < STREAM_REFINE_WINDOW
+                            ? reach
+                            : STREAM_REFINE_WINDOW;
+  if (!at_end && consumed_ < window) {
+    status_.state = StreamState::NEED_MORE;
+    status_.type = winner->type;
+    status_.need = window - consumed_;
+    return;
+  }
+  // The kept bytes are the whole input only if the stream ended inside the
+  // window; otherwise the refiner sees a prefix of unknown total size.
+  internal::BufferSource source(prefix_, at_end && consumed_ == prefix_.size());
+  result_ = internal::resolve(*engine_, winner, source);
+  status_.state = result_ ? StreamState::DETECTED : StreamState::REJECTED;
+  status_.type = result_.type;
+}
+
+}  // namespace filetype
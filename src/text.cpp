@@ -0,0 +1,113 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/text.hpp"
+
+#include <cstring>
+
+#include "kernel.hpp"
+
+namespace filetype {
+namespace {
+
+/// Text holds at most one control byte in this many.
+constexpr size_t kControlRatio = 32;
+
+struct Bom {
+  const char* bytes;
+  size_t length;
+  Charset charset;
+};
+
+// UTF-32LE before UTF-16LE: FF FE 00 00 starts with FF FE.
+constexpr Bom kBoms[] = {
+    {"\xEF\xBB\xBF", 3, Charset::UTF8},
+    {"\xFF\xFE\x00\x00", 4, Charset::UTF32LE},
+    {"\x00\x00\xFE\xFF", 4, Charset::UTF32BE},
+    {"\xFF\xFE", 2, Charset::UTF16LE},
+    {"\xFE\xFF", 2, Charset::UTF16BE},
+};
+
+bool is_surrogate(uint32_t c) { return c >= 0xD800 && c <= 0xDFFF; }
+
+/**
+ * Whether @p body holds whole UTF-16 or UTF-32 code units of valid code
+ * points. When @p cut, the body was cut off by the window, and a unit or
+ * surrogate pair split by its end is accepted.
+ */
+bool valid_wide(ByteView body, Charset charset, bool cut) {
+  const bool utf32 = charset == Charset::UTF32LE || charset == Charset::UTF32BE;
+  const bool big = charset == Charset::UTF16BE || charset == Charset::UTF32BE;
+  const size_t unit = utf32 ? 4 : 2;
+  if (body.size() % unit != 0 && !cut) {
+    return false;
+  }
+  const size_t size = body.size() - body.size() % unit;
+  const auto load = [&](size_t at) {
+    uint32_t c = 0;
+    for (size_t i = 0; i < unit; ++i) {
+      c |= uint32_t{body[at + i]} << (8 * (big ? unit - 1 - i : i));
+    }
+    return c;
+  };
+  for (size_t at = 0; at < size; at += unit) {
+    const uint32_t c = load(at);
+    if (utf32) {
+      if (c > 0x10FFFF || is_surrogate(c)) {
+        return false;
+      }
+    } else if (c >= 0xDC00 && c <= 0xDFFF) {
+      return false;  // a low surrogate on its own
+    } else if (c >= 0xD800 && c <= 0xDBFF) {
+      at += unit;
+      if (at >= size) {
+        return cut;
+      }
+      const uint32_t low = load(at);
+      if (low < 0xDC00 || low > 0xDFFF) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TextResult detect_text(ByteView bytes, size_t budget) {
+  const ByteView window = bytes.subview(0, budget);
+  TextResult result;
+  for (const Bom& bom : kBoms) {
+    if (window.size() >= bom.length &&
+        std::memcmp(window.data(), bom.bytes, bom.length) == 0) {
+      if (bom.charset == Charset::UTF8) {
+        result.bom_length = bom.length;
+        break;
+      }
+      // NUL is an ordinary byte in UTF-16 and UTF-32, so the body is checked
+      // for whole code units of valid code points instead. A UTF-32LE mark
+      // that fails may still be a UTF-16LE one.
+      if (valid_wide(window.subview(bom.length), bom.charset,
+                     window.size() < bytes.size())) {
+        result.bom_length = bom.length;
+        result.charset = bom.charset;
+        return result;
+      }
+    }
+  }
+
+  const ByteView body = window.subview(result.bom_length);
+  if (body.empty() && result.bom_length == 0) {
+    return result;
+  }
+  const internal::TextStats stats =
+      internal::scan_text(body.data(), body.size());
+  if (stats.nul || stats.controls * kControlRatio > body.size() ||
+      !stats.utf8) {
+    return result;
+  }
+  result.charset = stats.ascii && result.bom_length == 0 ? Charset::ASCII
+                                                         : Charset::UTF8;
+  return result;
+}
+
+}  // namespace filetype
@@ -0,0 +1,160 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+namespace filetype {
+namespace internal {
+namespace {
+
+/// Chunks [front, back) still to run on one lane.
+struct alignas(64) Lane {
+  std::mutex mutex;
+  size_t front = 0;
+  size_t back = 0;
+};
+
+/// Shared state of one parallel_for() call, owned by the calling thread.
+struct Job {
+  void (*fn)(void*, size_t, size_t);
+  void* context;
+  size_t count;
+  size_t grain;
+  size_t lane_count;
+  std::unique_ptr<Lane[]> lanes;
+  size_t running;  ///< Lanes handed to workers and not finished.
+  std::mutex mutex;
+  std::condition_variable done;
+
+  /// Next chunk for lane @p self: its own front, else another lane's back.
+  bool take(size_t self, size_t* chunk) {
+    {
+      Lane& own = lanes[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (own.front < own.back) {
+        *chunk = own.front++;
+        return true;
+      }
+    }
+    for (size_t k = 1; k < lane_count; ++k) {
+      Lane& victim = lanes[(self + k) % lane_count];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (victim.front < victim.back) {
+        *chunk = --victim.back;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(size_t self) {
+    size_t chunk;
+    while (take(self, &chunk)) {
+      const size_t begin = chunk * grain;
+      fn(context, begin, std::min(begin + grain, count));
+    }
+  }
+};
+
+void run_lane(void* job_ptr, size_t lane) {
+  Job* job = static_cast<Job*>(job_ptr);
+  job->run(lane);
+  // The count is only ever read under the mutex, so the caller cannot see it
+  // reach zero (and destroy the job) before this notification is finished.
+  std::lock_guard<std::mutex> lock(job->mutex);
+  if (--job->running == 0) {
+    job->done.notify_all();
+  }
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+  workers_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    workers_.emplace_back([this] { worker_loop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::worker_loop() {
+  for (;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = tasks_.front();
+      tasks_.pop_front();
+    }
+    task.run(task.context, task.lane);
+  }
+}
+
+void ThreadPool::run_range(size_t threads, size_t count, size_t grain,
+                           void (*fn)(void*, size_t, size_t), void* context) {
+  if (count == 0) {
+    return;
+  }
+  grain = std::max<size_t>(grain, 1);
+  const size_t chunks = (count + grain - 1) / grain;
+  const size_t lanes = std::min({threads, chunks, workers_.size() + 1});
+  if (lanes <= 1) {
+    fn(context, 0, count);
+    return;
+  }
+
+  Job job{fn, context, count, grain, lanes, std::make_unique<Lane[]>(lanes),
+          lanes - 1, {}, {}};
+  for (size_t k = 0; k < lanes; ++k) {
+    job.lanes[k].front = k * chunks / lanes;
+    job.lanes[k].back = (k + 1) * chunks / lanes;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t k = 1; k < lanes; ++k) {
+      tasks_.push_back(Task{&run_lane, &job, k});
+    }
+  }
+  wake_.notify_all();
+
+  job.run(0);
+  // Every chunk has been taken; lanes no worker has started are not waited
+  // for.
+  size_t retracted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto unstarted = std::remove_if(
+        tasks_.begin(), tasks_.end(),
+        [&job](const Task& task) { return task.context == &job; });
+    retracted = static_cast<size_t>(tasks_.end() - unstarted);
+    tasks_.erase(unstarted, tasks_.end());
+  }
+  std::unique_lock<std::mutex> lock(job.mutex);
+  job.running -= retracted;
+  job.done.wait(lock, [&job] { return job.running == 0; });
+}
+
+ThreadPool& ThreadPool::shared() {
+  static ThreadPool pool(
+      std::max<unsigned>(std::thread::hardware_concurrency(), 2) - 1);
+  return pool;
+}
+
+}  // namespace internal
+}  // namespace filetype
@@ -0,0 +1,126 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_THREAD_POOL_HPP_
+#define SRC_THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace filetype {
+namespace internal {
+
+/// Unit of work for a pool thread: one lane of a parallel_for() call.
+struct Task {
+  void (*run)(void* context, size_t lane);
+  void* context;
+  size_t lane;
+};
+
+/**
+ * @brief Fixed-size work-stealing thread pool.
+ *
+ * A parallel_for() call runs on a number of lanes, the calling thread being
+ * one and pool workers the others. The chunks of the range are dealt out to
+ * the lanes in contiguous blocks; a lane takes chunks from the front of its
+ * own block and, once that is empty, steals from the back of the others, so
+ * neighbouring chunks tend to stay on one thread while idle lanes pick up the
+ * far end of a busy one. A call never occupies more workers than it has
+ * lanes and leaves the rest to concurrent calls. The caller retracts the
+ * lanes no worker has picked up by the time its own runs dry, which keeps
+ * nested or concurrent calls from deadlocking. Blocks are index ranges, so
+ * scheduling allocates nothing per item.
+ */
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Number of worker threads.
+  size_t size() const { return workers_.size(); }
+
+  /**
+   * @brief Run @p fn over [0, count) in chunks of @p grain indices on at
+   * most @p threads threads, the caller included and at most size() workers
+   * besides it.
+   *
+   * Blocks until every chunk has run.
+   *
+   * @param fn Callable invoked as `fn(begin, end)`.
+   */
+  template <typename Fn>
+  void parallel_for(size_t threads, size_t count, size_t grain,
+                    const Fn& fn) {
+    run_range(threads, count, grain, &invoke<Fn>, const_cast<Fn*>(&fn));
+  }
+
+  /// Process-wide pool with a worker per hardware thread besides the
+  /// caller, created on first request.
+  static ThreadPool& shared();
+
+ private:
+  template <typename Fn>
+  static void invoke(void* fn, size_t begin, size_t end) {
+    (*static_cast<const Fn*>(fn))(begin, end);
+  }
+
+  void run_range(size_t threads, size_t count, size_t grain,
+                 void (*fn)(void*, size_t, size_t), void* context);
+  void worker_loop();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<Task> tasks_;  ///< Lanes waiting for a worker.
+  bool stop_ = false;
+};
+
+/**
+ * @brief Run CPU-bound @p fn over [0, count) in chunks of @p grain indices
+ * on ThreadPool::shared().
+ *
+ * At most @p threads threads take part, the caller included, and never more
+ * than the shared pool has workers plus the caller: extra threads would only
+ * contend for the same cores.
+ *
+ * @param fn Callable invoked as `fn(begin, end)`.
+ */
+template <typename Fn>
+void parallel_for(size_t threads, size_t count, size_t grain, const Fn& fn) {
+  ThreadPool::shared().parallel_for(threads, count, grain, fn);
+}
+
+/**
+ * @brief Run @p fn, which blocks on I/O, over [0, count) one index at a time
+ * on @p threads threads, the caller included.
+ *
+ * Threads that wait on the disk would hold up the CPU-bound work the shared
+ * pool is sized for, so the call starts a pool of its own and joins it
+ * before returning; the thread count is not capped by the core count.
+ *
+ * @param fn Callable invoked as `fn(begin, end)`.
+ */
+template <typename Fn>
+void parallel_for_blocking(size_t threads, size_t count, const Fn& fn) {
+  threads = std::min(threads, count);
+  if (threads <= 1) {
+    if (count != 0) {
+      fn(0, count);
+    }
+    return;
+  }
+  ThreadPool pool(threads - 1);
+  pool.parallel_for(threads, count, 1, fn);
+}
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_THREAD_POOL_HPP_
@@ -0,0 +1,80 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "trailer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "filetype/types/archive.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+/// Bytes before `%%EOF` searched for the `startxref` keyword.
+constexpr size_t kStartXrefWindow = 64;
+
+/// Version and header size in a `koly` trailer.
+constexpr uint32_t kKolyVersion = 4;
+
+uint32_t be32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) << 24 |
+         static_cast<uint32_t>(p[1]) << 16 |
+         static_cast<uint32_t>(p[2]) << 8 | static_cast<uint32_t>(p[3]);
+}
+
+/// White space a PDF writer may leave after `%%EOF`, padding included.
+bool is_pdf_space(uint8_t b) {
+  return b == ' ' || b == '\t' || b == '\r' || b == '\n' || b == '\f' ||
+         b == '\0';
+}
+
+std::string_view text(ByteView bytes) {
+  return std::string_view(reinterpret_cast<const char*>(bytes.data()),
+                          bytes.size());
+}
+
+}  // namespace
+
+size_t locate_id3v1(ByteView tail) {
+  if (tail.size() < kId3v1Size) {
+    return kNoCandidate;
+  }
+  const size_t at = tail.size() - kId3v1Size;
+  return text(tail.subview(at, 3)) == "TAG" ? at : kNoCandidate;
+}
+
+size_t locate_pdf_end(ByteView tail) {
+  constexpr std::string_view kMarker = "%%EOF";
+  size_t end = tail.size();
+  while (end > 0 && is_pdf_space(tail[end - 1])) {
+    --end;
+  }
+  if (end < kMarker.size() ||
+      text(tail.subview(end - kMarker.size(), kMarker.size())) != kMarker) {
+    return kNoCandidate;
+  }
+  const size_t marker = end - kMarker.size();
+  const size_t window = marker < kStartXrefWindow ? marker : kStartXrefWindow;
+  return text(tail.subview(marker - window, window)).find("startxref") !=
+                 std::string_view::npos
+             ? marker
+             : kNoCandidate;
+}
+
+size_t locate_koly(ByteView tail) {
+  if (tail.size() < kKolySize) {
+    return kNoCandidate;
+  }
+  const size_t at = tail.size() - kKolySize;
+  const uint8_t* koly = tail.data() + at;
+  return std::memcmp(koly, archive::DMG_MAGIC.data(),
+                     archive::DMG_MAGIC.size()) == 0 &&
+                 be32(koly + 4) == kKolyVersion && be32(koly + 8) == kKolySize
+             ? at
+             : kNoCandidate;
+}
+
+}  // namespace internal
+}  // namespace filetype
@@ -0,0 +1,53 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_TRAILER_HPP_
+#define SRC_TRAILER_HPP_
+
+#include <cstddef>
+
+#include "engine.hpp"
+#include "filetype/byte_view.hpp"
+
+namespace filetype {
+namespace internal {
+
+/// Size of an ID3v1 tag, which fills the last bytes of an MP3 file.
+constexpr size_t kId3v1Size = 128;
+
+/// Bytes the PDF `%%EOF` marker may lie from the end of the file.
+constexpr size_t kPdfTailRead = 1024;
+
+/// Size of the `koly` trailer closing an Apple disk image.
+constexpr size_t kKolySize = 512;
+
+/**
+ * @brief Find an ID3v1 tag: `TAG` at the start of the last 128 bytes.
+ *
+ * @return Offset of the tag in @p tail, or kNoCandidate.
+ */
+size_t locate_id3v1(ByteView tail);
+
+/**
+ * @brief Find the end of a PDF file.
+ *
+ * The last `%%EOF` marker must be followed by nothing but white space and be
+ * preceded by the `startxref` keyword, as the trailer of every revision is.
+ *
+ * @return Offset of the marker in @p tail, or kNoCandidate.
+ */
+size_t locate_pdf_end(ByteView tail);
+
+/**
+ * @brief Find the `koly` trailer of an Apple disk image.
+ *
+ * The trailer fills the last 512 bytes and starts with the magic, version 4
+ * and its own size, big-endian.
+ *
+ * @return Offset of the trailer in @p tail, or kNoCandidate.
+ */
+size_t locate_koly(ByteView tail);
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_TRAILER_HPP_
@@ -0,0 +1,269 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "zip.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+#include "filetype/types/archive.hpp"
+#include "filetype/types/document.hpp"
+
+namespace filetype {
+namespace internal {
+namespace {
+
+constexpr uint32_t kLocalHeaderSignature = 0x04034B50;      // PK\3\4
+constexpr uint32_t kCentralHeaderSignature = 0x02014B50;    // PK\1\2
+constexpr uint32_t kEndOfDirectorySignature = 0x06054B50;   // PK\5\6
+constexpr size_t kLocalHeaderSize = 30;
+constexpr size_t kCentralHeaderSize = 46;
+constexpr size_t kEndOfDirectorySize = 22;
+
+/// Longest entry name compared; longer names are read truncated.
+constexpr size_t kMaxNameRead = 256;
+
+/// Longest `mimetype` entry considered.
+constexpr size_t kMaxMimetypeRead = 128;
+
+/// General purpose flag: sizes follow the data in a data descriptor.
+constexpr uint16_t kFlagDataDescriptor = 0x0008;
+
+/// Compression method of entries stored without compression.
+constexpr uint16_t kMethodStored = 0;
+
+uint16_t le16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | p[1] << 8);
+}
+
+uint32_t le32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+         static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+bool starts_with(std::string_view text, std::string_view prefix) {
+  return text.substr(0, prefix.size()) == prefix;
+}
+
+/// What the entries seen so far say about the archive.
+class Evidence {
+ public:
+  void add_name(std::string_view name) {
+    if (name == "[Content_Types].xml") {
+      content_types_ = true;
+    } else if (office_ == nullptr && starts_with(name, "word/")) {
+      office_ = &document::TYPE_DOCX;
+    } else if (office_ == nullptr && starts_with(name, "xl/")) {
+      office_ = &document::TYPE_XLSX;
+    } else if (office_ == nullptr && starts_with(name, "ppt/")) {
+      office_ = &document::TYPE_PPTX;
+    } else if (name == "META-INF/MANIFEST.MF") {
+      manifest_ = true;
+    } else if (name == "AndroidManifest.xml" || name == "classes.dex") {
+      android_ = true;
+    }
+  }
+
+  /// Content of a leading stored `mimetype` entry (OpenDocument, EPUB).
+  void set_mimetype(std::string_view mime) {
+    has_mimetype_ = true;
+    for (const Type* type :
+         {&document::TYPE_ODT, &document::TYPE_ODS, &document::TYPE_ODP,
+          &document::TYPE_EPUB}) {
+      if (mime == type->mime) {
+        mimetype_ = type;
+      }
+    }
+  }
+
+  /// true once no later entry can change the verdict.
+  bool decided() const {
+    return has_mimetype_ || android_ || (content_types_ && office_);
+  }
+
+  const Type* verdict() const {
+    if (has_mimetype_) {
+      return mimetype_;
+    }
+    if (android_) {
+      return &archive::TYPE_APK;
+    }
+    if (content_types_ && office_ != nullptr) {
+      return office_;
+    }
+    if (manifest_) {
+      return &archive::TYPE_JAR;
+    }
+    return nullptr;
+  }
+
+ private:
+  const Type* mimetype_ = nullptr;
+  const Type* office_ = nullptr;
+  bool has_mimetype_ = false;
+  bool content_types_ = false;
+  bool manifest_ = false;
+  bool android_ = false;
+};
+
+/**
+ * @brief Walk the local file headers at the start of the archive.
+ *
+ * @return true if the walk reached the central directory, i.e. every entry
+ * has been seen.
+ */
+bool walk_local_headers(ByteSource& source, Evidence* evidence) {
+  uint8_t header[kLocalHeaderSize + kMaxNameRead];
+  uint64_t offset = 0;
+  for (size_t i = 0; i < kZipMaxLocalHeaders; ++i) {
+    const size_t n = source.read(offset, header, sizeof(header));
+    if (n < 4) {
+      return false;
+    }
+    if (le32(header) != kLocalHeaderSignature) {
+      return le32(header) == kCentralHeaderSignature;
+    }
+    if (n < kLocalHeaderSize) {
+      return false;
+    }
+    const uint16_t flags = le16(header + 6);
+    const uint16_t method = le16(header + 8);
+    const uint32_t compressed = le32(header + 18);
+    const uint16_t name_length = le16(header + 26);
+    const uint16_t extra_length = le16(header + 28);
+    const uint64_t data =
+        offset + kLocalHeaderSize + name_length + extra_length;
+    const std::string_view name(
+        reinterpret_cast<const char*>(header + kLocalHeaderSize),
+        std::min<size_t>(name_length, n - kLocalHeaderSize));
+
+    if (i == 0 && name == "mimetype" && method == kMethodStored &&
+        compressed <= kMaxMimetypeRead) {
+      uint8_t mime[kMaxMimetypeRead];
+      const size_t got = source.read(data, mime, compressed);
+      evidence->set_mimetype(
+          std::string_view(reinterpret_cast<const char*>(mime), got));
+    }
+    evidence->add_name(name);
+    if (evidence->decided()) {
+      return false;
+    }
+
+    // Without sizes in the local header the next entry cannot be located.
+    if ((flags & kFlagDataDescriptor) != 0 || compressed == 0xFFFFFFFF) {
+      return false;
+    }
+    offset = data + compressed;
+  }
+  return false;
+}
+
+/// Feed the names from the central directory, found through its end record.
+void walk_central_directory(ByteSource& source, Evidence* evidence) {
+  const uint64_t size = source.size();
+  if (size == kUnknownSize || size < kEndOfDirectorySize) {
+    return;
+  }
+  uint8_t tail[kZipTailRead];
+  const size_t tail_length =
+      static_cast<size_t>(std::min<uint64_t>(size, sizeof(tail)));
+  source.will_need(size - tail_length, tail_length);
+  if (source.read(size - tail_length, tail, tail_length) != tail_length) {
+    return;
+  }
+
+  // The end record sits at the very end unless the archive has a comment.
+  const uint8_t* end = nullptr;
+  for (size_t pos = tail_length - kEndOfDirectorySize + 1; pos-- > 0;) {
+    if (le32(tail + pos) == kEndOfDirectorySignature) {
+      end = tail + pos;
+      break;
+    }
+  }
+  if (end == nullptr) {
+    return;
+  }
+  const uint32_t directory_size = le32(end + 12);
+  const uint32_t directory_offset = le32(end + 16);
+  if (directory_offset == 0xFFFFFFFF) {
+    return;  // ZIP64
+  }
+  // Offsets count from the start of the archive, which is not the start of
+  // the file when a stub was prepended without adjusting them (cat stub
+  // archive.zip); the directory then ends where the end record begins.
+  const uint64_t end_position =
+      size - tail_length + static_cast<uint64_t>(end - tail);
+  uint64_t pos = directory_offset;
+  uint8_t signature[4];
+  if (source.read(pos, signature, sizeof(signature)) != sizeof(signature) ||
+      le32(signature) != kCentralHeaderSignature) {
+    if (directory_size > end_position) {
+      return;  // damaged
+    }
+    pos = end_position - directory_size;
+  }
+
+  // Read the directory in tail-sized chunks, reusing the buffer; every chunk
+  // starts at an entry boundary.
+  uint8_t* chunk = tail;
+  const uint64_t limit =
+      pos + std::min<uint64_t>(directory_size, kZipMaxDirectoryRead);
+  source.will_need(pos, limit - pos);
+  while (pos + kCentralHeaderSize <= limit) {
+    const size_t n = source.read(
+        pos, chunk,
+        static_cast<size_t>(std::min<uint64_t>(limit - pos, sizeof(tail))));
+    size_t at = 0;
+    while (at + kCentralHeaderSize <= n) {
+      const uint8_t* entry = chunk + at;
+      if (le32(entry) != kCentralHeaderSignature) {
+        return;
+      }
+      const size_t name_length = le16(entry + 28);
+      if (at + kCentralHeaderSize + name_length > n) {
+        break;
+      }
+      evidence->add_name(std::string_view(
+          reinterpret_cast<const char*>(entry + kCentralHeaderSize),
+          name_length));
+      if (evidence->decided()) {
+        return;
+      }
+      at += kCentralHeaderSize + name_length + le16(entry + 30) +
+            le16(entry + 32);
+    }
+    if (at == 0) {
+      return;  // short read, or an entry larger than the buffer
+    }
+    pos += at;
+  }
+}
+
+}  // namespace
+
+size_t locate_zip_end(ByteView tail) {
+  if (tail.size() < kEndOfDirectorySize) {
+    return kNoCandidate;
+  }
+  for (size_t pos = tail.size() - kEndOfDirectorySize + 1; pos-- > 0;) {
+    const uint8_t* end = tail.data() + pos;
+    if (le32(end) == kEndOfDirectorySignature &&
+        pos + kEndOfDirectorySize + le16(end + 20) == tail.size() &&
+        le16(end + 8) <= le16(end + 10)) {
+      return pos;
+    }
+  }
+  return kNoCandidate;
+}
+
+const Type* refine_zip(ByteSource& source) {
+  Evidence evidence;
+  const bool saw_every_entry = walk_local_headers(source, &evidence);
+  if (!evidence.decided() && !saw_every_entry) {
+    walk_central_directory(source, &evidence);
+  }
+  return evidence.verdict();
+}
+
+}  // namespace internal
+}  // namespace filetype
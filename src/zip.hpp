@@ -0,0 +1,60 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef SRC_ZIP_HPP_
+#define SRC_ZIP_HPP_
+
+#include <cstddef>
+
+#include "byte_source.hpp"
+#include "engine.hpp"
+#include "filetype/byte_view.hpp"
+#include "filetype/type.hpp"
+
+namespace filetype {
+namespace internal {
+
+/// Local file headers inspected before falling back to the central directory.
+constexpr size_t kZipMaxLocalHeaders = 16;
+
+/// Bytes read from the end of the archive when looking for its directory.
+constexpr size_t kZipTailRead = 4096;
+
+/// Central directory bytes inspected at most.
+constexpr size_t kZipMaxDirectoryRead = 16384;
+
+/**
+ * @brief Tell ZIP-based formats apart by their entry names.
+ *
+ * Walks the first local file headers (the stored `mimetype` entry of
+ * OpenDocument and EPUB, `[Content_Types].xml` with `word/`, `xl/` or `ppt/`
+ * entries for Office Open XML, `META-INF/MANIFEST.MF` for JAR,
+ * `AndroidManifest.xml` or `classes.dex` for APK). If that is not conclusive
+ * and the archive size is known, the names in the central directory are
+ * checked, found through the end-of-central-directory record. Only headers
+ * and names are read, never entry data (except the short `mimetype` entry),
+ * and nothing is inflated.
+ *
+ * @return The specific type, or nullptr for a plain ZIP archive.
+ */
+const Type* refine_zip(ByteSource& source);
+
+/**
+ * @brief Find the end-of-central-directory record in the last bytes of a
+ * file.
+ *
+ * Only a record whose comment runs exactly to the end of @p tail counts, as
+ * it does in any archive nothing was appended to; an executable stub or
+ * other data before the archive does not matter.
+ *
+ * @return Offset of the record in @p tail, or kNoCandidate.
+ */
+size_t locate_zip_end(ByteView tail);
+
+/// Refiner attached to the ZIP signature.
+inline constexpr Refiner kZipRefiner{
+    &refine_zip, to_mask(Category::DOCUMENT) | to_mask(Category::ARCHIVE)};
+
+}  // namespace internal
+}  // namespace filetype
+
+#endif  // SRC_ZIP_HPP_
@@ -0,0 +1,168 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/batch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+
+namespace {
+
+std::vector<std::vector<uint8_t>> make_corpus(size_t count) {
+  const std::vector<std::vector<uint8_t>> samples = {
+      {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A},
+      {0x25, 0x50, 0x44, 0x46, 0x2D, 0x31, 0x2E, 0x37},
+      {0xFF, 0xFB, 0x90, 0x64},
+      {0x00, 0x01, 0x02, 0x03},
+      {},
+  };
+  std::vector<std::vector<uint8_t>> corpus;
+  corpus.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    corpus.push_back(samples[i % samples.size()]);
+  }
+  return corpus;
+}
+
+std::vector<filetype::ByteView> views_of(
+    const std::vector<std::vector<uint8_t>>& corpus) {
+  return std::vector<filetype::ByteView>(corpus.begin(), corpus.end());
+}
+
+#if defined(__linux__)
+/// Threads of this process, as /proc reports them.
+size_t thread_count() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  size_t value = 0;
+  while (status >> key) {
+    if (key == "Threads:") {
+      status >> value;
+      break;
+    }
+  }
+  return value;
+}
+#endif
+
+}  // namespace
+
+TEST(BatchTest, ParallelMatchesSequential) {
+  const auto corpus = make_corpus(5000);
+  const auto views = views_of(corpus);
+
+  filetype::BatchOptions options;
+  options.threads = 4;
+  options.sequential_threshold = 0;
+  options.grain = 7;
+  std::vector<const filetype::Type*> results(views.size());
+  filetype::match_batch(views.data(), views.size(), results.data(), options);
+
+  for (size_t i = 0; i < views.size(); ++i) {
+    ASSERT_EQ(results[i], filetype::match(views[i])) << "item " << i;
+  }
+}
+
+TEST(BatchTest, SmallBatchRunsSequentially) {
+  const auto corpus = make_corpus(10);
+  const auto views = views_of(corpus);
+  std::vector<filetype::DetectionResult> results(views.size());
+  filetype::detect_batch(views.data(), views.size(), results.data());
+
+  EXPECT_TRUE(results[0].is_image());
+  EXPECT_TRUE(results[1].is_document());
+  EXPECT_TRUE(results[2].is_audio());
+  EXPECT_FALSE(results[3]);
+  EXPECT_FALSE(results[4]);
+}
+
+TEST(BatchTest, CategoryFilter) {
+  const auto corpus = make_corpus(600);
+  const auto views = views_of(corpus);
+  filetype::BatchOptions options;
+  options.threads = 3;
+  options.categories = filetype::to_mask(filetype::Category::IMAGE);
+  std::vector<const filetype::Type*> results(views.size());
+  filetype::match_batch(views.data(), views.size(), results.data(), options);
+
+  for (size_t i = 0; i < views.size(); ++i) {
+    ASSERT_EQ(results[i], i % 5 == 0 ? &filetype::image::TYPE_PNG : nullptr);
+  }
+}
+
+TEST(BatchTest, ConcurrentCallersShareThePool) {
+  const auto corpus = make_corpus(3000);
+  const auto views = views_of(corpus);
+  filetype::BatchOptions options;
+  options.threads = 2;
+  options.sequential_threshold = 0;
+  options.grain = 16;
+
+  std::vector<std::vector<const filetype::Type*>> results(
+      4, std::vector<const filetype::Type*>(views.size()));
+  std::vector<std::thread> callers;
+  for (auto& out : results) {
+    callers.emplace_back([&views, &out, &options] {
+      filetype::match_batch(views.data(), views.size(), out.data(), options);
+    });
+  }
+  for (std::thread& caller : callers) {
+    caller.join();
+  }
+  for (const auto& out : results) {
+    for (size_t i = 0; i < views.size(); ++i) {
+      ASSERT_EQ(out[i], filetype::match(views[i]));
+    }
+  }
+}
+
+#if defined(__linux__)
+
+TEST(BatchTest, CpuBoundCallsStayOnTheSharedPool) {
+  const auto corpus = make_corpus(3000);
+  const auto views = views_of(corpus);
+  std::vector<const filetype::Type*> results(views.size());
+  filetype::BatchOptions options;
+  options.sequential_threshold = 0;
+  options.grain = 16;
+  options.threads = 2;
+  // Start the shared pool; no call after this may add a thread.
+  filetype::match_batch(views.data(), views.size(), results.data(), options);
+  const size_t before = thread_count();
+  for (size_t threads : {2u, 3u, 5u, 8u, 13u, 40u, 1000u}) {
+    options.threads = threads;
+    filetype::match_batch(views.data(), views.size(), results.data(),
+                          options);
+  }
+  EXPECT_LE(thread_count(), before);
+  for (size_t i = 0; i < views.size(); ++i) {
+    ASSERT_EQ(results[i], filetype::match(views[i]));
+  }
+
+  // Counted while the call is running, not after it has joined anything.
+  std::vector<uint8_t> region;
+  for (size_t i = 0; i < 256; ++i) {
+    region.insert(region.end(), corpus[0].begin(), corpus[0].end());
+    region.resize(region.size() + 56, 'x');
+  }
+  filetype::CarveOptions carve;
+  carve.threads = 1000;
+  carve.chunk_size = 64;
+  size_t during = 0;
+  EXPECT_EQ(filetype::carve(
+                region,
+                [&](const filetype::ScanHit&) {
+                  during = std::max(during, thread_count());
+                },
+                carve),
+            256u);
+  EXPECT_LE(during, before);
+}
+
+#endif
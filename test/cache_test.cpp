@@ -0,0 +1,157 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::kPdf;
+using filetype::test::kPng;
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+}  // namespace
+
+#if !defined(_WIN32)
+
+TEST(CacheTest, HitsUntilTheFileChanges) {
+  const std::string path = temp_path("changes");
+  ASSERT_TRUE(write_file(path, kPng));
+  filetype::DetectionCache cache;
+  std::error_code ec;
+  EXPECT_EQ(cache.match_file(path, ec), &filetype::image::TYPE_PNG);
+  EXPECT_EQ(cache.match_file(path, ec), &filetype::image::TYPE_PNG);
+  EXPECT_FALSE(ec);
+  filetype::CacheStats stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.entries, 1u);
+
+  // A rewrite changes the size, so the file is read again.
+  ASSERT_TRUE(write_file(path, kPdf));
+  EXPECT_EQ(cache.match_file(path, ec), &filetype::document::TYPE_PDF);
+  EXPECT_EQ(cache.detect_file(path, ec).offset, 0u);
+  stats = cache.stats();
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 2u);
+  std::remove(path.c_str());
+
+  // Errors are reported and not cached.
+  EXPECT_EQ(cache.match_file(path, ec), nullptr);
+  EXPECT_TRUE(ec);
+  EXPECT_EQ(cache.stats().misses, 2u);
+
+  cache.clear();
+  stats = cache.stats();
+  EXPECT_EQ(stats.hits + stats.misses + stats.entries, 0u);
+}
+
+TEST(CacheTest, EvictsLeastRecentlyUsed) {
+  std::vector<std::string> paths;
+  for (int i = 0; i < 3; ++i) {
+    paths.push_back(temp_path("lru" + std::to_string(i)));
+    ASSERT_TRUE(write_file(paths.back(), kPng));
+  }
+  filetype::DetectionCache cache(2, 1);
+  std::error_code ec;
+  cache.match_file(paths[0], ec);
+  cache.match_file(paths[1], ec);
+  cache.match_file(paths[0], ec);  // paths[1] is now the oldest
+  cache.match_file(paths[2], ec);
+  EXPECT_EQ(cache.stats().evictions, 1u);
+  EXPECT_EQ(cache.stats().entries, 2u);
+
+  const uint64_t hits = cache.stats().hits;
+  cache.match_file(paths[0], ec);
+  EXPECT_EQ(cache.stats().hits, hits + 1);
+  cache.match_file(paths[1], ec);
+  EXPECT_EQ(cache.stats().hits, hits + 1);
+
+  // The capacity bounds the whole cache, however many shards are asked for.
+  filetype::DetectionCache tiny(1, 16);
+  for (const std::string& path : paths) {
+    tiny.match_file(path, ec);
+  }
+  EXPECT_EQ(tiny.stats().entries, 1u);
+  EXPECT_EQ(tiny.stats().evictions, 2u);
+  for (const std::string& path : paths) {
+    std::remove(path.c_str());
+  }
+}
+
+TEST(CacheTest, RegisteringSignaturesInvalidates) {
+  const std::string path = temp_path("custom");
+  ASSERT_TRUE(write_file(path, {'A', 'C', 'M', 'E', 0, 0, 0, 0}));
+  filetype::DetectionCache cache;
+  std::error_code ec;
+  EXPECT_EQ(cache.match_file(path, ec), nullptr);
+
+  std::vector<uint8_t> image;
+  ASSERT_TRUE(filetype::compile_signatures(
+      "application/x-acme acme archive 0 41434D45", &image));
+  filetype::register_signatures(filetype::SignatureDatabase::load(image, ec));
+  EXPECT_EQ(cache.match_file(path, ec)->extension, "acme");
+  EXPECT_EQ(cache.match_file(path, ec)->extension, "acme");
+
+  // The custom type is gone with its database.
+  filetype::clear_signatures();
+  EXPECT_EQ(cache.match_file(path, ec), nullptr);
+  EXPECT_EQ(cache.stats().hits, 1u);
+  std::remove(path.c_str());
+}
+
+TEST(CacheTest, ConcurrentLookups) {
+  std::vector<std::string> paths;
+  for (int i = 0; i < 8; ++i) {
+    paths.push_back(temp_path("concurrent" + std::to_string(i)));
+    ASSERT_TRUE(write_file(paths.back(), i % 2 ? kPdf : kPng));
+  }
+  filetype::DetectionCache cache(4, 2);
+  std::vector<std::thread> threads;
+  std::atomic<size_t> wrong{0};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      std::error_code ec;
+      for (int i = 0; i < 500; ++i) {
+        const size_t k = (i * 7 + t) % paths.size();
+        const filetype::Type* type = cache.match_file(paths[k], ec);
+        if (type != (k % 2 ? &filetype::document::TYPE_PDF
+                           : &filetype::image::TYPE_PNG)) {
+          wrong.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(wrong.load(), 0u);
+  const filetype::CacheStats stats = cache.stats();
+  EXPECT_EQ(stats.hits + stats.misses, 2000u);
+  EXPECT_LE(stats.entries, 4u);
+  for (const std::string& path : paths) {
+    std::remove(path.c_str());
+  }
+}
+
+#endif
+
+TEST(CacheTest, Disabled) {
+  const std::string path = temp_path("disabled");
+  ASSERT_TRUE(write_file(path, kPng));
+  filetype::DetectionCache cache(0);
+  std::error_code ec;
+  EXPECT_EQ(cache.match_file(path, ec), &filetype::image::TYPE_PNG);
+  EXPECT_EQ(cache.match_file(path, ec), &filetype::image::TYPE_PNG);
+  EXPECT_EQ(cache.stats().hits, 0u);
+  EXPECT_EQ(cache.stats().entries, 0u);
+  std::remove(path.c_str());
+}
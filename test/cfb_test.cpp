@@ -0,0 +1,188 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+constexpr uint32_t kNone = 0xFFFFFFFF;
+constexpr uint32_t kEndOfChain = 0xFFFFFFFE;
+constexpr uint8_t kStorage = 1;
+constexpr uint8_t kStream = 2;
+constexpr uint8_t kRoot = 5;
+
+/// One directory entry; entry 0 is the root storage.
+struct Entry {
+  std::string name;
+  uint8_t type;
+  uint32_t child = kNone;
+  uint32_t right = kNone;
+};
+
+void put16(std::vector<uint8_t>* out, size_t at, uint16_t v) {
+  (*out)[at] = static_cast<uint8_t>(v);
+  (*out)[at + 1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put32(std::vector<uint8_t>* out, size_t at, uint32_t v) {
+  put16(out, at, static_cast<uint16_t>(v));
+  put16(out, at + 2, static_cast<uint16_t>(v >> 16));
+}
+
+/**
+ * Version 3 compound file (512-byte sectors) with the FAT in sector 0 and
+ * the directory stored in the sectors of @p chain, in that order.
+ */
+std::vector<uint8_t> compound_file(const std::vector<Entry>& entries,
+                                   const std::vector<uint32_t>& chain = {1}) {
+  const uint32_t sectors = *std::max_element(chain.begin(), chain.end()) + 1;
+  std::vector<uint8_t> out(512 * (sectors + 1), 0);
+  const uint8_t magic[] = {0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1};
+  std::copy(std::begin(magic), std::end(magic), out.begin());
+  put16(&out, 24, 0x3E);
+  put16(&out, 26, 3);
+  put16(&out, 28, 0xFFFE);
+  put16(&out, 30, 9);
+  put16(&out, 32, 6);
+  put32(&out, 44, 1);
+  put32(&out, 48, chain.front());
+  put32(&out, 56, 4096);
+  put32(&out, 60, kEndOfChain);
+  put32(&out, 68, kEndOfChain);
+  for (size_t i = 0; i < 109; ++i) {
+    put32(&out, 76 + 4 * i, i == 0 ? 0 : kNone);
+  }
+
+  // FAT: sector 0 is the FAT itself, the directory chain links the rest.
+  for (uint32_t s = 0; s < 128; ++s) {
+    put32(&out, 512 + 4 * s, kNone);
+  }
+  put32(&out, 512, 0xFFFFFFFD);
+  for (size_t i = 0; i < chain.size(); ++i) {
+    put32(&out, 512 + 4 * chain[i],
+          i + 1 < chain.size() ? chain[i + 1] : kEndOfChain);
+  }
+
+  for (size_t id = 0; id < entries.size(); ++id) {
+    const Entry& entry = entries[id];
+    const size_t at = 512 * (chain.at(id / 4) + 1) + 128 * (id % 4);
+    for (size_t i = 0; i < entry.name.size(); ++i) {
+      put16(&out, at + 2 * i, static_cast<uint8_t>(entry.name[i]));
+    }
+    put16(&out, at + 64, static_cast<uint16_t>(2 * entry.name.size() + 2));
+    out[at + 66] = entry.type;
+    put32(&out, at + 68, kNone);
+    put32(&out, at + 72, entry.right);
+    put32(&out, at + 76, entry.child);
+  }
+  return out;
+}
+
+/// Root holding @p names as streams, linked as a chain of right siblings.
+std::vector<Entry> root_streams(std::initializer_list<std::string> names) {
+  std::vector<Entry> entries{Entry{"Root Entry", kRoot, 1}};
+  for (const std::string& name : names) {
+    entries.push_back(Entry{name, kStream});
+    entries.back().right = static_cast<uint32_t>(entries.size());
+  }
+  entries.back().right = kNone;
+  return entries;
+}
+
+}  // namespace
+
+TEST(CfbTest, OfficeDocuments) {
+  EXPECT_EQ(filetype::match(compound_file(root_streams(
+                {"\x05SummaryInformation", "1Table", "WordDocument"}))),
+            &filetype::document::TYPE_DOC);
+  EXPECT_EQ(filetype::match(compound_file(root_streams({"Workbook"}))),
+            &filetype::document::TYPE_XLS);
+  EXPECT_EQ(filetype::match(compound_file(root_streams({"Book"}))),
+            &filetype::document::TYPE_XLS);
+  EXPECT_EQ(filetype::match(compound_file(
+                root_streams({"Current User", "PowerPoint Document"}))),
+            &filetype::document::TYPE_PPT);
+}
+
+TEST(CfbTest, OutlookMessage) {
+  const auto msg = compound_file(root_streams(
+      {"__nameid_version1.0", "__properties_version1.0",
+       "__substg1.0_0037001F", "__substg1.0_1000001F"}),
+      {1, 2});
+  EXPECT_EQ(filetype::match(msg), &filetype::document::TYPE_MSG);
+  EXPECT_TRUE(filetype::is_document(msg));
+}
+
+TEST(CfbTest, EmbeddedStreamsIgnored) {
+  // A workbook with an embedded Word document in a sub-storage.
+  std::vector<Entry> entries = root_streams({"MBD0001", "Workbook"});
+  entries[1].type = kStorage;
+  entries[1].child = 3;
+  entries.push_back(Entry{"WordDocument", kStream});
+  EXPECT_EQ(filetype::match(compound_file(entries)),
+            &filetype::document::TYPE_XLS);
+}
+
+TEST(CfbTest, DirectoryChain) {
+  // Ten entries over three directory sectors, stored out of order.
+  const auto doc = compound_file(
+      root_streams({"a", "b", "c", "d", "e", "f", "g", "h", "WordDocument"}),
+      {3, 1, 2});
+  EXPECT_EQ(filetype::match(doc), &filetype::document::TYPE_DOC);
+}
+
+TEST(CfbTest, UnknownOrUnreachable) {
+  // Other compound files (MSI, thumbnail caches, ...) keep the DOC label.
+  const auto other = compound_file(root_streams({"\x05SummaryInformation"}));
+  EXPECT_EQ(filetype::match(other), &filetype::document::TYPE_DOC);
+
+  // A prefix that ends before the directory.
+  const auto xls = compound_file(root_streams({"Workbook"}));
+  EXPECT_EQ(filetype::match(filetype::ByteView(xls).subview(0, 512)),
+            &filetype::document::TYPE_DOC);
+}
+
+TEST(CfbTest, MalformedStructuresTerminate) {
+  // The directory chain loops back on itself.
+  auto looped = compound_file(
+      root_streams({"a", "b", "c", "d", "e", "f", "g", "h", "WordDocument"}),
+      {1, 2, 3});
+  put32(&looped, 512 + 4 * 2, 1);
+  EXPECT_EQ(filetype::match(looped), &filetype::document::TYPE_DOC);
+
+  // Sibling links form a cycle.
+  std::vector<Entry> entries = root_streams({"a", "b"});
+  entries[2].right = 1;
+  EXPECT_EQ(filetype::match(compound_file(entries)),
+            &filetype::document::TYPE_DOC);
+
+  // Directory sector numbers far past the end of the data.
+  auto stray = compound_file(root_streams({"Workbook"}));
+  put32(&stray, 48, 0x00FFFFFF);
+  EXPECT_EQ(filetype::match(stray), &filetype::document::TYPE_DOC);
+}
+
+TEST(CfbTest, MatchFile) {
+  const auto ppt = compound_file(
+      root_streams({"a", "b", "c", "d", "PowerPoint Document"}), {2, 1});
+  const std::string path = temp_path("slides.ppt");
+  ASSERT_TRUE(write_file(path, ppt));
+
+  std::error_code ec;
+  EXPECT_EQ(filetype::match_file(path, ec), &filetype::document::TYPE_PPT);
+  EXPECT_FALSE(ec);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,258 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+using filetype::test::dmg;
+using filetype::test::kPdf;
+using filetype::test::kPng;
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+/// A small tree under the test's temporary directory, removed at the end.
+class Tree {
+ public:
+  explicit Tree(const std::string& name) : root_(temp_path(name)) {
+    std::filesystem::remove_all(root_);
+    std::filesystem::create_directories(root_ + "/sub/deep");
+    EXPECT_TRUE(write_file(root_ + "/a.png", kPng));
+    EXPECT_TRUE(write_file(root_ + "/empty.bin", {}));
+    EXPECT_TRUE(write_file(root_ + "/big.dmg", dmg(100000)));
+    EXPECT_TRUE(write_file(root_ + "/sub/b.pdf", kPdf));
+    EXPECT_TRUE(write_file(root_ + "/sub/deep/c.PNG", kPng));
+    EXPECT_TRUE(write_file(root_ + "/sub/deep/notes.txt", {'h', 'i', '\n'}));
+  }
+
+  ~Tree() { std::filesystem::remove_all(root_); }
+
+  const std::string& root() const { return root_; }
+
+ private:
+  std::string root_;
+};
+
+/// @p part repeated @p count times.
+std::string repeat(const std::string& part, size_t count) {
+  std::string out;
+  for (size_t i = 0; i < count; ++i) {
+    out += part;
+  }
+  return out;
+}
+
+/// Paths below @p root mapped to their detected type.
+std::map<std::string, const filetype::Type*> scan(
+    const std::string& root, const filetype::DirectoryScanOptions& options =
+                                 filetype::DirectoryScanOptions()) {
+  std::map<std::string, const filetype::Type*> found;
+  const size_t prefix = root.back() == '/' ? root.size() : root.size() + 1;
+  std::error_code ec;
+  const size_t reported = filetype::scan_directory(
+      root,
+      [&](const filetype::DirectoryEntry& entry) {
+        EXPECT_FALSE(entry.ec) << entry.path << ": " << entry.ec.message();
+        const std::string path(entry.path.substr(prefix));
+        EXPECT_TRUE(found.emplace(path, entry.result.type).second) << path;
+      },
+      ec, options);
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(reported, found.size());
+  return found;
+}
+
+}  // namespace
+
+TEST(DirectoryTest, ReportsEveryFile) {
+  const Tree tree("every");
+  const auto found = scan(tree.root());
+  const std::map<std::string, const filetype::Type*> expected = {
+      {"a.png", &filetype::image::TYPE_PNG},
+      {"big.dmg", &filetype::archive::TYPE_DMG},
+      {"empty.bin", nullptr},
+      {"sub/b.pdf", &filetype::document::TYPE_PDF},
+      {"sub/deep/c.PNG", &filetype::image::TYPE_PNG},
+      {"sub/deep/notes.txt", nullptr},
+  };
+  EXPECT_EQ(found, expected);
+
+  // A trailing separator on the root makes no difference.
+  EXPECT_EQ(scan(tree.root() + "/"), expected);
+}
+
+TEST(DirectoryTest, Filters) {
+  const Tree tree("filters");
+  filetype::DirectoryScanOptions options;
+  options.include_extensions = {"png"};
+  auto found = scan(tree.root(), options);
+  ASSERT_EQ(found.size(), 2u);
+  EXPECT_EQ(found.count("sub/deep/c.PNG"), 1u);
+
+  options = filetype::DirectoryScanOptions();
+  options.exclude_extensions = {".PNG", "txt"};
+  found = scan(tree.root(), options);
+  EXPECT_EQ(found.size(), 3u);
+  EXPECT_EQ(found.count("a.png"), 0u);
+
+  options = filetype::DirectoryScanOptions();
+  options.min_size = 1;
+  options.max_size = 1000;
+  found = scan(tree.root(), options);
+  EXPECT_EQ(found.size(), 4u);
+  EXPECT_EQ(found.count("empty.bin"), 0u);
+  EXPECT_EQ(found.count("big.dmg"), 0u);
+
+  options = filetype::DirectoryScanOptions();
+  options.categories = filetype::to_mask(filetype::Category::IMAGE) |
+                       filetype::to_mask(filetype::Category::ARCHIVE);
+  options.include_unknown = false;
+  found = scan(tree.root(), options);
+  const std::map<std::string, const filetype::Type*> expected = {
+      {"a.png", &filetype::image::TYPE_PNG},
+      {"big.dmg", &filetype::archive::TYPE_DMG},
+      {"sub/deep/c.PNG", &filetype::image::TYPE_PNG},
+  };
+  EXPECT_EQ(found, expected);
+}
+
+#if !defined(_WIN32)
+
+TEST(DirectoryTest, SymbolicLinks) {
+  const Tree tree("links");
+  std::filesystem::create_directory_symlink(tree.root() + "/sub",
+                                            tree.root() + "/alias");
+  std::filesystem::create_symlink(tree.root() + "/a.png",
+                                  tree.root() + "/sub/a_link.png");
+  // Links back up the tree are not followed.
+  std::filesystem::create_directory_symlink(tree.root(),
+                                            tree.root() + "/sub/deep/up");
+
+  auto found = scan(tree.root());
+  EXPECT_EQ(found.size(), 6u);
+
+  filetype::DirectoryScanOptions options;
+  options.follow_symlinks = true;
+  found = scan(tree.root(), options);
+  EXPECT_EQ(found.count("alias/deep/c.PNG"), 1u);
+  EXPECT_EQ(found["sub/a_link.png"], &filetype::image::TYPE_PNG);
+  EXPECT_EQ(found.count("sub/deep/up/a.png"), 0u);
+  EXPECT_EQ(found.size(), 6u + 1u + 4u);
+}
+
+TEST(DirectoryTest, TreesDeeperThanTheDescriptorLimit) {
+  const Tree tree("deep");
+  // 300 levels, with a link half way down to 150 more outside the tree.
+  const std::string other = temp_path("other");
+  std::filesystem::remove_all(other);
+  std::filesystem::create_directories(tree.root() + repeat("/d", 300));
+  std::filesystem::create_directories(other + repeat("/o", 150));
+  ASSERT_TRUE(
+      write_file(tree.root() + repeat("/d", 300) + "/bottom.png", kPng));
+  ASSERT_TRUE(write_file(other + repeat("/o", 150) + "/linked.pdf", kPdf));
+  std::filesystem::create_directory_symlink(
+      other, tree.root() + repeat("/d", 150) + "/link");
+
+  rlimit limit;
+  ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &limit), 0);
+  rlimit lowered = limit;
+  lowered.rlim_cur = 64;
+  ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &lowered), 0);
+  filetype::DirectoryScanOptions options;
+  options.threads = 2;
+  auto found = scan(tree.root(), options);
+  options.follow_symlinks = true;
+  auto followed = scan(tree.root(), options);
+  ::setrlimit(RLIMIT_NOFILE, &limit);
+
+  EXPECT_EQ(found.size(), 6u + 1u);
+  EXPECT_EQ(found[repeat("d/", 300) + "bottom.png"],
+            &filetype::image::TYPE_PNG);
+  EXPECT_EQ(followed.size(), 6u + 2u);
+  EXPECT_EQ(followed[repeat("d/", 150) + "link/" + repeat("o/", 150) +
+                     "linked.pdf"],
+            &filetype::document::TYPE_PDF);
+  std::filesystem::remove_all(other);
+}
+
+TEST(DirectoryTest, FilesReplacedByFifos) {
+  const Tree tree("fifos");
+  const std::string flat = tree.root() + "/flat";
+  std::filesystem::create_directory(flat);
+  std::vector<std::string> names;
+  for (size_t i = 0; i < 8; ++i) {
+    names.push_back(flat + "/" + std::to_string(i) + ".png");
+    ASSERT_TRUE(write_file(names.back(), kPng));
+  }
+  filetype::DirectoryScanOptions options;
+  options.threads = 1;
+  std::vector<std::string> reported;
+  std::error_code ec;
+  // Once the first file is reported, every other one becomes a FIFO with no
+  // writer, whether or not the walk has listed it yet. None may be waited on.
+  filetype::scan_directory(
+      flat,
+      [&](const filetype::DirectoryEntry& entry) {
+        EXPECT_FALSE(entry.ec) << entry.path << ": " << entry.ec.message();
+        reported.emplace_back(entry.path);
+        if (reported.size() == 1) {
+          for (const std::string& name : names) {
+            if (name != entry.path) {
+              std::filesystem::remove(name);
+              EXPECT_EQ(::mkfifo(name.c_str(), 0600), 0) << name;
+            }
+          }
+        }
+      },
+      ec, options);
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(reported.size(), 1u);
+}
+
+#endif
+
+TEST(DirectoryTest, ManyFilesThroughASmallQueue) {
+  const Tree tree("many");
+  const std::string wide = tree.root() + "/wide";
+  std::filesystem::create_directory(wide);
+  for (size_t i = 0; i < 2000; ++i) {
+    ASSERT_TRUE(write_file(wide + "/" + std::to_string(i) + ".png", kPng));
+  }
+  filetype::DirectoryScanOptions options;
+  options.queue_capacity = 1;
+  options.threads = 3;
+  options.include_extensions = {"png"};
+  const auto found = scan(tree.root(), options);
+  EXPECT_EQ(found.size(), 2000u + 2u);
+  for (const auto& [path, type] : found) {
+    EXPECT_EQ(type, &filetype::image::TYPE_PNG) << path;
+  }
+}
+
+TEST(DirectoryTest, RootErrors) {
+  const Tree tree("errors");
+  size_t calls = 0;
+  const filetype::DirectorySink count = [&](const filetype::DirectoryEntry&) {
+    ++calls;
+  };
+  std::error_code ec;
+  EXPECT_EQ(filetype::scan_directory(tree.root() + "/missing", count, ec), 0u);
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+#if !defined(_WIN32)
+  EXPECT_EQ(filetype::scan_directory(tree.root() + "/a.png", count, ec), 0u);
+  EXPECT_EQ(ec, std::errc::not_a_directory);
+#endif
+  EXPECT_EQ(calls, 0u);
+}
@@ -0,0 +1,103 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+
+namespace {
+
+/// One element of the EBML header with a one-byte size.
+struct Element {
+  std::initializer_list<uint8_t> id;
+  std::string_view data;
+};
+
+/// EBML header holding @p elements, followed by the start of a Segment.
+std::vector<uint8_t> ebml(std::initializer_list<Element> elements) {
+  std::vector<uint8_t> body;
+  for (const Element& element : elements) {
+    body.insert(body.end(), element.id);
+    body.push_back(static_cast<uint8_t>(0x80 | element.data.size()));
+    body.insert(body.end(), element.data.begin(), element.data.end());
+  }
+  std::vector<uint8_t> out = {0x1A, 0x45, 0xDF, 0xA3,
+                              static_cast<uint8_t>(0x80 | body.size())};
+  out.insert(out.end(), body.begin(), body.end());
+  out.insert(out.end(), {0x18, 0x53, 0x80, 0x67, 0x01, 0xFF});
+  return out;
+}
+
+std::vector<uint8_t> with_doc_type(std::string_view doc_type) {
+  return ebml({{{0x42, 0x86}, "\x01"},
+               {{0x42, 0xF7}, "\x01"},
+               {{0x42, 0xF2}, "\x04"},
+               {{0x42, 0xF3}, "\x08"},
+               {{0x42, 0x82}, doc_type},
+               {{0x42, 0x87}, "\x04"},
+               {{0x42, 0x85}, "\x02"}});
+}
+
+}  // namespace
+
+TEST(EbmlTest, DocType) {
+  EXPECT_EQ(filetype::match(with_doc_type("webm")),
+            &filetype::video::TYPE_WEBM);
+  EXPECT_EQ(filetype::match(with_doc_type("matroska")),
+            &filetype::video::TYPE_MKV);
+  EXPECT_EQ(filetype::match(with_doc_type(std::string_view("webm\0\0", 6))),
+            &filetype::video::TYPE_WEBM);
+  EXPECT_TRUE(filetype::is_video(with_doc_type("webm")));
+}
+
+TEST(EbmlTest, MultiByteSizes) {
+  // DocType with an eight-byte size field.
+  std::vector<uint8_t> webm = {0x1A, 0x45, 0xDF, 0xA3, 0x01, 0x00, 0x00, 0x00,
+                               0x00, 0x00, 0x00, 0x13, 0x42, 0x86, 0x81, 0x01,
+                               0x42, 0x82, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+                               0x00, 0x04, 'w',  'e',  'b',  'm'};
+  EXPECT_EQ(filetype::match(webm), &filetype::video::TYPE_WEBM);
+}
+
+TEST(EbmlTest, UndecidedStaysMatroska) {
+  // No DocType at all.
+  EXPECT_EQ(filetype::match(ebml({{{0x42, 0x86}, "\x01"}})),
+            &filetype::video::TYPE_MKV);
+
+  // Unknown DocType.
+  EXPECT_EQ(filetype::match(with_doc_type("webmx")),
+            &filetype::video::TYPE_MKV);
+
+  // Buffer ends inside the header.
+  const auto webm = with_doc_type("webm");
+  EXPECT_EQ(filetype::match(filetype::ByteView(webm).subview(0, 20)),
+            &filetype::video::TYPE_MKV);
+
+  // A Void element pushes the DocType past the read budget.
+  const std::string padding(60, '\0');
+  EXPECT_EQ(filetype::match(ebml({{{0xEC}, padding}, {{0x42, 0x82}, "webm"}})),
+            &filetype::video::TYPE_MKV);
+
+  // An element claiming more bytes than the header holds.
+  std::vector<uint8_t> broken = with_doc_type("webm");
+  broken[5 + 3 * 4 + 2] = 0xC0;
+  EXPECT_EQ(filetype::match(broken), &filetype::video::TYPE_MKV);
+}
+
+TEST(EbmlTest, Stream) {
+  std::vector<uint8_t> webm = with_doc_type("webm");
+  webm.resize(4096, 0);
+  filetype::StreamDetector detector;
+  for (size_t pos = 0; pos < webm.size() && detector.status().need_more();
+       pos += 16) {
+    detector.feed(filetype::ByteView(webm).subview(pos, 16));
+  }
+  ASSERT_TRUE(detector.status().detected());
+  EXPECT_EQ(detector.status().type, &filetype::video::TYPE_WEBM);
+  // Decided once TAR's magic at offset 257 is ruled out, well before the
+  // container window.
+  EXPECT_LT(detector.consumed(), filetype::STREAM_REFINE_WINDOW);
+}
@@ -0,0 +1,136 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::dmg;
+using filetype::test::kPdf;
+using filetype::test::kPng;
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+struct Outcome {
+  size_t calls = 0;
+  filetype::DetectionResult result;
+  std::error_code ec;
+};
+
+/// detect_files() collecting one Outcome per path.
+std::vector<Outcome> run(const std::vector<std::string>& paths,
+                         const filetype::FileBatchOptions& options) {
+  std::vector<Outcome> outcomes(paths.size());
+  std::mutex mutex;
+  filetype::detect_files(
+      paths,
+      [&](size_t index, const filetype::DetectionResult& result,
+          const std::error_code& ec) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Outcome& outcome = outcomes.at(index);
+        ++outcome.calls;
+        outcome.result = result;
+        outcome.ec = ec;
+      },
+      options);
+  return outcomes;
+}
+
+}  // namespace
+
+TEST(FileBatchTest, MatchesDetectFile) {
+  const std::vector<std::string> paths = {
+      temp_path("png"), temp_path("pdf"),     temp_path("dmg"),
+      temp_path("empty"), temp_path("missing"), ::testing::TempDir()};
+  ASSERT_TRUE(write_file(paths[0], kPng));
+  ASSERT_TRUE(write_file(paths[1], kPdf));
+  ASSERT_TRUE(write_file(paths[2], dmg(100000)));
+  ASSERT_TRUE(write_file(paths[3], {}));
+
+  for (bool io_uring : {true, false}) {
+    filetype::FileBatchOptions options;
+    options.use_io_uring = io_uring;
+    const std::vector<Outcome> outcomes = run(paths, options);
+    for (size_t i = 0; i < paths.size(); ++i) {
+      std::error_code ec;
+      const filetype::DetectionResult expected =
+          filetype::detect_file(paths[i], ec);
+      EXPECT_EQ(outcomes[i].calls, 1u) << paths[i];
+      EXPECT_EQ(outcomes[i].result.type, expected.type) << paths[i];
+      EXPECT_EQ(outcomes[i].result.offset, expected.offset) << paths[i];
+      EXPECT_EQ(outcomes[i].ec, ec) << paths[i] << " " << io_uring;
+    }
+    EXPECT_EQ(outcomes[0].result.type, &filetype::image::TYPE_PNG);
+    EXPECT_EQ(outcomes[2].result.type, &filetype::archive::TYPE_DMG);
+    EXPECT_EQ(outcomes[4].ec, std::errc::no_such_file_or_directory);
+  }
+  for (size_t i = 0; i < 4; ++i) {
+    std::remove(paths[i].c_str());
+  }
+}
+
+TEST(FileBatchTest, ManyFilesThroughFewSlots) {
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < 300; ++i) {
+    paths.push_back(temp_path("many_" + std::to_string(i)));
+    ASSERT_TRUE(write_file(paths.back(), i % 3 == 0   ? kPng
+                                         : i % 3 == 1 ? kPdf
+                                                      : dmg(i * 50)));
+  }
+  for (bool io_uring : {true, false}) {
+    for (size_t threads : {1u, 3u}) {
+      filetype::FileBatchOptions options;
+      options.use_io_uring = io_uring;
+      options.threads = threads;
+      options.queue_depth = 8;
+      const std::vector<Outcome> outcomes = run(paths, options);
+      for (size_t i = 0; i < paths.size(); ++i) {
+        const filetype::Type* expected =
+            i % 3 == 0   ? &filetype::image::TYPE_PNG
+            : i % 3 == 1 ? &filetype::document::TYPE_PDF
+                         : &filetype::archive::TYPE_DMG;
+        ASSERT_EQ(outcomes[i].calls, 1u) << i;
+        EXPECT_EQ(outcomes[i].result.type, expected) << i;
+        EXPECT_FALSE(outcomes[i].ec);
+      }
+    }
+  }
+  for (const std::string& path : paths) {
+    std::remove(path.c_str());
+  }
+}
+
+TEST(FileBatchTest, CategoryFilter) {
+  const std::vector<std::string> paths = {temp_path("filter_png"),
+                                          temp_path("filter_pdf")};
+  ASSERT_TRUE(write_file(paths[0], kPng));
+  ASSERT_TRUE(write_file(paths[1], kPdf));
+  for (bool io_uring : {true, false}) {
+    filetype::FileBatchOptions options;
+    options.use_io_uring = io_uring;
+    options.categories = filetype::to_mask(filetype::Category::DOCUMENT);
+    const std::vector<Outcome> outcomes = run(paths, options);
+    EXPECT_EQ(outcomes[0].result.type, nullptr);
+    EXPECT_EQ(outcomes[1].result.type, &filetype::document::TYPE_PDF);
+  }
+  for (const std::string& path : paths) {
+    std::remove(path.c_str());
+  }
+}
+
+TEST(FileBatchTest, NoPaths) {
+  size_t calls = 0;
+  filetype::detect_files(nullptr, 0,
+                         [&](size_t, const filetype::DetectionResult&,
+                             const std::error_code&) { ++calls; });
+  EXPECT_EQ(calls, 0u);
+}
@@ -4,8 +4,23 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+}  // namespace
+
 class FileTypeTest : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -83,6 +98,210 @@ TEST_F(FileTypeTest, TypeComparison) {
   EXPECT_FALSE(filetype::is(png_data, filetype::image::TYPE_JPEG));
 }
 
+TEST_F(FileTypeTest, DetectPreviouslyUnmatchedFormats) {
+  const std::vector<std::pair<std::vector<uint8_t>, const filetype::Type*>>
+      cases = {
+          {{0x42, 0x4D, 0x36, 0x00}, &filetype::image::TYPE_BMP},
+          {{0x38, 0x42, 0x50, 0x53}, &filetype::image::TYPE_PSD},
+          {{0x00, 0x00, 0x01, 0x00}, &filetype::image::TYPE_ICO},
+          {{0x37, 0x7A, 0xBC, 0xAF, 0x27, 0x1C}, &filetype::archive::TYPE_7Z},
+          {{0x1F, 0x8B, 0x08, 0x00}, &filetype::archive::TYPE_GZ},
+          {{0x42, 0x5A, 0x68, 0x39}, &filetype::archive::TYPE_BZ2},
+          {{0x4C, 0x5A, 0x49, 0x50}, &filetype::archive::TYPE_LZ},
+          {{0x66, 0x4C, 0x61, 0x43}, &filetype::audio::TYPE_FLAC},
+          {{0x4F, 0x67, 0x67, 0x53}, &filetype::audio::TYPE_OGG},
+          {{0x4D, 0x54, 0x68, 0x64}, &filetype::audio::TYPE_MIDI},
+          {{0x46, 0x4C, 0x56, 0x01}, &filetype::video::TYPE_FLV},
+          {{0x00, 0x00, 0x01, 0xBA}, &filetype::video::TYPE_MPEG},
+      };
+  for (const auto& [data, expected] : cases) {
+    EXPECT_EQ(filetype::match(data), expected) << expected->extension;
+  }
+}
+
+TEST_F(FileTypeTest, PrefersLongestSignature) {
+  // CR2 starts with the little-endian TIFF header.
+  std::vector<uint8_t> cr2 = {0x49, 0x49, 0x2A, 0x00, 0x10, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> tiff = {0x49, 0x49, 0x2A, 0x00, 0x08, 0x00, 0x00, 0x00};
+  EXPECT_EQ(filetype::match(cr2), &filetype::image::TYPE_CR2);
+  EXPECT_EQ(filetype::match(tiff), &filetype::image::TYPE_TIFF);
+}
+
+TEST_F(FileTypeTest, DetectTarAtOffset) {
+  std::vector<uint8_t> tar(512, 0x00);
+  const char name[] = "BM-notes.txt";
+  std::copy(name, name + sizeof(name) - 1, tar.begin());
+  const char ustar[] = "ustar";
+  std::copy(ustar, ustar + 5, tar.begin() + 257);
+  EXPECT_EQ(filetype::match(tar), &filetype::archive::TYPE_TAR);
+  EXPECT_TRUE(filetype::is_archive(tar));
+}
+
+TEST_F(FileTypeTest, DetectRiffWithRealChunkSize) {
+  std::vector<uint8_t> wav = {0x52, 0x49, 0x46, 0x46, 0x24, 0x08, 0x00, 0x00,
+                              0x57, 0x41, 0x56, 0x45, 0x66, 0x6D, 0x74, 0x20};
+  std::vector<uint8_t> webp = {0x52, 0x49, 0x46, 0x46, 0x1A, 0x4F, 0x01, 0x00,
+                               0x57, 0x45, 0x42, 0x50, 0x56, 0x50, 0x38, 0x20};
+  std::vector<uint8_t> avi = {0x52, 0x49, 0x46, 0x46, 0x10, 0x22, 0x3C, 0x00,
+                              0x41, 0x56, 0x49, 0x20, 0x4C, 0x49, 0x53, 0x54};
+  std::vector<uint8_t> aiff = {0x46, 0x4F, 0x52, 0x4D, 0x00, 0x01, 0x7A, 0x2E,
+                               0x41, 0x49, 0x46, 0x46, 0x43, 0x4F, 0x4D, 0x4D};
+  EXPECT_EQ(filetype::match(wav), &filetype::audio::TYPE_WAV);
+  EXPECT_EQ(filetype::match(webp), &filetype::image::TYPE_WEBP);
+  EXPECT_EQ(filetype::match(avi), &filetype::video::TYPE_AVI);
+  EXPECT_EQ(filetype::match(aiff), &filetype::audio::TYPE_AIFF);
+}
+
+TEST_F(FileTypeTest, DetectFtypWithAnyBoxSize) {
+  std::vector<uint8_t> mp4 = {0x00, 0x00, 0x00, 0x20, 0x66, 0x74, 0x79, 0x70,
+                              0x69, 0x73, 0x6F, 0x6D, 0x00, 0x00, 0x02, 0x00};
+  std::vector<uint8_t> heic = {0x00, 0x00, 0x00, 0x1C, 0x66, 0x74, 0x79, 0x70,
+                               0x68, 0x65, 0x69, 0x63, 0x00, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> mov = {0x00, 0x00, 0x00, 0x20, 0x66, 0x74, 0x79, 0x70,
+                              0x71, 0x74, 0x20, 0x20, 0x20, 0x05, 0x03, 0x00};
+  EXPECT_EQ(filetype::match(mp4), &filetype::video::TYPE_MP4);
+  EXPECT_EQ(filetype::match(heic), &filetype::image::TYPE_HEIC);
+  EXPECT_EQ(filetype::match(mov), &filetype::video::TYPE_MOV);
+}
+
+TEST_F(FileTypeTest, MaskedSignatureNeedsFullLength) {
+  // "RIFF" plus a chunk size is not enough to tell WAV from WebP or AVI.
+  std::vector<uint8_t> riff = {0x52, 0x49, 0x46, 0x46, 0x24, 0x08, 0x00, 0x00};
+  EXPECT_EQ(filetype::match(riff), nullptr);
+}
+
+TEST_F(FileTypeTest, BorrowedBufferOverloads) {
+  // A PNG header embedded in the middle of a larger blob.
+  std::vector<uint8_t> blob(4, 0xAA);
+  blob.insert(blob.end(), png_data.begin(), png_data.end());
+  const uint8_t* slice = blob.data() + 4;
+
+  EXPECT_EQ(filetype::match(slice, png_data.size()),
+            &filetype::image::TYPE_PNG);
+  EXPECT_EQ(filetype::match(filetype::ByteView(blob).subview(4)),
+            &filetype::image::TYPE_PNG);
+  EXPECT_TRUE(filetype::is_image(slice, png_data.size()));
+  EXPECT_TRUE(filetype::is(slice, png_data.size(), filetype::image::TYPE_PNG));
+  EXPECT_EQ(filetype::matcher::match_image(slice, png_data.size()),
+            &filetype::image::TYPE_PNG);
+  EXPECT_EQ(filetype::match(blob.data(), 0), nullptr);
+
+  const std::string_view pdf("%PDF-1.7\n");
+  EXPECT_EQ(filetype::match(pdf), &filetype::document::TYPE_PDF);
+  EXPECT_TRUE(filetype::is_document(pdf));
+}
+
+TEST_F(FileTypeTest, MatchMagicHelpers) {
+  EXPECT_TRUE(filetype::match_magic(png_data, filetype::image::PNG_MAGIC));
+  EXPECT_TRUE(filetype::is_type(png_data, filetype::image::PNG_MAGIC));
+  EXPECT_FALSE(filetype::match_magic(png_data, filetype::image::PNG_MAGIC, 1));
+  EXPECT_TRUE(filetype::is_valid_buffer(png_data));
+  EXPECT_FALSE(filetype::is_valid_buffer(mp3_data));
+  // Only the size counts, not whether the vector has allocated.
+  EXPECT_TRUE(filetype::is_valid_buffer(empty_buffer, 0));
+  EXPECT_FALSE(filetype::is_valid_buffer(empty_buffer, 1));
+  std::vector<uint8_t> reserved;
+  reserved.reserve(16);
+  EXPECT_TRUE(filetype::is_valid_buffer(reserved, 0));
+  EXPECT_FALSE(filetype::is_valid_buffer(reserved, 1));
+
+  // The helpers in filetype::types forward to the same definitions.
+  EXPECT_TRUE(
+      filetype::types::match_magic(png_data, filetype::types::PNG_MAGIC));
+  EXPECT_FALSE(
+      filetype::types::match_magic(png_data, filetype::types::PNG_MAGIC, 1));
+  EXPECT_TRUE(filetype::types::is_valid_buffer(png_data));
+  EXPECT_FALSE(filetype::types::is_valid_buffer(mp3_data));
+}
+
+TEST_F(FileTypeTest, TypeIsLiteral) {
+  static_assert(filetype::image::TYPE_PNG.id == filetype::TypeId::PNG);
+  static_assert(filetype::image::TYPE_PNG.category ==
+                filetype::Category::IMAGE);
+  static_assert(filetype::image::TYPE_PNG != filetype::image::TYPE_JPEG);
+  static_assert(filetype::archive::TYPE_GZ != filetype::archive::TYPE_GZIP);
+  EXPECT_EQ(filetype::archive::TYPE_GZ.mime, "application/gzip");
+}
+
+TEST_F(FileTypeTest, TypeFromId) {
+  EXPECT_EQ(filetype::type_from_id(filetype::TypeId::PNG),
+            &filetype::image::TYPE_PNG);
+  EXPECT_EQ(filetype::type_from_id(filetype::TypeId::TXT),
+            &filetype::document::TYPE_TXT);
+  EXPECT_EQ(filetype::type_from_id(filetype::TypeId::UNKNOWN), nullptr);
+  EXPECT_EQ(filetype::type_from_id(filetype::TypeId::CUSTOM), nullptr);
+  EXPECT_EQ(filetype::type_from_id(filetype::TypeId::COUNT), nullptr);
+}
+
+TEST_F(FileTypeTest, CategoryComesFromType) {
+  std::vector<uint8_t> gz = {0x1F, 0x8B, 0x08, 0x00};
+  EXPECT_TRUE(filetype::is_archive(gz));
+  EXPECT_FALSE(filetype::is_document(gz));
+  EXPECT_EQ(filetype::matcher::match_archive(gz), &filetype::archive::TYPE_GZ);
+  EXPECT_EQ(filetype::matcher::match_document(gz), nullptr);
+}
+
+TEST_F(FileTypeTest, DetectOnce) {
+  const filetype::DetectionResult result = filetype::detect(png_data);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.type, &filetype::image::TYPE_PNG);
+  EXPECT_EQ(result.id(), filetype::TypeId::PNG);
+  EXPECT_TRUE(result.is_image());
+  EXPECT_FALSE(result.is_document());
+  EXPECT_TRUE(result.in(filetype::to_mask(filetype::Category::IMAGE) |
+                        filetype::to_mask(filetype::Category::VIDEO)));
+  EXPECT_EQ(result.offset, 0u);
+  EXPECT_EQ(result.length, filetype::image::PNG_MAGIC.size());
+
+  const filetype::DetectionResult unknown = filetype::detect(invalid_data);
+  EXPECT_FALSE(unknown);
+  EXPECT_EQ(unknown.id(), filetype::TypeId::UNKNOWN);
+  EXPECT_FALSE(unknown.in(filetype::ALL_CATEGORIES));
+}
+
+TEST_F(FileTypeTest, CategoryFilteredMatch) {
+  const filetype::CategoryMask media =
+      filetype::to_mask(filetype::Category::AUDIO) |
+      filetype::to_mask(filetype::Category::VIDEO);
+  EXPECT_EQ(filetype::match(mp3_data, media), &filetype::audio::TYPE_MP3);
+  EXPECT_EQ(filetype::match(png_data, media), nullptr);
+  EXPECT_EQ(filetype::match(png_data, filetype::ALL_CATEGORIES),
+            &filetype::image::TYPE_PNG);
+  EXPECT_EQ(filetype::match(png_data, 0), nullptr);
+
+  // CR2 is an image that also carries a TIFF header; an image-only probe must
+  // still pick the most specific image signature.
+  std::vector<uint8_t> cr2 = {0x49, 0x49, 0x2A, 0x00, 0x10, 0x00, 0x00, 0x00};
+  EXPECT_EQ(filetype::matcher::match_image(cr2), &filetype::image::TYPE_CR2);
+  EXPECT_EQ(filetype::matcher::match_video(cr2), nullptr);
+
+  const filetype::DetectionResult result = filetype::detect(
+      pdf_data, filetype::to_mask(filetype::Category::DOCUMENT));
+  EXPECT_TRUE(result.is_document());
+}
+
+TEST_F(FileTypeTest, MatchFile) {
+  // TAR is identified by bytes 257..261, the deepest built-in signature.
+  std::vector<uint8_t> tar(1024, 0);
+  const std::string_view ustar = "ustar";
+  std::copy(ustar.begin(), ustar.end(), tar.begin() + 257);
+  const std::string path = temp_path("match_file.tar");
+  ASSERT_TRUE(write_file(path, tar));
+
+  std::error_code ec;
+  EXPECT_EQ(filetype::match_file(path, ec), &filetype::archive::TYPE_TAR);
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(filetype::match_file(path), &filetype::archive::TYPE_TAR);
+  EXPECT_EQ(filetype::detect_file(path, ec).offset, 257u);
+  // A cap below the signature depth leaves TAR undetectable.
+  EXPECT_EQ(filetype::match_file(path, 100), nullptr);
+  std::remove(path.c_str());
+
+  EXPECT_EQ(filetype::match_file(path, ec), nullptr);
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  EXPECT_EQ(filetype::match_file(path), nullptr);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
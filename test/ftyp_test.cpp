@@ -0,0 +1,121 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+
+namespace {
+
+void put_be32(std::vector<uint8_t>* out, uint32_t v) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out->push_back(static_cast<uint8_t>(v >> shift));
+  }
+}
+
+/// `ftyp` box with @p major and @p compatible brands, then a `free` box.
+std::vector<uint8_t> ftyp(std::string_view major,
+                          std::initializer_list<std::string_view> compatible) {
+  std::vector<uint8_t> out;
+  put_be32(&out, static_cast<uint32_t>(16 + 4 * compatible.size()));
+  out.insert(out.end(), {'f', 't', 'y', 'p'});
+  out.insert(out.end(), major.begin(), major.end());
+  put_be32(&out, 0);
+  for (std::string_view brand : compatible) {
+    out.insert(out.end(), brand.begin(), brand.end());
+  }
+  put_be32(&out, 16);
+  out.insert(out.end(), {'f', 'r', 'e', 'e'});
+  out.resize(out.size() + 8, 0);
+  return out;
+}
+
+}  // namespace
+
+TEST(FtypTest, MajorBrand) {
+  EXPECT_EQ(filetype::match(ftyp("mp42", {"mp42", "isom"})),
+            &filetype::video::TYPE_MP4);
+  EXPECT_EQ(filetype::match(ftyp("dash", {"iso6", "mp41"})),
+            &filetype::video::TYPE_MP4);
+  EXPECT_EQ(filetype::match(ftyp("M4V ", {"M4V ", "M4A ", "mp42"})),
+            &filetype::video::TYPE_MP4);
+  EXPECT_EQ(filetype::match(ftyp("M4A ", {"M4A ", "mp42", "isom"})),
+            &filetype::audio::TYPE_M4A);
+  EXPECT_EQ(filetype::match(ftyp("qt  ", {"qt  "})),
+            &filetype::video::TYPE_MOV);
+  EXPECT_EQ(filetype::match(ftyp("3gp5", {"3gp5", "isom"})),
+            &filetype::video::TYPE_3GP);
+  EXPECT_EQ(filetype::match(ftyp("heix", {"mif1", "heix"})),
+            &filetype::image::TYPE_HEIC);
+  EXPECT_EQ(filetype::match(ftyp("avif", {"avif", "mif1", "miaf", "MA1B"})),
+            &filetype::image::TYPE_AVIF);
+  EXPECT_EQ(filetype::match(ftyp("crx ", {"crx ", "isom"})),
+            &filetype::image::TYPE_CR3);
+}
+
+TEST(FtypTest, CompatibleBrands) {
+  // Generic major brands defer to the first specific compatible brand.
+  EXPECT_EQ(filetype::match(ftyp("mif1", {"mif1", "miaf", "avif"})),
+            &filetype::image::TYPE_AVIF);
+  EXPECT_EQ(filetype::match(ftyp("mif1", {"mif1", "heic"})),
+            &filetype::image::TYPE_HEIC);
+  EXPECT_EQ(filetype::match(ftyp("isom", {"isom", "3gp4"})),
+            &filetype::video::TYPE_3GP);
+  EXPECT_EQ(filetype::match(ftyp("isom", {"isom", "iso2", "avc1", "mp41"})),
+            &filetype::video::TYPE_MP4);
+
+  // Unknown brands still make an ISO base media file.
+  EXPECT_EQ(filetype::match(ftyp("zzzz", {"yyyy"})),
+            &filetype::video::TYPE_MP4);
+  EXPECT_EQ(filetype::match(ftyp("zzzz", {"yyyy", "M4A "})),
+            &filetype::audio::TYPE_M4A);
+}
+
+TEST(FtypTest, BoxBounds) {
+  // Brands after the end of the box belong to the next box.
+  std::vector<uint8_t> mp4 = ftyp("isom", {"M4A "});
+  mp4[3] = 16;
+  EXPECT_EQ(filetype::match(mp4), &filetype::video::TYPE_MP4);
+
+  // A box cut short by the buffer is read as far as it goes.
+  const auto heic = ftyp("mif1", {"mif1", "heic"});
+  EXPECT_EQ(filetype::match(filetype::ByteView(heic).subview(0, 20)),
+            &filetype::image::TYPE_HEIC);
+  EXPECT_EQ(filetype::match(filetype::ByteView(heic).subview(0, 16)),
+            &filetype::image::TYPE_HEIC);
+}
+
+TEST(FtypTest, CategoryFilter) {
+  const auto avif = ftyp("avif", {"avif", "mif1"});
+  const auto m4a = ftyp("M4A ", {"M4A "});
+  EXPECT_EQ(filetype::matcher::match_image(avif), &filetype::image::TYPE_AVIF);
+  EXPECT_EQ(filetype::matcher::match_video(avif), nullptr);
+  EXPECT_EQ(filetype::matcher::match_audio(m4a), &filetype::audio::TYPE_M4A);
+  EXPECT_EQ(filetype::matcher::match_image(m4a), nullptr);
+  EXPECT_TRUE(filetype::is_image(avif));
+  EXPECT_TRUE(filetype::is_audio(m4a));
+}
+
+TEST(FtypTest, Stream) {
+  std::vector<uint8_t> mov = ftyp("qt  ", {"qt  "});
+  filetype::StreamDetector detector;
+  filetype::StreamStatus status = detector.feed(mov);
+  ASSERT_TRUE(status.need_more());
+  EXPECT_EQ(status.type, &filetype::video::TYPE_MP4);
+  EXPECT_TRUE(detector.finish().detected());
+  EXPECT_EQ(detector.status().type, &filetype::video::TYPE_MOV);
+
+  // Long streams are decided without waiting for the full refine window.
+  mov.resize(filetype::STREAM_REFINE_WINDOW * 2, 0);
+  detector.reset();
+  for (size_t pos = 0; pos < mov.size() && detector.status().need_more();
+       pos += 64) {
+    detector.feed(filetype::ByteView(mov).subview(pos, 64));
+  }
+  ASSERT_TRUE(detector.status().detected());
+  EXPECT_EQ(detector.status().type, &filetype::video::TYPE_MOV);
+  EXPECT_LT(detector.consumed(), filetype::STREAM_REFINE_WINDOW);
+}
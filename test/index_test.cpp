@@ -0,0 +1,283 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::kPdf;
+using filetype::test::kPng;
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+const std::vector<uint8_t> kNoise = {0x01, 0xEE, 0x02, 0xDD, 0x03, 0xCC};
+
+std::shared_ptr<const filetype::DetectionIndex> open_index(
+    const std::string& path) {
+  std::error_code ec;
+  auto index = filetype::DetectionIndex::open(path, ec);
+  EXPECT_FALSE(ec) << ec.message();
+  return index;
+}
+
+}  // namespace
+
+#if !defined(_WIN32)
+
+TEST(IndexTest, RoundTrip) {
+  const std::string png = temp_path("round_trip.png");
+  const std::string noise = temp_path("round_trip.bin");
+  const std::string path = temp_path("round_trip.idx");
+  ASSERT_TRUE(write_file(png, kPng));
+  ASSERT_TRUE(write_file(noise, kNoise));
+
+  filetype::IndexWriter writer;
+  std::error_code ec;
+  EXPECT_EQ(writer.match_file(png, ec), &filetype::image::TYPE_PNG);
+  EXPECT_EQ(writer.match_file(noise, ec), nullptr);
+  EXPECT_EQ(writer.misses(), 2u);
+  ASSERT_TRUE(writer.commit(path, ec)) << ec.message();
+
+  const auto index = open_index(path);
+  ASSERT_NE(index, nullptr);
+  EXPECT_EQ(index->size(), 2u);
+  EXPECT_EQ(index->generation(), 1u);
+  const filetype::Type* type = nullptr;
+  EXPECT_TRUE(index->find(png, &type, ec));
+  EXPECT_EQ(type, &filetype::image::TYPE_PNG);
+  // Unrecognised files are remembered too.
+  type = &filetype::image::TYPE_PNG;
+  EXPECT_TRUE(index->find(noise, &type, ec));
+  EXPECT_EQ(type, nullptr);
+
+  // Unknown and missing paths.
+  EXPECT_FALSE(index->find(path, &type, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(index->find(temp_path("missing"), &type, ec));
+  EXPECT_TRUE(ec);
+  for (const std::string& p : {png, noise, path}) {
+    std::remove(p.c_str());
+  }
+}
+
+TEST(IndexTest, ChangedFilesAreDetectedAgain) {
+  const std::string file = temp_path("changed");
+  const std::string other = temp_path("unchanged");
+  const std::string path = temp_path("changed.idx");
+  ASSERT_TRUE(write_file(file, kPng));
+  ASSERT_TRUE(write_file(other, kPdf));
+  std::error_code ec;
+  {
+    filetype::IndexWriter writer;
+    writer.match_file(file, ec);
+    writer.match_file(other, ec);
+    ASSERT_TRUE(writer.commit(path, ec));
+  }
+
+  // A rewrite changes the size, so the entry no longer applies.
+  ASSERT_TRUE(write_file(file, kPdf));
+  const auto index = open_index(path);
+  ASSERT_NE(index, nullptr);
+  const filetype::Type* type = nullptr;
+  EXPECT_FALSE(index->find(file, &type, ec));
+
+  filetype::IndexWriter writer(index);
+  EXPECT_EQ(writer.match_file(file, ec), &filetype::document::TYPE_PDF);
+  EXPECT_EQ(writer.match_file(other, ec), &filetype::document::TYPE_PDF);
+  EXPECT_EQ(writer.hits(), 1u);
+  EXPECT_EQ(writer.misses(), 1u);
+  ASSERT_TRUE(writer.commit(path, ec));
+
+  // The old index stays readable after being replaced.
+  EXPECT_TRUE(index->find(other, &type, ec));
+  const auto next = open_index(path);
+  ASSERT_NE(next, nullptr);
+  EXPECT_EQ(next->size(), 2u);
+  EXPECT_EQ(next->generation(), 2u);
+  EXPECT_TRUE(next->find(file, &type, ec));
+  EXPECT_EQ(type, &filetype::document::TYPE_PDF);
+  for (const std::string& p : {file, other, path}) {
+    std::remove(p.c_str());
+  }
+}
+
+TEST(IndexTest, UnseenEntriesAgeOut) {
+  const std::string kept = temp_path("kept");
+  const std::string gone = temp_path("gone");
+  const std::string path = temp_path("aging.idx");
+  ASSERT_TRUE(write_file(kept, kPng));
+  ASSERT_TRUE(write_file(gone, kPng));
+  std::error_code ec;
+  {
+    filetype::IndexWriter writer;
+    writer.match_file(kept, ec);
+    writer.match_file(gone, ec);
+    ASSERT_TRUE(writer.commit(path, ec));
+  }
+
+  // Scans that skip a file keep its entry for keep_unseen commits.
+  filetype::IndexCommitOptions options;
+  options.keep_unseen = 1;
+  for (size_t expected : {2u, 1u}) {
+    filetype::IndexWriter writer(open_index(path));
+    EXPECT_EQ(writer.match_file(kept, ec), &filetype::image::TYPE_PNG);
+    EXPECT_EQ(writer.hits(), 1u);
+    ASSERT_TRUE(writer.commit(path, ec, options));
+    EXPECT_EQ(open_index(path)->size(), expected);
+  }
+  const filetype::Type* type = nullptr;
+  EXPECT_TRUE(open_index(path)->find(kept, &type, ec));
+  EXPECT_FALSE(open_index(path)->find(gone, &type, ec));
+  for (const std::string& p : {kept, gone, path}) {
+    std::remove(p.c_str());
+  }
+}
+
+TEST(IndexTest, ParallelWriters) {
+  std::vector<std::string> files;
+  for (int i = 0; i < 64; ++i) {
+    files.push_back(temp_path("parallel" + std::to_string(i)));
+    ASSERT_TRUE(write_file(files.back(), i % 2 ? kPdf : kPng));
+  }
+  const std::string path = temp_path("parallel.idx");
+  filetype::IndexWriter writer;
+  std::vector<std::thread> threads;
+  std::atomic<size_t> wrong{0};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      std::error_code ec;
+      // Every file is looked up twice, by different threads.
+      for (size_t i = t; i < files.size() * 2; i += 4) {
+        const size_t k = i % files.size();
+        if (writer.match_file(files[k], ec) !=
+            (k % 2 ? &filetype::document::TYPE_PDF
+                   : &filetype::image::TYPE_PNG)) {
+          wrong.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(wrong.load(), 0u);
+  std::error_code ec;
+  ASSERT_TRUE(writer.commit(path, ec));
+
+  const auto index = open_index(path);
+  ASSERT_NE(index, nullptr);
+  EXPECT_EQ(index->size(), files.size());
+  for (size_t k = 0; k < files.size(); ++k) {
+    const filetype::Type* type = nullptr;
+    EXPECT_TRUE(index->find(files[k], &type, ec));
+    EXPECT_EQ(type, k % 2 ? &filetype::document::TYPE_PDF
+                          : &filetype::image::TYPE_PNG);
+    std::remove(files[k].c_str());
+  }
+  std::remove(path.c_str());
+}
+
+TEST(IndexTest, CustomTypesAreNotStored) {
+  const std::string file = temp_path("custom");
+  const std::string path = temp_path("custom.idx");
+  ASSERT_TRUE(write_file(file, {'A', 'C', 'M', 'E', 0, 0, 0, 0}));
+  std::vector<uint8_t> image;
+  ASSERT_TRUE(filetype::compile_signatures(
+      "application/x-acme acme archive 0 41434D45", &image));
+  std::error_code ec;
+  filetype::register_signatures(filetype::SignatureDatabase::load(image, ec));
+  filetype::IndexWriter writer;
+  EXPECT_EQ(writer.match_file(file, ec)->extension, "acme");
+  filetype::clear_signatures();
+  ASSERT_TRUE(writer.commit(path, ec));
+  EXPECT_EQ(open_index(path)->size(), 0u);
+  std::remove(file.c_str());
+  std::remove(path.c_str());
+}
+
+TEST(IndexTest, OtherSignaturesInvalidate) {
+  const std::string file = temp_path("stale.png");
+  const std::string path = temp_path("stale.idx");
+  ASSERT_TRUE(write_file(file, kPng));
+  std::error_code ec;
+  {
+    filetype::IndexWriter writer;
+    writer.match_file(file, ec);
+    ASSERT_TRUE(writer.commit(path, ec));
+  }
+  const filetype::Type* type = nullptr;
+  EXPECT_TRUE(open_index(path)->find(file, &type, ec));
+
+  // Registered signatures are searched first, so no entry can be trusted.
+  std::vector<uint8_t> image;
+  ASSERT_TRUE(filetype::compile_signatures(
+      "application/x-acme acme archive 0 41434D45", &image));
+  filetype::register_signatures(filetype::SignatureDatabase::load(image, ec));
+  EXPECT_FALSE(open_index(path)->find(file, &type, ec));
+  {
+    filetype::IndexWriter writer(open_index(path));
+    EXPECT_EQ(writer.match_file(file, ec), &filetype::image::TYPE_PNG);
+    EXPECT_EQ(writer.hits(), 0u);
+  }
+  filetype::clear_signatures();
+
+  // An index written with other built-in signatures is ignored and
+  // rewritten without its entries.
+  std::vector<uint8_t> bytes(4096);
+  std::FILE* stream = std::fopen(path.c_str(), "rb");
+  ASSERT_NE(stream, nullptr);
+  bytes.resize(std::fread(bytes.data(), 1, bytes.size(), stream));
+  std::fclose(stream);
+  bytes[56] ^= 1;  // IndexHeader::fingerprint
+  ASSERT_TRUE(write_file(path, bytes));
+  auto index = open_index(path);
+  ASSERT_NE(index, nullptr);
+  EXPECT_FALSE(index->find(file, &type, ec));
+  filetype::IndexWriter writer(index);
+  ASSERT_TRUE(writer.commit(path, ec));
+  EXPECT_EQ(open_index(path)->size(), 0u);
+  std::remove(file.c_str());
+  std::remove(path.c_str());
+}
+
+#endif
+
+TEST(IndexTest, RejectsInvalidFiles) {
+  const std::string path = temp_path("invalid.idx");
+  std::error_code ec;
+  EXPECT_EQ(filetype::DetectionIndex::open(path, ec), nullptr);
+  EXPECT_TRUE(ec);
+
+  ASSERT_TRUE(write_file(path, {}));
+  EXPECT_EQ(filetype::DetectionIndex::open(path, ec), nullptr);
+  EXPECT_EQ(ec, std::errc::invalid_argument);
+
+  filetype::IndexWriter writer;
+  ASSERT_TRUE(writer.commit(path, ec));
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  std::vector<uint8_t> bytes(4096);
+  bytes.resize(std::fread(bytes.data(), 1, bytes.size(), file));
+  std::fclose(file);
+  EXPECT_NE(filetype::DetectionIndex::open(path, ec), nullptr);
+
+  // Truncated, and with a record count the table cannot hold.
+  ASSERT_TRUE(
+      write_file(path, std::vector<uint8_t>(bytes.begin(), bytes.end() - 1)));
+  EXPECT_EQ(filetype::DetectionIndex::open(path, ec), nullptr);
+  EXPECT_EQ(ec, std::errc::invalid_argument);
+  bytes[24] = 1;
+  ASSERT_TRUE(write_file(path, bytes));
+  EXPECT_EQ(filetype::DetectionIndex::open(path, ec), nullptr);
+  EXPECT_EQ(ec, std::errc::invalid_argument);
+  std::remove(path.c_str());
+}
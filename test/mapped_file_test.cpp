@@ -0,0 +1,147 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::dmg;
+using filetype::test::kPng;
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+void put16(std::vector<uint8_t>* out, uint32_t v) {
+  out->push_back(static_cast<uint8_t>(v));
+  out->push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void put32(std::vector<uint8_t>* out, uint32_t v) {
+  put16(out, v & 0xFFFF);
+  put16(out, v >> 16);
+}
+
+/// XLSX whose only hint lies in a central directory @p padding bytes in.
+std::vector<uint8_t> spread_xlsx(size_t padding) {
+  std::vector<uint8_t> zip;
+  const std::string names[] = {"[Content_Types].xml", "xl/workbook.xml"};
+  std::vector<uint32_t> offsets;
+  for (const std::string& name : names) {
+    offsets.push_back(static_cast<uint32_t>(zip.size()));
+    const size_t size = offsets.size() == 1 ? padding : 1;
+    put32(&zip, 0x04034B50);
+    put16(&zip, 20);
+    put16(&zip, 0x0008);  // sizes in a data descriptor
+    put16(&zip, 0);
+    put32(&zip, 0);
+    put32(&zip, 0);
+    put32(&zip, 0);
+    put32(&zip, 0);
+    put16(&zip, static_cast<uint32_t>(name.size()));
+    put16(&zip, 0);
+    zip.insert(zip.end(), name.begin(), name.end());
+    zip.insert(zip.end(), size, ' ');
+  }
+  const uint32_t directory = static_cast<uint32_t>(zip.size());
+  for (size_t i = 0; i < 2; ++i) {
+    put32(&zip, 0x02014B50);
+    for (int k = 0; k < 6; ++k) {
+      put16(&zip, 20);
+    }
+    put32(&zip, 0);
+    put32(&zip, 0);
+    put32(&zip, 0);
+    put16(&zip, static_cast<uint32_t>(names[i].size()));
+    for (int k = 0; k < 4; ++k) {
+      put16(&zip, 0);
+    }
+    put32(&zip, 0);
+    put32(&zip, offsets[i]);
+    zip.insert(zip.end(), names[i].begin(), names[i].end());
+  }
+  const uint32_t directory_size = static_cast<uint32_t>(zip.size()) - directory;
+  put32(&zip, 0x06054B50);
+  put32(&zip, 0);
+  put16(&zip, 2);
+  put16(&zip, 2);
+  put32(&zip, directory_size);
+  put32(&zip, directory);
+  put16(&zip, 0);
+  return zip;
+}
+
+}  // namespace
+
+TEST(MappedFileTest, MapsTheWholeFile) {
+  const std::string path = temp_path("png");
+  ASSERT_TRUE(write_file(path, kPng));
+  filetype::MappedFile file;
+  EXPECT_TRUE(file.bytes().empty());
+  EXPECT_EQ(filetype::match(file), nullptr);
+
+  std::error_code ec;
+  ASSERT_TRUE(file.open(path, ec)) << ec.message();
+  ASSERT_EQ(file.bytes().size(), kPng.size());
+  EXPECT_EQ(std::memcmp(file.bytes().data(), kPng.data(), kPng.size()), 0);
+  const filetype::DetectionResult result = filetype::detect(file);
+  EXPECT_EQ(result.type, &filetype::image::TYPE_PNG);
+  EXPECT_EQ(filetype::match(file, filetype::to_mask(filetype::Category::AUDIO)),
+            nullptr);
+
+  // Hints are clipped to the file, and the mapping can be moved.
+  file.will_need(0, 1 << 20);
+  file.will_need(1 << 20, 10);
+  file.advise(filetype::Access::SEQUENTIAL);
+  filetype::MappedFile moved = std::move(file);
+  EXPECT_EQ(filetype::match(moved), &filetype::image::TYPE_PNG);
+  std::remove(path.c_str());
+}
+
+TEST(MappedFileTest, ClassifiersReadThroughTheMapping) {
+  // The hint sits in a central directory 1 MiB into the file.
+  const std::string path = temp_path("xlsx");
+  ASSERT_TRUE(write_file(path, spread_xlsx(1 << 20)));
+  filetype::MappedFile file;
+  std::error_code ec;
+  ASSERT_TRUE(file.open(path, ec));
+  EXPECT_EQ(filetype::match(file), &filetype::document::TYPE_XLSX);
+  EXPECT_EQ(filetype::match_file(path, ec), &filetype::document::TYPE_XLSX);
+  std::remove(path.c_str());
+}
+
+TEST(MappedFileTest, Trailers) {
+  const std::string path = temp_path("dmg");
+  ASSERT_TRUE(write_file(path, dmg(200000)));
+  filetype::MappedFile file;
+  std::error_code ec;
+  ASSERT_TRUE(file.open(path, ec, filetype::Access::NORMAL));
+  const filetype::DetectionResult result = filetype::detect(file);
+  EXPECT_EQ(result.type, &filetype::archive::TYPE_DMG);
+  EXPECT_EQ(result.offset, 200000u);
+  std::remove(path.c_str());
+}
+
+TEST(MappedFileTest, EmptyAndMissingFiles) {
+  const std::string path = temp_path("empty");
+  ASSERT_TRUE(write_file(path, {}));
+  filetype::MappedFile file;
+  std::error_code ec;
+  ASSERT_TRUE(file.open(path, ec));
+  EXPECT_TRUE(file.bytes().empty());
+  EXPECT_FALSE(filetype::detect(file));
+  std::remove(path.c_str());
+
+  EXPECT_FALSE(file.open(path, ec));
+  EXPECT_TRUE(ec);
+#if !defined(_WIN32)
+  EXPECT_FALSE(file.open(::testing::TempDir(), ec));
+  EXPECT_EQ(ec, std::errc::invalid_argument);
+#endif
+}
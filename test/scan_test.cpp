@@ -0,0 +1,275 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+/// @p size bytes of deterministic noise free of any signature's key.
+std::vector<uint8_t> filler(size_t size, uint8_t seed = 1) {
+  std::vector<uint8_t> out(size);
+  uint32_t state = seed;
+  for (uint8_t& b : out) {
+    state = state * 1103515245u + 12345u;
+    // Lower-case letters never start a built-in key.
+    b = static_cast<uint8_t>('a' + (state >> 16) % 26);
+  }
+  return out;
+}
+
+void put(std::vector<uint8_t>* out, size_t at, std::string_view bytes) {
+  std::memcpy(out->data() + at, bytes.data(), bytes.size());
+}
+
+std::vector<size_t> offsets(const std::vector<filetype::ScanHit>& hits) {
+  std::vector<size_t> out;
+  for (const filetype::ScanHit& hit : hits) {
+    out.push_back(hit.offset);
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(ScanTest, EmbeddedFiles) {
+  std::vector<uint8_t> pdf = filler(300);
+  put(&pdf, 37, "%PDF-1.7\n");
+  EXPECT_EQ(filetype::match(pdf), nullptr);
+  size_t offset = 0;
+  EXPECT_EQ(filetype::match_anywhere(pdf, &offset),
+            &filetype::document::TYPE_PDF);
+  EXPECT_EQ(offset, 37u);
+
+  std::vector<uint8_t> mp3 = filler(200);
+  std::memset(mp3.data(), 0, 128);
+  put(&mp3, 128, "ID3\x04");
+  EXPECT_EQ(filetype::match_anywhere(mp3, &offset),
+            &filetype::audio::TYPE_MP3);
+  EXPECT_EQ(offset, 128u);
+
+  // ZIP archive appended to an executable stub.
+  std::vector<uint8_t> sfx = filler(1024);
+  put(&sfx, 0, "MZ");
+  put(&sfx, 700, std::string_view("PK\x03\x04\x14\x00\x00\x00", 8));
+  const auto hits = filetype::scan(sfx);
+  ASSERT_EQ(hits.size(), 1u);
+  EXPECT_EQ(hits[0].offset, 700u);
+  EXPECT_EQ(hits[0].result.type, &filetype::archive::TYPE_ZIP);
+}
+
+TEST(ScanTest, SignaturesAtAnOffset) {
+  // TAR's magic sits 257 bytes into the header; a RIFF header has a masked
+  // size field between its two constant runs.
+  std::vector<uint8_t> data = filler(2048);
+  put(&data, 100 + 257, "ustar");
+  put(&data, 900, "RIFF\x10\x20\x30\x40WAVE");
+  const auto hits = filetype::scan(data);
+  ASSERT_EQ(offsets(hits), (std::vector<size_t>{100, 900}));
+  EXPECT_EQ(hits[0].result.type, &filetype::archive::TYPE_TAR);
+  EXPECT_EQ(hits[1].result.type, &filetype::audio::TYPE_WAV);
+
+  // Keys too close to the start for their file to fit are ignored.
+  std::vector<uint8_t> early = filler(400);
+  put(&early, 10, "ustar");
+  EXPECT_TRUE(filetype::scan(early).empty());
+}
+
+TEST(ScanTest, OffsetZeroMatchesMatch) {
+  // BMP's two-byte magic is only trusted at the start.
+  std::vector<uint8_t> bmp = filler(64);
+  put(&bmp, 0, "BM");
+  put(&bmp, 40, "BM");
+  const auto hits = filetype::scan(bmp);
+  ASSERT_EQ(offsets(hits), (std::vector<size_t>{0}));
+  EXPECT_EQ(hits[0].result.type, filetype::match(bmp));
+}
+
+TEST(ScanTest, CategoryFilter) {
+  std::vector<uint8_t> data = filler(512);
+  put(&data, 10, "%PDF-1.4");
+  put(&data, 200, "\x89PNG\r\n\x1a\n");
+  EXPECT_EQ(offsets(filetype::scan(data)), (std::vector<size_t>{10, 200}));
+  const auto images =
+      filetype::scan(data, filetype::to_mask(filetype::Category::IMAGE));
+  ASSERT_EQ(offsets(images), (std::vector<size_t>{200}));
+  EXPECT_TRUE(images[0].result.is_image());
+}
+
+TEST(ScanTest, AgreesWithDetectAtEveryOffset) {
+  using namespace std::string_view_literals;  // NOLINT(build/namespaces)
+  static constexpr std::string_view kMagics[] = {
+      "\x89PNG\r\n\x1a\n"sv, "GIF89a"sv, "%PDF"sv, "PK\x03\x04"sv,
+      "Rar!\x1a\x07\x00"sv, "7z\xbc\xaf\x27\x1c"sv, "BZh"sv,
+      "\x1f\x8b\x08"sv, "ID3"sv, "OggS"sv, "fLaC"sv, "\xff\xd8\xff"sv,
+      "\x1a\x45\xdf\xa3"sv, "ftypisom"sv, "RIFF"sv, "WEBPVP8 "sv,
+      "\x00\x00\x01\xba"sv, "MThd"sv, "{\\rtf"sv, "ustar"sv,
+  };
+  std::vector<uint8_t> data = filler(8192, 7);
+  uint32_t state = 99;
+  for (size_t n = 0; n < 400; ++n) {
+    state = state * 1103515245u + 12345u;
+    const std::string_view magic =
+        kMagics[(state >> 8) % (sizeof(kMagics) / sizeof(kMagics[0]))];
+    const size_t at = (state >> 12) % (data.size() - magic.size());
+    put(&data, at, magic);
+  }
+
+  // Brute force: every offset whose detection rests on a signature of at
+  // least three bytes, plus offset 0.
+  std::vector<size_t> expected;
+  for (size_t at = 0; at < data.size(); ++at) {
+    const filetype::DetectionResult result =
+        filetype::detect(filetype::ByteView(data).subview(at));
+    if (result && (at == 0 || result.length >= 3)) {
+      expected.push_back(at);
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+  EXPECT_EQ(offsets(filetype::scan(data)), expected);
+}
+
+TEST(ScanTest, RegisteredSignatures) {
+  std::vector<uint8_t> image;
+  ASSERT_TRUE(filetype::compile_signatures(
+      "application/x-abab abab archive 0 41424142\n"
+      "application/x-deep deep archive 8 5A5A5A??5A\n",
+      &image));
+  std::error_code ec;
+  filetype::register_signatures(filetype::SignatureDatabase::load(image, ec));
+
+  // Overlapping occurrences are all reported.
+  std::vector<uint8_t> data = filler(64);
+  put(&data, 20, "ABABAB");
+  put(&data, 48, "ZZZ?Z");
+  const auto hits = filetype::scan(data);
+  ASSERT_EQ(offsets(hits), (std::vector<size_t>{20, 22, 40}));
+  EXPECT_EQ(hits[0].result.type->extension, "abab");
+  EXPECT_EQ(hits[2].result.type->extension, "deep");
+  filetype::clear_signatures();
+
+  EXPECT_TRUE(filetype::scan(data).empty());
+}
+
+TEST(ScanTest, Empty) {
+  EXPECT_TRUE(filetype::scan(filetype::ByteView()).empty());
+  EXPECT_EQ(filetype::match_anywhere(filetype::ByteView()), nullptr);
+  EXPECT_TRUE(filetype::scan(filler(4096)).empty());
+}
+
+TEST(ScanTest, CarveMatchesScan) {
+  std::vector<uint8_t> data = filler(20000, 3);
+  // Files on and around chunk boundaries, and TAR whose key lies 257 bytes
+  // past its start.
+  put(&data, 0, "%PDF-1.5");
+  put(&data, 4094, "\x89PNG\r\n\x1a\n");
+  put(&data, 8190, "GIF89a");
+  put(&data, 12000 + 257, "ustar");
+  put(&data, 16383, "OggS");
+  put(&data, 19990, "fLaC");
+  const std::vector<filetype::ScanHit> expected = filetype::scan(data);
+  ASSERT_EQ(expected.size(), 6u);
+
+  for (size_t threads : {1, 4}) {
+    for (size_t chunk : {1, 100, 4096, 1 << 20}) {
+      filetype::CarveOptions options;
+      options.threads = threads;
+      options.chunk_size = chunk;
+      std::vector<filetype::ScanHit> hits;
+      const size_t count = filetype::carve(
+          data, [&](const filetype::ScanHit& hit) { hits.push_back(hit); },
+          options);
+      EXPECT_EQ(count, hits.size());
+      // In offset order, once each, whatever the chunking.
+      EXPECT_EQ(offsets(hits), offsets(expected))
+          << threads << " threads, chunk " << chunk;
+      for (size_t i = 0; i < hits.size() && i < expected.size(); ++i) {
+        EXPECT_EQ(hits[i].result.type, expected[i].result.type);
+      }
+    }
+  }
+
+  filetype::CarveOptions images;
+  images.categories = filetype::to_mask(filetype::Category::IMAGE);
+  images.chunk_size = 4096;
+  EXPECT_EQ(filetype::carve(data, [](const filetype::ScanHit&) {}, images),
+            2u);
+  EXPECT_EQ(filetype::carve(filetype::ByteView(),
+                            [](const filetype::ScanHit&) {}),
+            0u);
+}
+
+TEST(ScanTest, CarvePublishesFromCallback) {
+  std::vector<uint8_t> image;
+  ASSERT_TRUE(filetype::compile_signatures(
+      "application/x-abab abab archive 0 41424142\n", &image));
+  std::error_code ec;
+  const auto abab = filetype::SignatureDatabase::load(image, ec);
+  ASSERT_NE(abab, nullptr);
+
+  std::vector<uint8_t> data = filler(16384, 7);
+  put(&data, 0, "%PDF-1.7");
+  put(&data, 9000, "ABAB");
+  for (size_t threads : {1, 4}) {
+    filetype::CarveOptions options;
+    options.threads = threads;
+    options.chunk_size = 4096;
+    std::vector<filetype::ScanHit> hits;
+    // Publishing from on_hit must not wait on carve()'s own readers.
+    filetype::carve(
+        data,
+        [&](const filetype::ScanHit& hit) {
+          hits.push_back(hit);
+          if (hit.offset == 0) {
+            filetype::register_signatures(abab);
+          } else {
+            filetype::clear_signatures();
+          }
+        },
+        options);
+    ASSERT_FALSE(hits.empty());
+    EXPECT_EQ(hits[0].offset, 0u);
+    if (threads == 1) {
+      // Later chunks are scanned with the set the callback published.
+      EXPECT_EQ(offsets(hits), (std::vector<size_t>{0, 9000}));
+    }
+    filetype::clear_signatures();
+  }
+}
+
+TEST(ScanTest, CarveFile) {
+  std::vector<uint8_t> image = filler(100000, 5);
+  put(&image, 512, "PK\x03\x04");
+  put(&image, 70000, "%PDF-1.7");
+  const std::string path = temp_path("carve.img");
+  ASSERT_TRUE(write_file(path, image));
+
+  filetype::CarveOptions options;
+  options.chunk_size = 8192;
+  std::vector<filetype::ScanHit> hits;
+  std::error_code ec;
+  EXPECT_EQ(filetype::carve_file(
+                path,
+                [&](const filetype::ScanHit& hit) { hits.push_back(hit); },
+                ec, options),
+            2u);
+  EXPECT_FALSE(ec);
+  ASSERT_EQ(offsets(hits), (std::vector<size_t>{512, 70000}));
+  EXPECT_EQ(hits[1].result.type, &filetype::document::TYPE_PDF);
+  std::remove(path.c_str());
+
+  EXPECT_EQ(filetype::carve_file(
+                path, [](const filetype::ScanHit&) {}, ec),
+            0u);
+  EXPECT_TRUE(ec);
+}
@@ -0,0 +1,258 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+constexpr std::string_view kDescription = R"(
+# mime                   ext   category  offset  magic
+application/x-acme       acme  archive   0       41434D45  priority=5
+application/x-acme-lite  acml  archive   0       41434D??
+image/x-foo              foo   image     0x10    464F4F21
+audio/x-deep             deep  audio     1000    44454550
+video/x-png-wrapper      pngw  video     0       89504E47  priority=1
+)";
+
+std::shared_ptr<const filetype::SignatureDatabase> load(
+    std::string_view description) {
+  std::vector<uint8_t> image;
+  std::string error;
+  EXPECT_TRUE(filetype::compile_signatures(description, &image, &error))
+      << error;
+  std::error_code ec;
+  auto database = filetype::SignatureDatabase::load(image, ec);
+  EXPECT_FALSE(ec);
+  return database;
+}
+
+std::vector<uint8_t> bytes(std::string_view text, size_t size = 32) {
+  std::vector<uint8_t> out(text.begin(), text.end());
+  out.resize(std::max(size, out.size()), 0);
+  return out;
+}
+
+std::string compile_error(std::string_view description) {
+  std::vector<uint8_t> image;
+  std::string error;
+  EXPECT_FALSE(filetype::compile_signatures(description, &image, &error));
+  return error;
+}
+
+}  // namespace
+
+TEST(SignatureDbTest, Detect) {
+  const auto database = load(kDescription);
+  ASSERT_NE(database, nullptr);
+  EXPECT_EQ(database->type_count(), 5u);
+  EXPECT_EQ(database->signature_count(), 5u);
+  EXPECT_EQ(database->max_end(), 1004u);
+
+  const filetype::Type* acme = database->match(bytes("ACME"));
+  ASSERT_NE(acme, nullptr);
+  EXPECT_EQ(acme->mime, "application/x-acme");
+  EXPECT_EQ(acme->extension, "acme");
+  EXPECT_EQ(acme->id, filetype::TypeId::CUSTOM);
+  EXPECT_EQ(acme->category, filetype::Category::ARCHIVE);
+  EXPECT_EQ(database->match(bytes("ACMZ"))->mime, "application/x-acme-lite");
+
+  std::vector<uint8_t> foo = bytes("", 32);
+  foo[16] = 'F';
+  foo[17] = 'O';
+  foo[18] = 'O';
+  foo[19] = '!';
+  EXPECT_EQ(database->match(foo)->extension, "foo");
+  EXPECT_TRUE(database->detect(foo).is_image());
+
+  std::vector<uint8_t> deep = bytes("", 1004);
+  deep[1000] = 'D';
+  deep[1001] = 'E';
+  deep[1002] = 'E';
+  deep[1003] = 'P';
+  EXPECT_EQ(database->match(deep)->extension, "deep");
+  deep.pop_back();
+  EXPECT_EQ(database->match(deep), nullptr);
+
+  EXPECT_EQ(database->match(bytes("nothing")), nullptr);
+  EXPECT_EQ(database->match(filetype::ByteView()), nullptr);
+}
+
+TEST(SignatureDbTest, Priority) {
+  // Without a priority the longer, more specific signature wins.
+  auto database = load(
+      "text/x-short  s  document  0  4142\n"
+      "text/x-long   l  document  0  41424344\n");
+  EXPECT_EQ(database->match(bytes("ABCD"))->extension, "l");
+  EXPECT_EQ(database->match(bytes("ABXX"))->extension, "s");
+
+  database = load(
+      "text/x-short  s  document  0  4142  priority=1\n"
+      "text/x-long   l  document  0  41424344\n");
+  EXPECT_EQ(database->match(bytes("ABCD"))->extension, "s");
+}
+
+TEST(SignatureDbTest, Masks) {
+  // Case-insensitive ASCII through a mask, and a wildcard in the middle.
+  const auto database = load(
+      "text/x-word  w  document  0  574F5244  mask=DFDFDFDF\n"
+      "text/x-gap   g  document  4  47??50\n");
+  EXPECT_EQ(database->match(bytes("word"))->extension, "w");
+  EXPECT_EQ(database->match(bytes("WoRd"))->extension, "w");
+  EXPECT_EQ(database->match(bytes("wore")), nullptr);
+  EXPECT_EQ(database->match(bytes("xxxxGAP"))->extension, "g");
+  EXPECT_EQ(database->match(bytes("xxxxG P"))->extension, "g");
+  EXPECT_EQ(database->match(bytes("xxxxGAQ")), nullptr);
+}
+
+TEST(SignatureDbTest, CategoryFilter) {
+  const auto database = load(kDescription);
+  const auto acme = bytes("ACME");
+  EXPECT_NE(database->detect(acme, filetype::to_mask(
+                                       filetype::Category::ARCHIVE)).type,
+            nullptr);
+  EXPECT_EQ(database->detect(acme, filetype::to_mask(
+                                       filetype::Category::IMAGE)).type,
+            nullptr);
+}
+
+TEST(SignatureDbTest, CompileErrors) {
+  EXPECT_EQ(compile_error("a/b x image 0"),
+            "line 1: expected mime, extension, category, offset and magic");
+  EXPECT_EQ(compile_error("\n# comment\nnomime x image 0 00"),
+            "line 3: invalid MIME type 'nomime'");
+  EXPECT_EQ(compile_error("a/b x font 0 00"),
+            "line 1: unknown category 'font'");
+  EXPECT_EQ(compile_error("a/b x image -1 00"),
+            "line 1: invalid offset '-1'");
+  EXPECT_EQ(compile_error("a/b x image 0 0G"), "line 1: invalid magic '0G'");
+  EXPECT_EQ(compile_error("a/b x image 4095 0000"),
+            "line 1: signature ends past byte 4096");
+  EXPECT_EQ(compile_error("a/b x image 0 ????"),
+            "line 1: the mask leaves no byte to compare");
+  EXPECT_EQ(compile_error("a/b x image 0 00?? mask=FF00"),
+            "line 1: mask= cannot be combined with ?? or repeated");
+  EXPECT_EQ(compile_error("a/b x image 0 0000 mask=FF"),
+            "line 1: mask must be hexadecimal and as long as the magic");
+  EXPECT_EQ(compile_error("a/b x image 0 00 priority=40000"),
+            "line 1: invalid priority 'priority=40000'");
+  EXPECT_EQ(compile_error("a/b x image 0 00 color=red"),
+            "line 1: unknown option 'color=red'");
+  EXPECT_EQ(compile_error("a/b x image 0 00\na/b y image 1 00"),
+            "line 2: 'a/b' was declared with another extension or category");
+}
+
+TEST(SignatureDbTest, RejectsCorruptImages) {
+  std::vector<uint8_t> image;
+  ASSERT_TRUE(filetype::compile_signatures(kDescription, &image));
+  std::error_code ec;
+  ASSERT_NE(filetype::SignatureDatabase::load(image, ec), nullptr);
+
+  EXPECT_EQ(filetype::SignatureDatabase::load(
+                filetype::ByteView(image).subview(0, image.size() - 1), ec),
+            nullptr);
+  EXPECT_EQ(ec, std::errc::invalid_argument);
+
+  // Flipping any single header byte must not yield a database that reads
+  // outside the image; most flips are rejected outright.
+  for (size_t i = 0; i < 64; ++i) {
+    std::vector<uint8_t> corrupt = image;
+    corrupt[i] ^= 0x80;
+    const auto database = filetype::SignatureDatabase::load(corrupt, ec);
+    if (database != nullptr) {
+      database->match(bytes("ACME", 4096));
+    }
+  }
+  EXPECT_EQ(filetype::SignatureDatabase::load(filetype::ByteView(), ec),
+            nullptr);
+}
+
+TEST(SignatureDbTest, OpenFile) {
+  std::vector<uint8_t> image;
+  ASSERT_TRUE(filetype::compile_signatures(kDescription, &image));
+  const std::string path = temp_path("image.db");
+  ASSERT_TRUE(write_file(path, image));
+
+  std::error_code ec;
+  const auto database = filetype::SignatureDatabase::open(path, ec);
+  ASSERT_NE(database, nullptr);
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(database->match(bytes("ACME"))->mime, "application/x-acme");
+  std::remove(path.c_str());
+
+  EXPECT_EQ(filetype::SignatureDatabase::open(path, ec), nullptr);
+  EXPECT_TRUE(ec);
+}
+
+TEST(SignatureDbTest, Registered) {
+  const auto database = load(kDescription);
+  const auto png = bytes("\x89PNG\r\n\x1a\n");
+  const auto acme = bytes("ACME");
+  ASSERT_EQ(filetype::match(png), &filetype::image::TYPE_PNG);
+  ASSERT_EQ(filetype::match(acme), nullptr);
+
+  filetype::register_signatures(database);
+  EXPECT_EQ(filetype::match(acme)->mime, "application/x-acme");
+  EXPECT_TRUE(filetype::is_archive(acme));
+  // Registered signatures take precedence over the built-in ones ...
+  EXPECT_EQ(filetype::match(png)->mime, "video/x-png-wrapper");
+  // ... within the categories asked for.
+  EXPECT_EQ(filetype::matcher::match_image(png), &filetype::image::TYPE_PNG);
+
+  const filetype::ByteView inputs[] = {acme, png};
+  const filetype::Type* results[2];
+  filetype::match_batch(inputs, 2, results);
+  EXPECT_EQ(results[0]->extension, "acme");
+  EXPECT_EQ(results[1]->extension, "pngw");
+
+  // A hit of higher priority wins across databases, and a later
+  // registration wins a tie.
+  filetype::register_signatures(
+      load("application/x-acme2 acme2 archive 0 41434D45"));
+  EXPECT_EQ(filetype::match(acme)->extension, "acme");
+  filetype::register_signatures(
+      load("application/x-acme3 acme3 archive 0 41434D45 priority=5"));
+  EXPECT_EQ(filetype::match(acme)->extension, "acme3");
+  filetype::replace_signatures(
+      {database, load("application/x-acme2 acme2 archive 0 41434D"
+                      " priority=6")});
+  EXPECT_EQ(filetype::match(acme)->extension, "acme2");
+  filetype::replace_signatures({database});
+
+  std::vector<uint8_t> deep = bytes("", 2048);
+  deep[1000] = 'D';
+  deep[1001] = 'E';
+  deep[1002] = 'E';
+  deep[1003] = 'P';
+  const std::string path = temp_path("deep.bin");
+  ASSERT_TRUE(write_file(path, deep));
+  std::error_code ec;
+  const filetype::Type* detected = filetype::match_file(path, ec);
+  ASSERT_NE(detected, nullptr);
+  EXPECT_EQ(detected->extension, "deep");
+  std::remove(path.c_str());
+
+  filetype::clear_signatures();
+  EXPECT_EQ(filetype::match(acme), nullptr);
+  EXPECT_EQ(filetype::match(png), &filetype::image::TYPE_PNG);
+}
+
+TEST(SignatureDbTest, CustomTypeEquality) {
+  const auto a = load("application/x-a a archive 0 41");
+  const auto b = load("application/x-a a archive 0 42\n"
+                      "application/x-b b archive 0 43");
+  EXPECT_EQ(a->type(0), b->type(0));
+  EXPECT_NE(a->type(0), b->type(1));
+  EXPECT_NE(a->type(0), filetype::archive::TYPE_ZIP);
+}
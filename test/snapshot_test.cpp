@@ -0,0 +1,98 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+
+namespace {
+
+std::shared_ptr<const filetype::SignatureDatabase> load(
+    std::string_view description) {
+  std::vector<uint8_t> image;
+  EXPECT_TRUE(filetype::compile_signatures(description, &image));
+  std::error_code ec;
+  return filetype::SignatureDatabase::load(image, ec);
+}
+
+const std::vector<uint8_t> kAcme = {'A', 'C', 'M', 'E', 0, 0, 0, 0};
+
+}  // namespace
+
+TEST(SnapshotTest, ReplaceAndRelease) {
+  auto v1 = load("application/x-acme acme archive 0 41434D45");
+  auto v2 = load("application/x-acme acme2 archive 0 41434D45");
+  const std::weak_ptr<const filetype::SignatureDatabase> released = v1;
+
+  filetype::register_signatures(std::move(v1));
+  EXPECT_EQ(filetype::match(kAcme)->extension, "acme");
+
+  // The previous snapshot is released as soon as the update returns.
+  filetype::replace_signatures({v2, nullptr});
+  EXPECT_TRUE(released.expired());
+  EXPECT_EQ(filetype::match(kAcme)->extension, "acme2");
+
+  filetype::replace_signatures({});
+  EXPECT_EQ(filetype::match(kAcme), nullptr);
+  EXPECT_EQ(v2.use_count(), 1);
+}
+
+TEST(SnapshotTest, ReadersNeverSeeAPartialUpdate) {
+  // Each version carries a signature for ACME and one for a version tag;
+  // a reader must always get both from the same version.
+  std::vector<std::shared_ptr<const filetype::SignatureDatabase>> versions;
+  for (int v = 0; v < 4; ++v) {
+    const std::string ext = std::to_string(v);
+    versions.push_back(load("application/x-acme " + ext +
+                            " archive 0 41434D45\n"
+                            "application/x-tag " + ext +
+                            " archive 0 54414721\n"));
+  }
+  const std::vector<uint8_t> tag = {'T', 'A', 'G', '!', 0, 0, 0, 0};
+  const std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A,
+                                    '\n'};
+
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> failures{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&] {
+      while (!stop.load()) {
+        const filetype::ByteView inputs[] = {kAcme, tag, png};
+        const filetype::Type* results[3];
+        filetype::match_batch(inputs, 3, results);
+        const bool consistent =
+            results[2] == &filetype::image::TYPE_PNG &&
+            (results[0] == nullptr
+                 ? results[1] == nullptr
+                 : results[1] != nullptr &&
+                       results[0]->extension == results[1]->extension);
+        if (!consistent) {
+          failures.fetch_add(1);
+        }
+        filetype::match(kAcme);
+      }
+    });
+  }
+  for (int round = 0; round < 200; ++round) {
+    filetype::replace_signatures({versions[round % versions.size()]});
+    if (round % 10 == 0) {
+      filetype::clear_signatures();
+    }
+  }
+  stop.store(true);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  filetype::clear_signatures();
+  EXPECT_EQ(failures.load(), 0u);
+  for (const auto& version : versions) {
+    EXPECT_EQ(version.use_count(), 1);
+  }
+}
@@ -0,0 +1,148 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include "filetype/stream.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+
+namespace {
+
+filetype::StreamStatus feed_in_chunks(filetype::StreamDetector* detector,
+                                      const std::vector<uint8_t>& bytes,
+                                      size_t chunk) {
+  filetype::StreamStatus status = detector->status();
+  for (size_t pos = 0; pos < bytes.size() && status.need_more();
+       pos += chunk) {
+    status = detector->feed(filetype::ByteView(bytes).subview(pos, chunk));
+  }
+  return detector->finish();
+}
+
+std::vector<uint8_t> tar_header() {
+  std::vector<uint8_t> tar(512, 0x00);
+  const char name[] = "\xFF\xD8\xFF-notes.txt";
+  std::copy(name, name + sizeof(name) - 1, tar.begin());
+  const char ustar[] = "ustar";
+  std::copy(ustar, ustar + 5, tar.begin() + 257);
+  return tar;
+}
+
+}  // namespace
+
+TEST(StreamTest, DecidesAsSoonAsTheMagicIsComplete) {
+  filetype::StreamDetector detector;
+  EXPECT_TRUE(detector.status().need_more());
+  EXPECT_EQ(detector.status().need, 1u);
+
+  const std::vector<uint8_t> png = {0x89, 0x50, 0x4E, 0x47,
+                                    0x0D, 0x0A, 0x1A, 0x0A};
+  filetype::StreamStatus status =
+      detector.feed(filetype::ByteView(png).subview(0, 3));
+  ASSERT_TRUE(status.need_more());
+  EXPECT_EQ(status.need, 5u);
+
+  status = detector.feed(filetype::ByteView(png).subview(3));
+  ASSERT_TRUE(status.detected());
+  EXPECT_EQ(status.type, &filetype::image::TYPE_PNG);
+  EXPECT_TRUE(detector.result().is_image());
+  EXPECT_EQ(detector.consumed(), png.size());
+
+  // Later chunks are ignored once decided.
+  EXPECT_TRUE(detector.feed(png).detected());
+  EXPECT_EQ(detector.consumed(), png.size());
+}
+
+TEST(StreamTest, RejectsEarly) {
+  filetype::StreamDetector detector;
+  const std::vector<uint8_t> bytes = {0x89, 0x51};
+  // TAR stays possible until offset 257 is reached.
+  filetype::StreamStatus status = detector.feed(bytes);
+  ASSERT_TRUE(status.need_more());
+  EXPECT_EQ(status.need, 262u - bytes.size());
+
+  // Skip past the TAR magic with a chunk that does not contain "ustar".
+  status = detector.feed(std::vector<uint8_t>(300, 0x00));
+  EXPECT_TRUE(status.rejected());
+  EXPECT_FALSE(detector.result());
+}
+
+TEST(StreamTest, DeeperSignatureWinsOverProvisionalMatch) {
+  const std::vector<uint8_t> tar = tar_header();
+  filetype::StreamDetector detector;
+
+  // JPEG has matched, but TAR at offset 257 is more specific and undecided.
+  filetype::StreamStatus status =
+      detector.feed(filetype::ByteView(tar).subview(0, 16));
+  ASSERT_TRUE(status.need_more());
+  EXPECT_EQ(status.type, &filetype::image::TYPE_JPEG);
+  EXPECT_EQ(status.need, 262u - 16u);
+
+  status = detector.feed(filetype::ByteView(tar).subview(16));
+  ASSERT_TRUE(status.detected());
+  EXPECT_EQ(status.type, &filetype::archive::TYPE_TAR);
+  EXPECT_EQ(detector.result().offset, 257u);
+}
+
+TEST(StreamTest, FinishSettlesShortStreams) {
+  filetype::StreamDetector detector;
+  EXPECT_TRUE(detector.finish().rejected());
+
+  detector.reset();
+  const std::vector<uint8_t> jpeg = {0xFF, 0xD8, 0xFF, 0xE0};
+  EXPECT_TRUE(detector.feed(jpeg).need_more());
+  const filetype::StreamStatus status = detector.finish();
+  ASSERT_TRUE(status.detected());
+  EXPECT_EQ(status.type, &filetype::image::TYPE_JPEG);
+}
+
+TEST(StreamTest, CategoryFilter) {
+  filetype::StreamDetector detector(
+      filetype::to_mask(filetype::Category::AUDIO));
+  const std::vector<uint8_t> png = {0x89, 0x50, 0x4E, 0x47,
+                                    0x0D, 0x0A, 0x1A, 0x0A};
+  // No audio signature starts with 0x89, so the first byte settles it.
+  EXPECT_TRUE(detector.feed(filetype::ByteView(png).subview(0, 1)).rejected());
+}
+
+TEST(StreamTest, AgreesWithMatchForAnyChunking) {
+  std::vector<std::vector<uint8_t>> inputs = {
+      {0x49, 0x49, 0x2A, 0x00, 0x10, 0x00, 0x00, 0x00},
+      {0x49, 0x49, 0x2A, 0x00, 0x08, 0x00, 0x00, 0x00},
+      {0x52, 0x49, 0x46, 0x46, 0x24, 0x08, 0x00, 0x00,
+       0x57, 0x41, 0x56, 0x45, 0x66, 0x6D, 0x74, 0x20},
+      {0x00, 0x00, 0x00, 0x20, 0x66, 0x74, 0x79, 0x70,
+       0x4D, 0x34, 0x41, 0x20, 0x00, 0x00, 0x00, 0x00},
+      {0xFF, 0xFB, 0x90},
+      tar_header(),
+  };
+  // Random tails behind first bytes shared by many signatures.
+  std::mt19937 rng(42);
+  const uint8_t firsts[] = {0x00, 0x1F, 0x42, 0x49, 0x52, 0xFF};
+  for (int i = 0; i < 200; ++i) {
+    std::vector<uint8_t> bytes(rng() % 300);
+    for (uint8_t& b : bytes) {
+      b = static_cast<uint8_t>(rng() % 4 == 0 ? rng() : rng() % 4);
+    }
+    if (!bytes.empty()) {
+      bytes[0] = firsts[i % std::size(firsts)];
+    }
+    inputs.push_back(bytes);
+  }
+
+  for (const auto& bytes : inputs) {
+    for (size_t chunk : {1, 3, 7, 64, 1024}) {
+      filetype::StreamDetector detector;
+      const filetype::StreamStatus status =
+          feed_in_chunks(&detector, bytes, chunk);
+      EXPECT_FALSE(status.need_more());
+      EXPECT_EQ(status.type, filetype::match(bytes)) << "chunk " << chunk;
+      EXPECT_EQ(detector.result().type, filetype::match(bytes));
+    }
+  }
+}
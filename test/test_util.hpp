@@ -0,0 +1,66 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#ifndef TEST_TEST_UTIL_HPP_
+#define TEST_TEST_UTIL_HPP_
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace filetype {
+namespace test {
+
+/// The smallest PNG header match() recognises.
+inline const std::vector<uint8_t> kPng = {0x89, 'P', 'N', 'G', '\r', '\n',
+                                          0x1A, '\n', 0,   0,   0,   0};
+
+/// The smallest PDF header match() recognises.
+inline const std::vector<uint8_t> kPdf = {'%', 'P', 'D', 'F',
+                                          '-', '1', '.', '7'};
+
+/// A path under the test temporary directory, unique to the running suite.
+inline std::string temp_path(const std::string& name) {
+  const ::testing::TestInfo* info =
+      ::testing::UnitTest::GetInstance()->current_test_info();
+  return ::testing::TempDir() + "filetype_" + info->test_suite_name() + "_" +
+         name;
+}
+
+/**
+ * @brief Replace the contents of @p path with @p bytes.
+ *
+ * Use as `ASSERT_TRUE(write_file(path, bytes))`, so that a file which could
+ * not be created or fully written stops the test.
+ */
+inline ::testing::AssertionResult write_file(
+    const std::string& path, const std::vector<uint8_t>& bytes) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    return ::testing::AssertionFailure() << "cannot create " << path;
+  }
+  const size_t written =
+      bytes.empty() ? 0 : std::fwrite(bytes.data(), 1, bytes.size(), file);
+  const bool closed = std::fclose(file) == 0;
+  if (written != bytes.size() || !closed) {
+    return ::testing::AssertionFailure() << "cannot write " << path;
+  }
+  return ::testing::AssertionSuccess();
+}
+
+/// A disk image recognised only by its trailer, @p padding bytes in.
+inline std::vector<uint8_t> dmg(size_t padding) {
+  std::vector<uint8_t> image(padding, 'x');
+  std::vector<uint8_t> koly(512, 0);
+  std::memcpy(koly.data(), "koly\0\0\0\x04\0\0\x02\0", 12);
+  image.insert(image.end(), koly.begin(), koly.end());
+  return image;
+}
+
+}  // namespace test
+}  // namespace filetype
+
+#endif  // TEST_TEST_UTIL_HPP_
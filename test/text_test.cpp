@@ -0,0 +1,138 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+
+namespace {
+
+// NOLINTNEXTLINE(build/namespaces)
+using namespace std::string_view_literals;
+
+filetype::Charset charset(std::string_view bytes,
+                          size_t budget = filetype::TEXT_PROBE_SIZE) {
+  return filetype::detect_text(filetype::ByteView(bytes), budget).charset;
+}
+
+/// @p count copies of @p piece.
+std::string repeat(std::string_view piece, size_t count) {
+  std::string out;
+  for (size_t i = 0; i < count; ++i) {
+    out += piece;
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(TextTest, ByteOrderMarks) {
+  EXPECT_EQ(charset("\xEF\xBB\xBFhello"sv), filetype::Charset::UTF8);
+  EXPECT_EQ(charset("\xFF\xFEh\0i\0"sv), filetype::Charset::UTF16LE);
+  EXPECT_EQ(charset("\xFE\xFF\0h\0i"sv), filetype::Charset::UTF16BE);
+  EXPECT_EQ(charset("\xFF\xFE\0\0h\0\0\0"sv), filetype::Charset::UTF32LE);
+  EXPECT_EQ(charset("\0\0\xFE\xFF\0\0\0h"sv), filetype::Charset::UTF32BE);
+
+  const filetype::TextResult result =
+      filetype::detect_text(filetype::ByteView("\xFF\xFEh\0"sv));
+  EXPECT_EQ(result.bom_length, 2u);
+  EXPECT_EQ(result.content_type(), "text/plain; charset=utf-16le");
+  EXPECT_EQ(result.type(), &filetype::document::TYPE_TXT);
+
+  // A UTF-8 mark does not excuse invalid UTF-8.
+  EXPECT_EQ(charset("\xEF\xBB\xBFok\xC0\xAF"sv), filetype::Charset::BINARY);
+
+  // Nor do the others excuse a body of partial code units, unpaired
+  // surrogates or code points past U+10FFFF.
+  EXPECT_EQ(charset("\xFF\xFEh\0i"sv), filetype::Charset::BINARY);
+  EXPECT_EQ(charset("\xFF\xFE\x3D\xD8\x00\xDE"sv), filetype::Charset::UTF16LE);
+  EXPECT_EQ(charset("\xFF\xFE\x3D\xD8h\0"sv), filetype::Charset::BINARY);
+  EXPECT_EQ(charset("\xFF\xFEh\0\x3D\xD8"sv), filetype::Charset::BINARY);
+  EXPECT_EQ(charset("\xFE\xFF\xDE\x00\0h"sv), filetype::Charset::BINARY);
+  EXPECT_EQ(charset("\0\0\xFE\xFF\0\x11\0\0"sv), filetype::Charset::BINARY);
+  EXPECT_EQ(charset("\0\0\xFE\xFF\0\0\xD8\0"sv), filetype::Charset::BINARY);
+  EXPECT_EQ(charset("\xFF\xFE\0\0h\0\0"sv), filetype::Charset::BINARY);
+  // FF FE 00 00 that is not UTF-32LE can still be UTF-16LE starting with NUL.
+  EXPECT_EQ(charset("\xFF\xFE\0\0h\0"sv), filetype::Charset::UTF16LE);
+  // The window may split a unit or a pair, but not the whole buffer.
+  EXPECT_EQ(charset("\xFF\xFEh\0i\0"sv, 5), filetype::Charset::UTF16LE);
+  EXPECT_EQ(charset("\xFF\xFEh\0\x3D\xD8\x00\xDE"sv, 6),
+            filetype::Charset::UTF16LE);
+}
+
+TEST(TextTest, AsciiAndUtf8) {
+  EXPECT_EQ(charset("#!/bin/sh\necho hi\r\n\tdone\f\x1b[0m\n"),
+            filetype::Charset::ASCII);
+  EXPECT_EQ(charset("Gr\xC3\xBC\xC3\x9F""e \xE2\x82\xAC 5 \xF0\x9F\x98\x80"),
+            filetype::Charset::UTF8);
+  // Long inputs exercise the vector loop, with sequences on block edges.
+  for (size_t shift = 0; shift < 4; ++shift) {
+    const std::string text =
+        std::string(shift, ' ') + repeat("na\xC3\xAFve \xE2\x82\xAC ", 500);
+    EXPECT_EQ(charset(text, SIZE_MAX), filetype::Charset::UTF8) << shift;
+  }
+
+  const filetype::TextResult result =
+      filetype::detect_text(filetype::ByteView("plain"sv));
+  EXPECT_TRUE(result);
+  EXPECT_EQ(result.content_type(), "text/plain; charset=us-ascii");
+}
+
+TEST(TextTest, InvalidUtf8IsBinary) {
+  static constexpr std::string_view kInvalid[] = {
+      "\x80"sv,                  // stray continuation
+      "\xC0\xAF"sv,              // overlong
+      "\xE0\x80\xAF"sv,          // overlong
+      "\xED\xA0\x80"sv,          // surrogate
+      "\xF4\x90\x80\x80"sv,      // above U+10FFFF
+      "\xF8\x88\x80\x80\x80"sv,  // five-byte form
+      "\xC3x"sv,                 // too short
+  };
+  for (std::string_view bad : kInvalid) {
+    for (size_t at : {0, 5, 31, 62, 300}) {
+      std::string text = repeat("text ", 100);
+      text.replace(at, bad.size(), bad);
+      EXPECT_EQ(charset(text), filetype::Charset::BINARY)
+          << at << " " << testing::PrintToString(bad);
+    }
+  }
+}
+
+TEST(TextTest, CutOffSequenceIsText) {
+  // The probe window ends inside a three-byte sequence.
+  const std::string text = repeat("abc\xE2\x82\xAC", 10);
+  EXPECT_EQ(charset(text, 5), filetype::Charset::UTF8);
+  EXPECT_EQ(charset(text.substr(0, 38)), filetype::Charset::UTF8);
+  EXPECT_EQ(charset(text, 3), filetype::Charset::ASCII);
+}
+
+TEST(TextTest, ControlBytes) {
+  EXPECT_EQ(charset("text\0more"sv), filetype::Charset::BINARY);
+
+  // One control byte in 32 is tolerated, more is not.
+  std::string text = repeat("x", 64);
+  text[10] = '\x01';
+  text[40] = '\x7F';
+  EXPECT_EQ(charset(text), filetype::Charset::ASCII);
+  text[20] = '\x02';
+  EXPECT_EQ(charset(text), filetype::Charset::BINARY);
+}
+
+TEST(TextTest, BinaryData) {
+  std::vector<uint8_t> noise(4096);
+  uint32_t state = 1;
+  for (uint8_t& b : noise) {
+    state = state * 1103515245u + 12345u;
+    b = static_cast<uint8_t>(state >> 16);
+  }
+  const filetype::TextResult result = filetype::detect_text(noise);
+  EXPECT_FALSE(result);
+  EXPECT_EQ(result.type(), nullptr);
+  EXPECT_EQ(result.content_type(), "application/octet-stream");
+  EXPECT_EQ(filetype::detect_text(filetype::ByteView()).charset,
+            filetype::Charset::BINARY);
+  EXPECT_EQ(filetype::charset_name(filetype::Charset::UTF16BE), "utf-16be");
+}
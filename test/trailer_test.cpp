@@ -0,0 +1,155 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+/// @p size bytes no head signature matches.
+std::vector<uint8_t> body(size_t size) {
+  std::vector<uint8_t> out(size);
+  for (size_t i = 0; i < size; ++i) {
+    out[i] = static_cast<uint8_t>('a' + i % 26);
+  }
+  return out;
+}
+
+void append(std::vector<uint8_t>* out, std::string_view bytes) {
+  out->insert(out->end(), bytes.begin(), bytes.end());
+}
+
+/// The last 128 bytes of an MP3 file: an ID3v1 tag.
+std::vector<uint8_t> with_id3v1(std::vector<uint8_t> audio) {
+  std::vector<uint8_t> tag(128, 0);
+  std::memcpy(tag.data(), "TAGSong", 7);
+  audio.insert(audio.end(), tag.begin(), tag.end());
+  return audio;
+}
+
+/// The last 512 bytes of an Apple disk image: a koly trailer.
+std::vector<uint8_t> with_koly(std::vector<uint8_t> image) {
+  std::vector<uint8_t> koly(512, 0);
+  std::memcpy(koly.data(), "koly\0\0\0\x04\0\0\x02\0", 12);
+  image.insert(image.end(), koly.begin(), koly.end());
+  return image;
+}
+
+filetype::DetectionResult detect_whole(const std::vector<uint8_t>& bytes) {
+  return filetype::detect(bytes, bytes, bytes.size());
+}
+
+}  // namespace
+
+TEST(TrailerTest, Id3v1) {
+  const auto mp3 = with_id3v1(body(5000));
+  EXPECT_EQ(filetype::match(mp3), nullptr);
+  const filetype::DetectionResult result = detect_whole(mp3);
+  EXPECT_EQ(result.type, &filetype::audio::TYPE_MP3);
+  EXPECT_EQ(result.offset, 5000u);
+  EXPECT_EQ(result.length, 3u);
+
+  // The tag only counts exactly 128 bytes from the end.
+  auto shifted = mp3;
+  shifted.push_back(0);
+  EXPECT_FALSE(detect_whole(shifted));
+}
+
+TEST(TrailerTest, PdfEnd) {
+  // Junk before the header hides it from match().
+  auto pdf = body(100);
+  append(&pdf, "%PDF-1.4\n1 0 obj\n<<>>\nendobj\ntrailer\n<<>>\n");
+  append(&pdf, "startxref\n9\n%%EOF\r\n");
+  EXPECT_EQ(filetype::match(pdf), nullptr);
+  const filetype::DetectionResult result = detect_whole(pdf);
+  EXPECT_EQ(result.type, &filetype::document::TYPE_PDF);
+  EXPECT_EQ(result.offset, pdf.size() - 7);
+
+  // %%EOF must close the file and follow startxref.
+  auto appended = pdf;
+  append(&appended, "junk");
+  EXPECT_FALSE(detect_whole(appended));
+  auto bare = body(100);
+  append(&bare, "%%EOF\n");
+  EXPECT_FALSE(detect_whole(bare));
+}
+
+TEST(TrailerTest, DiskImage) {
+  const auto dmg = with_koly(body(70000));
+  EXPECT_EQ(filetype::match(dmg), nullptr);
+  const filetype::DetectionResult result = detect_whole(dmg);
+  EXPECT_EQ(result.type, &filetype::archive::TYPE_DMG);
+  EXPECT_EQ(result.offset, 70000u);
+  EXPECT_TRUE(result.is_archive());
+  EXPECT_EQ(filetype::type_from_id(filetype::TypeId::DMG),
+            &filetype::archive::TYPE_DMG);
+
+  // A trailer of another version or size is not a koly block.
+  auto other = dmg;
+  other[70000 + 7] = 3;
+  EXPECT_FALSE(detect_whole(other));
+}
+
+TEST(TrailerTest, HeadSignaturesComeFirst) {
+  // A PNG that happens to end like an MP3 is still a PNG.
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  png = with_id3v1(png);
+  EXPECT_EQ(detect_whole(png).type, &filetype::image::TYPE_PNG);
+}
+
+TEST(TrailerTest, HeadAndTailApart) {
+  // Only the first and last bytes of a large file are at hand.
+  const auto dmg = with_koly(body(1 << 20));
+  const filetype::ByteView all(dmg);
+  const filetype::ByteView head = all.subview(0, 512);
+  const filetype::ByteView tail =
+      all.subview(dmg.size() - filetype::TAIL_PROBE_SIZE);
+  EXPECT_EQ(filetype::match(head, tail, dmg.size()),
+            &filetype::archive::TYPE_DMG);
+  // A tail longer than a trailer needs is fine; a shorter one misses it.
+  EXPECT_EQ(filetype::match(head, all.subview(dmg.size() - 100), dmg.size()),
+            nullptr);
+  // No tail at all behaves like match().
+  EXPECT_EQ(filetype::match(head, filetype::ByteView(), dmg.size()),
+            nullptr);
+}
+
+TEST(TrailerTest, CategoryFilter) {
+  const auto mp3 = with_id3v1(body(1000));
+  const auto audio = filetype::to_mask(filetype::Category::AUDIO);
+  const auto images = filetype::to_mask(filetype::Category::IMAGE);
+  EXPECT_EQ(filetype::match(mp3, mp3, mp3.size(), audio),
+            &filetype::audio::TYPE_MP3);
+  EXPECT_EQ(filetype::match(mp3, mp3, mp3.size(), images), nullptr);
+}
+
+TEST(TrailerTest, MatchFileReadsTheTail) {
+  const std::string path = temp_path("tail.dmg");
+  for (size_t size : {100u, 300u, 100000u}) {
+    const auto dmg = with_koly(body(size));
+    ASSERT_TRUE(write_file(path, dmg));
+
+    std::error_code ec;
+    const filetype::DetectionResult result = filetype::detect_file(path, ec);
+    EXPECT_FALSE(ec);
+    EXPECT_EQ(result.type, &filetype::archive::TYPE_DMG) << size;
+    EXPECT_EQ(result.offset, size);
+  }
+
+  // A file shorter than the head read needs no second read.
+  const auto mp3 = with_id3v1(body(50));
+  ASSERT_TRUE(write_file(path, mp3));
+  std::error_code ec;
+  EXPECT_EQ(filetype::match_file(path, ec), &filetype::audio::TYPE_MP3);
+  std::remove(path.c_str());
+}
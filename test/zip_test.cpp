@@ -0,0 +1,287 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "filetype/filetype.hpp"
+#include "test_util.hpp"
+
+namespace {
+
+using filetype::test::temp_path;
+using filetype::test::write_file;
+
+/// Minimal ZIP writer: stored entries, central directory and end record.
+class ZipBuilder {
+ public:
+  /// @param stub Bytes before the archive, as in a self-extracting one.
+  explicit ZipBuilder(std::vector<uint8_t> stub = {})
+      : out_(std::move(stub)) {}
+
+  /// Add an entry. With @p descriptor set, the local header carries no sizes
+  /// (general purpose flag bit 3), as streaming writers produce.
+  ZipBuilder& add(std::string_view name, std::string_view data,
+                  bool descriptor = false) {
+    const uint32_t offset = static_cast<uint32_t>(out_.size());
+    const uint32_t size = static_cast<uint32_t>(data.size());
+    put32(0x04034B50);
+    put16(20);
+    put16(descriptor ? 0x0008 : 0);
+    put16(0);  // stored
+    put32(0);  // time, date
+    put32(0);  // crc
+    put32(descriptor ? 0 : size);
+    put32(descriptor ? 0 : size);
+    put16(static_cast<uint16_t>(name.size()));
+    put16(0);
+    out_.insert(out_.end(), name.begin(), name.end());
+    out_.insert(out_.end(), data.begin(), data.end());
+    if (descriptor) {
+      put32(0x08074B50);
+      put32(0);
+      put32(size);
+      put32(size);
+    }
+    entries_.push_back(Entry{std::string(name), offset, size});
+    return *this;
+  }
+
+  std::vector<uint8_t> build() {
+    std::vector<uint8_t> zip = out_;
+    std::swap(zip, out_);
+    const uint32_t directory = static_cast<uint32_t>(out_.size());
+    for (const Entry& entry : entries_) {
+      put32(0x02014B50);
+      put16(20);
+      put16(20);
+      put16(0);
+      put16(0);
+      put32(0);
+      put32(0);
+      put32(entry.size);
+      put32(entry.size);
+      put16(static_cast<uint16_t>(entry.name.size()));
+      put16(0);
+      put16(0);
+      put16(0);
+      put16(0);
+      put32(0);
+      put32(entry.offset);
+      out_.insert(out_.end(), entry.name.begin(), entry.name.end());
+    }
+    const uint32_t directory_size =
+        static_cast<uint32_t>(out_.size()) - directory;
+    put32(0x06054B50);
+    put32(0);
+    put16(static_cast<uint16_t>(entries_.size()));
+    put16(static_cast<uint16_t>(entries_.size()));
+    put32(directory_size);
+    put32(directory);
+    put16(0);
+    std::swap(zip, out_);
+    return zip;
+  }
+
+ private:
+  struct Entry {
+    std::string name;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  void put16(uint16_t v) {
+    out_.push_back(static_cast<uint8_t>(v));
+    out_.push_back(static_cast<uint8_t>(v >> 8));
+  }
+
+  void put32(uint32_t v) {
+    put16(static_cast<uint16_t>(v));
+    put16(static_cast<uint16_t>(v >> 16));
+  }
+
+  std::vector<uint8_t> out_;
+  std::vector<Entry> entries_;
+};
+
+std::vector<uint8_t> ooxml(std::string_view part, bool descriptor = false) {
+  return ZipBuilder()
+      .add("[Content_Types].xml", "<Types/>", descriptor)
+      .add("_rels/.rels", "<Relationships/>", descriptor)
+      .add(part, "<document/>", descriptor)
+      .build();
+}
+
+std::vector<uint8_t> with_mimetype(std::string_view mime) {
+  return ZipBuilder()
+      .add("mimetype", mime)
+      .add("content.xml", "<office:document/>")
+      .build();
+}
+
+}  // namespace
+
+TEST(ZipTest, OfficeOpenXml) {
+  EXPECT_EQ(filetype::match(ooxml("word/document.xml")),
+            &filetype::document::TYPE_DOCX);
+  EXPECT_EQ(filetype::match(ooxml("xl/workbook.xml")),
+            &filetype::document::TYPE_XLSX);
+  EXPECT_EQ(filetype::match(ooxml("ppt/presentation.xml")),
+            &filetype::document::TYPE_PPTX);
+  EXPECT_TRUE(filetype::is_document(ooxml("word/document.xml")));
+}
+
+TEST(ZipTest, MimetypeEntry) {
+  EXPECT_EQ(filetype::match(with_mimetype(filetype::document::TYPE_ODT.mime)),
+            &filetype::document::TYPE_ODT);
+  EXPECT_EQ(filetype::match(with_mimetype(filetype::document::TYPE_ODS.mime)),
+            &filetype::document::TYPE_ODS);
+  EXPECT_EQ(filetype::match(with_mimetype(filetype::document::TYPE_ODP.mime)),
+            &filetype::document::TYPE_ODP);
+  EXPECT_EQ(filetype::match(with_mimetype(filetype::document::TYPE_EPUB.mime)),
+            &filetype::document::TYPE_EPUB);
+  EXPECT_EQ(filetype::match(with_mimetype("application/x-unknown")),
+            &filetype::archive::TYPE_ZIP);
+}
+
+TEST(ZipTest, JavaAndAndroidPackages) {
+  const auto jar = ZipBuilder()
+                       .add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0")
+                       .add("com/example/Main.class", "\xCA\xFE\xBA\xBE")
+                       .build();
+  EXPECT_EQ(filetype::match(jar), &filetype::archive::TYPE_JAR);
+
+  // APKs carry a JAR manifest too; the Android entries win.
+  const auto apk = ZipBuilder()
+                       .add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0")
+                       .add("AndroidManifest.xml", "\x03\x00\x08\x00")
+                       .add("classes.dex", "dex\n035")
+                       .build();
+  EXPECT_EQ(filetype::match(apk), &filetype::archive::TYPE_APK);
+}
+
+TEST(ZipTest, PlainArchive) {
+  const auto zip =
+      ZipBuilder().add("readme.txt", "hello").add("src/main.c", "{}").build();
+  EXPECT_EQ(filetype::match(zip), &filetype::archive::TYPE_ZIP);
+}
+
+TEST(ZipTest, CentralDirectoryFallback) {
+  // Local headers without sizes cannot be walked past the first entry.
+  const auto docx = ooxml("word/document.xml", true);
+  EXPECT_EQ(filetype::match(docx), &filetype::document::TYPE_DOCX);
+
+  // With only a prefix of the archive the end record is out of reach.
+  const filetype::ByteView prefix = filetype::ByteView(docx).subview(0, 64);
+  EXPECT_EQ(filetype::match(prefix), &filetype::archive::TYPE_ZIP);
+}
+
+TEST(ZipTest, CategoryFilter) {
+  const auto docx = ooxml("word/document.xml");
+  const auto zip = ZipBuilder().add("readme.txt", "hello").build();
+  EXPECT_EQ(filetype::matcher::match_document(docx),
+            &filetype::document::TYPE_DOCX);
+  EXPECT_EQ(filetype::matcher::match_archive(docx), nullptr);
+  EXPECT_EQ(filetype::matcher::match_document(zip), nullptr);
+  EXPECT_EQ(filetype::matcher::match_archive(zip),
+            &filetype::archive::TYPE_ZIP);
+}
+
+TEST(ZipTest, MatchFileReadsDirectory) {
+  // A large first entry without sizes pushes every hint out of the prefix.
+  const auto xlsx = ZipBuilder()
+                        .add("[Content_Types].xml", std::string(20000, ' '),
+                             true)
+                        .add("xl/workbook.xml", "<workbook/>", true)
+                        .build();
+  const std::string path = temp_path("directory.xlsx");
+  ASSERT_TRUE(write_file(path, xlsx));
+
+  std::error_code ec;
+  EXPECT_EQ(filetype::match_file(path, ec), &filetype::document::TYPE_XLSX);
+  EXPECT_FALSE(ec);
+  std::remove(path.c_str());
+}
+
+TEST(ZipTest, SelfExtractingArchive) {
+  // An executable stub hides the local headers; the end record at the tail
+  // still leads to the central directory.
+  std::vector<uint8_t> stub(10000, 0x90);
+  stub[0] = 'M';
+  stub[1] = 'Z';
+  const auto jar =
+      ZipBuilder(stub)
+          .add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n")
+          .add("Main.class", "\xCA\xFE\xBA\xBE")
+          .build();
+  EXPECT_EQ(filetype::match(jar), nullptr);
+  const filetype::ByteView head = filetype::ByteView(jar).subview(0, 512);
+  const filetype::ByteView tail =
+      filetype::ByteView(jar).subview(jar.size() - filetype::TAIL_PROBE_SIZE);
+  const filetype::DetectionResult result =
+      filetype::detect(head, tail, jar.size());
+  EXPECT_EQ(result.type, &filetype::archive::TYPE_JAR);
+  EXPECT_EQ(result.offset, jar.size() - 22);
+  EXPECT_EQ(result.length, 4u);
+
+  const std::string path = temp_path("sfx.exe");
+  ASSERT_TRUE(write_file(path, jar));
+  std::error_code ec;
+  EXPECT_EQ(filetype::match_file(path, ec), &filetype::archive::TYPE_JAR);
+  EXPECT_FALSE(ec);
+  std::remove(path.c_str());
+
+  // Prepended without adjusting the offsets, as by cat stub archive.zip,
+  // the directory is found from the end record instead.
+  const auto archive =
+      ZipBuilder()
+          .add("META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n")
+          .add("Main.class", "\xCA\xFE\xBA\xBE")
+          .build();
+  std::vector<uint8_t> unadjusted = stub;
+  unadjusted.insert(unadjusted.end(), archive.begin(), archive.end());
+  EXPECT_EQ(filetype::detect(filetype::ByteView(unadjusted).subview(0, 512),
+                             filetype::ByteView(unadjusted).subview(
+                                 unadjusted.size() - filetype::TAIL_PROBE_SIZE),
+                             unadjusted.size())
+                .type,
+            &filetype::archive::TYPE_JAR);
+
+  // An empty archive is nothing but an end record.
+  const auto empty = ZipBuilder().build();
+  EXPECT_EQ(filetype::match(empty), nullptr);
+  EXPECT_EQ(filetype::match(empty, empty, empty.size()),
+            &filetype::archive::TYPE_ZIP);
+}
+
+TEST(ZipTest, Stream) {
+  const auto epub = with_mimetype(filetype::document::TYPE_EPUB.mime);
+  filetype::StreamDetector detector;
+  filetype::StreamStatus status = detector.feed(epub);
+  // The whole archive is shorter than the refine window.
+  ASSERT_TRUE(status.need_more());
+  EXPECT_EQ(status.type, &filetype::archive::TYPE_ZIP);
+  status = detector.finish();
+  ASSERT_TRUE(status.detected());
+  EXPECT_EQ(status.type, &filetype::document::TYPE_EPUB);
+
+  // Longer streams are decided once the window is full.
+  const auto docx = ZipBuilder()
+                        .add("[Content_Types].xml", "<Types/>")
+                        .add("word/document.xml", std::string(8000, 'x'))
+                        .build();
+  detector.reset();
+  status = detector.status();
+  for (size_t pos = 0; pos < docx.size() && status.need_more(); pos += 100) {
+    status = detector.feed(filetype::ByteView(docx).subview(pos, 100));
+  }
+  status = detector.finish();
+  ASSERT_TRUE(status.detected());
+  EXPECT_EQ(status.type, &filetype::document::TYPE_DOCX);
+  EXPECT_LT(detector.consumed(), docx.size());
+}
@@ -0,0 +1,44 @@
+// Copyright 2025 Prince Roshan <princekrroshan01@gmail.com>
+
+// Compile a signature description into an image for
+// filetype::SignatureDatabase::open().
+//
+// Usage: filetype_sigc <description> <image>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "filetype/signature_db.hpp"
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cerr << "usage: " << argv[0] << " <description> <image>\n";
+    return 2;
+  }
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in) {
+    std::cerr << argv[1] << ": cannot open\n";
+    return 1;
+  }
+  const std::string source((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+
+  std::vector<uint8_t> image;
+  std::string error;
+  if (!filetype::compile_signatures(source, &image, &error)) {
+    std::cerr << argv[1] << ": " << error << "\n";
+    return 1;
+  }
+  std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(image.data()),
+            static_cast<std::streamsize>(image.size()));
+  if (!out.flush()) {
+    std::cerr << argv[2] << ": cannot write\n";
+    return 1;
+  }
+  return 0;
+}